@@ -6,6 +6,7 @@
 
 namespace xbox { namespace services { 
     class xbox_live_context_impl;
+    template<typename T> class lazy_json_vector;
 
     /// <summary>
     /// Contains classes and enumerations that let you retrieve
@@ -596,6 +597,11 @@ public:
     /// </summary>
     static xbox::services::xbox_live_result<achievements_result> _Deserialize(_In_ const web::json::value& json);
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    static xbox::services::xbox_live_result<achievements_result> _Deserialize_lazy(_In_ std::shared_ptr<const web::json::value> json);
+
 private:
     std::shared_ptr<xbox::services::user_context> m_userContext;
     std::shared_ptr<xbox::services::xbox_live_context_settings> m_xboxLiveContextSettings;
@@ -608,6 +614,7 @@ private:
     bool m_unlockedOnly;
     achievement_order_by m_orderBy;
     std::vector<achievement> m_items;
+    std::shared_ptr<xbox::services::lazy_json_vector<achievement>> m_lazyItems;
     string_t m_continuationToken;
 };
 
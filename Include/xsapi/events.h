@@ -11,6 +11,9 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
     /// </summary>
     namespace events {
 
+class in_game_event_batch;
+struct in_game_event_batch_stats;
+
     /// <summary>
 /// Represents a service class that provides APIs that you can use to write in-game events.
 /// </summary>
@@ -63,9 +66,66 @@ public:
         _In_ const web::json::value& measurement
         );
 
+    /// <summary>
+    /// Queue a simple in-game event without providing any data fields.
+    /// </summary>
+    /// <param name="eventName">Event name</param>
+    /// <remarks>
+    /// Queued events are buffered and written together once enough have been queued or a few seconds
+    /// have passed, whichever comes first. Call flush_in_game_events to write them immediately.
+    /// Events queued while the buffer is full are dropped and an error is returned.
+    /// </remarks>
+    _XSAPIIMP xbox_live_result<void> queue_in_game_event(_In_ const string_t& eventName);
+
+    /// <summary>
+    /// Queue an in-game event that includes "dimensions" and "measurement" data fields.
+    /// This is the buffered version of write_in_game_event, for titles that write events every frame.
+    /// </summary>
+    /// <param name="eventName">Event name</param>
+    /// <param name="dimensions">Dimensions data fields</param>
+    /// <param name="measurements">Measurement data fields</param>
+    /// <remarks>
+    /// Queued events are buffered and written together once enough have been queued or a few seconds
+    /// have passed, whichever comes first. Call flush_in_game_events to write them immediately.
+    /// Events queued while the buffer is full are dropped and an error is returned.
+    /// </remarks>
+    _XSAPIIMP xbox_live_result<void> queue_in_game_event(
+        _In_ const string_t& eventName,
+        _In_ const web::json::value& dimensions,
+        _In_ const web::json::value& measurements
+        );
+
+    /// <summary>
+    /// Writes every queued in-game event on the calling thread.
+    /// </summary>
+    /// <remarks>
+    /// Returns the error from the last event that failed to write, if any. Failed events are not retried.
+    /// </remarks>
+    _XSAPIIMP xbox_live_result<void> flush_in_game_events();
+
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    in_game_event_batch_stats _Batch_stats() const;
+
 private:
+    // The parts of an event that are the same for every event this service writes, built once per flush
+    struct common_event_fields;
+
+    xbox_live_result<void> create_common_event_fields(_Inout_ common_event_fields& commonFields);
+
+    xbox_live_result<void> write_in_game_event(
+        _In_ const common_event_fields& commonFields,
+        _In_ const string_t& eventName,
+        _In_ const web::json::value& dimensions,
+        _In_ const web::json::value& measurements
+        );
+
+    void schedule_flush(_In_ bool flushNow);
+
     std::shared_ptr<XBOX_LIVE_NAMESPACE::user_context> m_userContext;
     std::shared_ptr<XBOX_LIVE_NAMESPACE::xbox_live_app_config> m_appConfig;
+    std::shared_ptr<in_game_event_batch> m_eventBatch;
 
     string_t m_playSession;
 #if UWP_API
@@ -77,6 +137,7 @@ private:
         );
 
     Windows::Foundation::Diagnostics::LoggingFields^ create_logging_field(
+        _In_ const common_event_fields& commonFields,
         _In_ const string_t& eventName,
         _In_ const web::json::value& properties,
         _In_ const web::json::value& measurement
@@ -84,7 +145,10 @@ private:
 
     string_t load_app_insights_key();
 
-    void add_common_logging_field(_In_ Windows::Foundation::Diagnostics::LoggingFields^ fields);
+    void add_common_logging_field(
+        _In_ Windows::Foundation::Diagnostics::LoggingFields^ fields,
+        _In_ const common_event_fields& commonFields
+        );
     Windows::Foundation::Diagnostics::LoggingOptions^ m_loggingOptions;
     Windows::Foundation::Diagnostics::LoggingChannel^ m_loggingChannel;
 #endif
@@ -148,6 +148,21 @@ public:
     /// </summary>
     void _Set_response_body(_In_ const web::json::value& responseBodyJson);
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    void _Set_response_body(_In_ string_t&& responseBodyString);
+
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    void _Set_response_body(_In_ std::vector<unsigned char>&& responseBodyVector);
+
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    void _Set_response_body(_In_ web::json::value&& responseBodyJson);
+
     /// <summary>
     /// Internal function
     /// </summary>
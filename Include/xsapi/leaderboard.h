@@ -19,6 +19,7 @@
 
 namespace xbox { namespace services {
     class xbox_live_context_impl;
+    template<typename T> class lazy_json_vector;
     namespace stats {
         namespace manager {
             class stats_manager_impl;
@@ -354,12 +355,18 @@ public:
     /// </summary>
     void _Parse_additional_columns(const std::vector<string_t>& additionalColumnNames);
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    void _Set_lazy_rows(_In_ std::shared_ptr<xbox::services::lazy_json_vector<leaderboard_row>> lazyRows);
+
 private:
     string_t m_displayName;
     uint32_t m_totalRowCount;
     string_t m_continuationToken;
     std::vector<leaderboard_column> m_columns;
     std::vector<leaderboard_row> m_rows;
+    std::shared_ptr<xbox::services::lazy_json_vector<leaderboard_row>> m_lazyRows;
 
     std::shared_ptr<xbox::services::user_context> m_userContext;
     std::shared_ptr<xbox::services::xbox_live_context_settings> m_xboxLiveContextSettings;
@@ -2518,6 +2518,16 @@ public:
     /// </summary>
     static xbox_live_result<multiplayer_session_member> _Deserialize(_In_ const web::json::value& json);
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    uint64_t _Xbox_user_id_number() const;
+
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    uint64_t _Member_custom_properties_hash() const;
+
 private:
     std::error_code convert_measure_json_to_vector();
 
@@ -2528,8 +2538,10 @@ private:
     uint32_t m_memberId;
     web::json::value m_customConstantsJson;
     web::json::value m_customPropertiesJson;
+    uint64_t m_customPropertiesHash;
     string_t m_gamertag;
     string_t m_xboxUserId;
+    uint64_t m_xboxUserIdNumber;
     bool m_isCurrentUser;
     bool m_isTurnAvailable;
     bool m_isReserved;
@@ -2736,9 +2748,15 @@ public:
     /// </summary>
     static xbox_live_result<multiplayer_session_properties> _Deserialize(_In_ const web::json::value& json);
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    uint64_t _Session_custom_properties_hash() const;
+
 private:
 
     web::json::value m_customPropertiesJson;
+    uint64_t m_customPropertiesHash;
     std::vector<string_t> m_keywords;
     std::vector<uint32_t> m_sessionOwnerIndices;
     std::vector<std::shared_ptr<multiplayer_session_member>> m_turnCollection;
@@ -3560,6 +3578,13 @@ private:
 
     void ensure_session_subscription_id_initialized();
 
+    void index_members();
+
+    static int compare_member_xuids(
+        _In_ const multiplayer_session_member* left,
+        _In_ const multiplayer_session_member* right
+        );
+
     string_t m_xboxUserId;
     multiplayer_session_reference m_sessionReference;
     xbox::services::tournaments::tournament_arbitration_status m_arbitrationStatus;
@@ -3567,6 +3592,8 @@ private:
     std::shared_ptr<multiplayer_session_properties> m_multiplayerSessionProperties;
     std::shared_ptr<multiplayer_session_role_types> m_sessionRoleTypes;
     std::vector<std::shared_ptr<multiplayer_session_member>> m_members;
+    // m_members ordered by xuid, kept in step with m_members so sessions can be compared in one pass
+    std::vector<const multiplayer_session_member*> m_membersByXuid;
     web::json::value m_servers;
     uint32_t m_membersAccepted;
     string_t m_correlationId;
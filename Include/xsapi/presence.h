@@ -582,8 +582,11 @@ public:
 protected:
     void on_subscription_created(_In_ uint32_t id, _In_ const web::json::value& data) override;
     void on_event_received(_In_ const web::json::value& data) override;
+    void _On_event_received(_In_ const char_t* payload, _In_ size_t payloadLength) override;
 
 private:
+    void on_device_presence_received(_In_ const string_t& devicePresence);
+
     string_t m_xboxUserId;
     std::function<void(const device_presence_change_event_args&)> m_devicePresenceChangeHandler;
 };
@@ -658,8 +661,11 @@ public:
 protected:
     void on_subscription_created(_In_ uint32_t id, _In_ const web::json::value& data) override;
     void on_event_received(_In_ const web::json::value& data) override;
+    void _On_event_received(_In_ const char_t* payload, _In_ size_t payloadLength) override;
 
 private:
+    void on_title_presence_received(_In_ const string_t& titlePresence);
+
     string_t m_xboxUserId;
     uint32_t m_titleId;
     std::function<void(const title_presence_change_event_args&)> m_handler;
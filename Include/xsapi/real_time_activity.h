@@ -17,6 +17,10 @@ namespace services {
 namespace real_time_activity {
     class real_time_activity_service_factory;
     class real_time_activity_subscription_error_event_args;
+    class real_time_activity_frame;
+    class real_time_activity_routing_table;
+    class real_time_activity_submission_queue;
+    struct real_time_activity_submission_stats;
 }}}
 
 namespace xbox { namespace services { 
@@ -86,6 +90,28 @@ enum real_time_activity_subscription_state
     closed
 };
 
+/// <summary>
+/// Enumeration for the order in which pending subscriptions are sent to the
+/// real-time activity service, for example after the connection is reestablished.
+/// </summary>
+enum class real_time_activity_subscription_priority
+{
+    /// <summary>
+    /// Sent after all other pending subscriptions.
+    /// </summary>
+    low,
+
+    /// <summary>
+    /// The default priority.
+    /// </summary>
+    normal,
+
+    /// <summary>
+    /// Sent before all other pending subscriptions.
+    /// </summary>
+    high
+};
+
 /// <summary>
 /// Enumeration for the possible connection states of the connection
 /// to the real-time activity service.
@@ -128,6 +154,15 @@ public:
 
     /// <summary>The unique subscription id for the request.</summary>
     _XSAPIIMP uint32_t subscription_id() const;
+
+    /// <summary>The order in which the subscription is sent relative to other pending subscriptions.</summary>
+    _XSAPIIMP real_time_activity_subscription_priority priority() const;
+
+    /// <summary>
+    /// Sets the order in which the subscription is sent relative to other pending subscriptions.
+    /// Takes effect the next time the subscription is queued, such as when the connection is reestablished.
+    /// </summary>
+    _XSAPIIMP void set_priority(_In_ real_time_activity_subscription_priority priority);
     
     virtual ~real_time_activity_subscription() {}
 
@@ -141,16 +176,22 @@ protected:
     // Callback for each subcription's coming events
     virtual void on_event_received(_In_ const web::json::value& data);
 
+    // Callback for each subcription's coming events with the payload still as JSON text. By default it parses
+    // the payload and calls on_event_received, subscriptions override it to read simple payloads without a DOM.
+    virtual void _On_event_received(_In_ const char_t* payload, _In_ size_t payloadLength);
+
     // Callback for each subcription's state change
     virtual void on_state_changed(_In_ real_time_activity_subscription_state state);
 
     real_time_activity_subscription_state m_state;
     string_t m_resourceUri;
     uint32_t m_subscriptionId;
+    real_time_activity_subscription_priority m_priority;
     std::function<void(const real_time_activity_subscription_error_event_args&)> m_subscriptionErrorHandler;
     string_t m_guid;
 
     friend class real_time_activity_service;
+    friend class real_time_activity_submission_queue;
 };
 
 class real_time_activity_subscription_error_event_args
@@ -302,10 +343,19 @@ public:
     /// Internal function
     /// Remove total count of subscription
     /// </summary>
-    inline size_t _Subscription_Count()
-    {
-        return m_pendingSubmission.size() + m_pendingResponseSubscriptions.size() + m_subscriptions.size() + m_pendingUnsubscriptions.size();
-    }
+    size_t _Subscription_Count();
+
+    /// <summary>
+    /// Internal function
+    /// Sets how many subscribe and unsubscribe requests may wait for a response at once.
+    /// </summary>
+    void _Set_submission_window(_In_ uint32_t windowSize);
+
+    /// <summary>
+    /// Internal function
+    /// Counters for the subscribe pipeline, including how long the last reconnect took to resubscribe everything.
+    /// </summary>
+    real_time_activity_submission_stats _Submission_stats();
 
     /// <summary>
     /// Internal function
@@ -325,21 +375,24 @@ private:
     void _Close_websocket(); 
 
     void complete_subscribe(
-        _In_ web::json::value& message
+        _In_ const real_time_activity_frame& frame
         );
 
     void complete_unsubscribe(
-        _In_ web::json::value& message
+        _In_ const real_time_activity_frame& frame
         );
 
     void handle_change_event(
-        _In_ web::json::value& message
+        _In_ const real_time_activity_frame& frame
         );
     
     void trigger_resync_event();
     void trigger_connection_state_changed_event(_In_ real_time_activity_connection_state connectionState);
 
     void submit_subscriptions();
+    void on_send_failed(_In_ uint32_t sequenceNumber);
+    void schedule_resubmit();
+    size_t in_flight_count() const;
 
     std::error_code convert_rta_error_code_to_xbox_live_error_code(_In_ int32_t rtaErrorCode);
 
@@ -356,9 +409,15 @@ private:
 
     volatile long m_sequenceNumber;
 
-    std::vector<std::shared_ptr<real_time_activity_subscription>> m_pendingSubmission;
+    // Subscriptions waiting to be sent, ordered by priority
+    std::shared_ptr<real_time_activity_submission_queue> m_pendingSubmission;
+    // Delay before failed sends are retried, doubled on each consecutive failure
+    std::chrono::milliseconds m_resubmitInterval;
+    bool m_isResubmitScheduled;
     std::map<uint32_t, std::shared_ptr<real_time_activity_subscription>> m_pendingResponseSubscriptions;
     std::map<uint32_t, std::shared_ptr<real_time_activity_subscription>> m_subscriptions;
+    // Mirrors m_subscriptions for change event dispatch, which reads it without taking m_lock
+    std::shared_ptr<real_time_activity_routing_table> m_routingTable;
     std::map<uint32_t, std::shared_ptr<real_time_activity_subscription>> m_pendingUnsubscriptions;
     std::recursive_mutex m_lock;
 
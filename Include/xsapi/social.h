@@ -495,6 +495,11 @@ public:
 
     std::shared_ptr<xbox_live_context_settings> _Xbox_live_context_settings() { return m_xboxLiveContextSettings; }
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    std::shared_ptr<social_service_impl> _Impl() const { return m_socialServiceImpl; }
+
 private:
     social_service() {};
 
@@ -33,6 +33,8 @@ namespace xbox {
 
 class social_graph;
 struct xbox_social_user_context;
+class social_user_columns;
+struct social_user_group_delta;
 struct user_group_status_change;
 enum class change_list_enum;
 
@@ -384,6 +386,7 @@ private:
     social_manager_presence_title_record m_presenceVec[NUM_PRESENCE_RECORDS];
 
     friend class user_buffers_holder;
+    friend class social_user_columns;
 };
 
 /// <summary>
@@ -709,16 +712,19 @@ private:
 
     void update_view(
         _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& snapshotList,
-        _In_ const std::vector<social_event>& socialEvents
+        _In_opt_ const social_user_columns* userColumns,
+        _In_ const social_user_group_delta& groupDelta
         );
 
     void initialize_filter_list(
-        _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& users
+        _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& users,
+        _In_opt_ const social_user_columns* userColumns
         );
 
     void filter_list(
         _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& snapshotList,
-        _In_ const std::vector<social_event>& socialEvents
+        _In_opt_ const social_user_columns* userColumns,
+        _In_ const social_user_group_delta& groupDelta
         );
 
     bool get_presence_filter_result(
@@ -726,9 +732,40 @@ private:
         _In_ presence_filter presenceFilter
         ) const;
 
+    bool is_relationship_match(
+        _In_ const xbox_social_user_context& userContext,
+        _In_opt_ const social_user_columns* userColumns
+        ) const;
+
+    bool get_filter_result(
+        _In_ const xbox_social_user_context& userContext,
+        _In_opt_ const social_user_columns* userColumns
+        ) const;
+
     bool needs_update();
 
-    void remove_users(_In_ const std::vector<xbox_removal_struct>& usersToRemove);
+    void refilter_user(
+        _In_ uint64_t xboxUserId,
+        _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& snapshotList,
+        _In_opt_ const social_user_columns* userColumns
+        );
+
+    void rebase_users(
+        _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& snapshotList,
+        _In_opt_ const social_user_columns* userColumns
+        );
+
+    void add_tracked_user(
+        _In_ uint64_t xboxUserId,
+        _In_ const char_t* xboxUserIdString
+        );
+
+    void add_group_user(
+        _In_ uint64_t xboxUserId,
+        _In_ const xbox_social_user_context& userContext
+        );
+
+    void remove_user_at(_In_ size_t position);
 
     user_group_status_change _Update_users_in_group(_In_ const std::vector<string_t>& userList);
 
@@ -742,6 +779,11 @@ private:
     std::vector<xbox_user_id_container> m_userUpdateListString;
     std::vector<xbox_social_user*> m_userGroupVector;
     std::vector<uint64_t> m_userUpdateListInt;
+    // Position of each tracked xuid in m_userUpdateListInt / m_userUpdateListString, and for filter groups
+    // also in m_userGroupVector / m_userIndices, which are kept parallel to them
+    xsapi_internal_unordered_map(uint64_t, size_t) m_userPositions;
+    std::vector<uint32_t> m_userIndices;
+    const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)* m_lastSnapshot;
     string_t m_viewHash;
     std::mutex m_groupMutex;
 
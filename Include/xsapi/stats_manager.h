@@ -16,6 +16,7 @@ namespace xbox { namespace services { namespace stats { namespace manager {
 #endif
 
 class stats_manager_impl;
+struct stats_upload_stats;
 static const uint8_t STAT_PRESENCE_CHARS_NUM = 64;
 
 /// <summary> 
@@ -196,6 +197,38 @@ private:
     xbox_live_result<void> m_errorInfo;
 };
 
+/// <summary> 
+/// Identifies one stat of one local user. Resolve it once with stats_manager::get_stat_handle and use it to set
+/// and get the stat without looking the user or the stat name up again.
+/// </summary>
+class stat_handle
+{
+public:
+    /// <summary> 
+    /// Whether the handle was resolved. A handle stays valid until its user is removed from the stats manager
+    /// </summary>
+    _XSAPIIMP bool is_valid() const;
+
+    /// Internal function
+    stat_handle();
+
+    /// Internal function
+    stat_handle(
+        _In_ uint32_t userSlot,
+        _In_ uint32_t statIndex
+        );
+
+    /// Internal function
+    uint32_t _User_slot() const;
+
+    /// Internal function
+    uint32_t _Stat_index() const;
+
+private:
+    uint32_t m_userSlot;
+    uint32_t m_statIndex;
+};
+
 /// <summary> 
 /// Stats Manager handles and writes to the service a local users stats
 /// </summary>
@@ -313,6 +346,76 @@ public:
         _In_ const string_t& statName
         );
 
+    /// <summary> 
+    /// Resolves a stat name to a handle. Titles that update the same stats every frame should resolve them once and
+    /// use the handle overloads, which skip the user and name lookups and don't allocate.
+    /// </summary>
+    /// <param name="user">The local user whose stats to access</param>
+    /// <param name="statName">The name of the statistic. It doesn't need to exist yet</param>
+    /// <return>The handle for the stat</return>
+    _XSAPIIMP xbox_live_result<stat_handle> get_stat_handle(
+        _In_ const xbox_live_user_t& user,
+        _In_ const string_t& statName
+        );
+
+    /// <summary> 
+    /// Replaces the numerical stat by the value. Can be positive or negative
+    /// </summary>
+    /// <param name="statHandle">The stat to modify, from get_stat_handle</param>
+    /// <param name="statValue">Value to replace the stat by</param>
+    /// <return>Whether or not the setting was successful</return>
+    _XSAPIIMP xbox_live_result<void> set_stat_as_number(
+        _In_ const stat_handle& statHandle,
+        _In_ double statValue
+        );
+
+    /// <summary> 
+    /// Replaces the numerical stat by the value. Can be positive or negative
+    /// </summary>
+    /// <param name="statHandle">The stat to modify, from get_stat_handle</param>
+    /// <param name="statValue">Value to replace the stat by</param>
+    /// <return>Whether or not the setting was successful</return>
+    _XSAPIIMP xbox_live_result<void> set_stat_as_integer(
+        _In_ const stat_handle& statHandle,
+        _In_ int64_t statValue
+        );
+
+    /// <summary> 
+    /// Replaces a string stat with the given value.
+    /// </summary>
+    /// <param name="statHandle">The stat to modify, from get_stat_handle</param>
+    /// <param name="statValue">Value to replace the stat by</param>
+    /// <return>Whether or not the setting was successful</return>
+    _XSAPIIMP xbox_live_result<void> set_stat_as_string(
+        _In_ const stat_handle& statHandle,
+        _In_ const string_t& statValue
+        );
+
+    /// <summary> 
+    /// Gets a stat value
+    /// </summary>
+    /// <param name="statHandle">The stat to get, from get_stat_handle</param>
+    /// <return>Whether or not the stat was found along with the stat</return>
+    _XSAPIIMP xbox_live_result<stat_value> get_stat(
+        _In_ const stat_handle& statHandle
+        );
+
+    /// <summary> 
+    /// Keeps a journal of each local user's stat changes in the given directory until the service accepts them.
+    /// Changes that could not be sent before the title exited or lost connectivity are sent when the user is next added.
+    /// </summary>
+    /// <param name="journalDirectory">Directory to keep the journals in. It is created if it doesn't exist.</param>
+    /// <return>Whether or not the journal directory could be used</return>
+    /// <remarks>Only users added after this call are journaled.</remarks>
+    _XSAPIIMP xbox_live_result<void> enable_offline_journal(
+        _In_ const string_t& journalDirectory
+        );
+
+    /// <summary> 
+    /// Internal function
+    /// </summary>
+    stats_upload_stats _Upload_stats();
+
     _XSAPIIMP stats_manager();
 
     /// <summary> 
@@ -518,6 +518,58 @@ private:
     title_storage_blob_metadata m_blobMetadata;
 };
 
+class title_storage_blob_cache;
+struct title_storage_blob_download;
+struct title_storage_blob_sink_download;
+
+/// <summary>
+/// Usage counters for the local title storage blob cache.
+/// </summary>
+class title_storage_blob_cache_stats
+{
+public:
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    title_storage_blob_cache_stats();
+
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    title_storage_blob_cache_stats(
+        _In_ uint64_t hitCount,
+        _In_ uint64_t missCount,
+        _In_ uint64_t sizeInBytes,
+        _In_ uint32_t blobCount
+        );
+
+    /// <summary>
+    /// The number of downloads served from the cache after the service confirmed the cached copy was current.
+    /// </summary>
+    _XSAPIIMP uint64_t hit_count() const;
+
+    /// <summary>
+    /// The number of cacheable downloads the service had to send in full.
+    /// </summary>
+    _XSAPIIMP uint64_t miss_count() const;
+
+    /// <summary>
+    /// The total size of the cached blobs in bytes.
+    /// </summary>
+    _XSAPIIMP uint64_t size_in_bytes() const;
+
+    /// <summary>
+    /// The number of cached blobs.
+    /// </summary>
+    _XSAPIIMP uint32_t blob_count() const;
+
+private:
+    uint64_t m_hitCount;
+    uint64_t m_missCount;
+    uint64_t m_sizeInBytes;
+    uint32_t m_blobCount;
+};
+
 /// <summary>
 /// Services that manage title storage.
 /// </summary>
@@ -673,6 +725,78 @@ public:
         _In_ uint32_t preferredDownloadBlockSize
         );
 
+    /// <summary>
+    /// Downloads blob data from title storage, keeping several block requests in flight for large binary blobs.
+    /// </summary>
+    /// <param name="blobMetadata">The blob metadata for the title storage blob to download.</param>
+    /// <param name="blobBuffer">The client provided buffer to store the downloaded blob data in.</param>
+    /// <param name="etagMatchCondition">The ETag match condition used to determine if the blob should be downloaded.</param>
+    /// <param name="selectQuery">ConfigStorage filter string or JSONStorage json property name string to filter. (Optional)</param>
+    /// <param name="preferredDownloadBlockSize">The preferred download block size in bytes for binary blobs. </param>
+    /// <param name="maxConcurrentDownloads">The maximum number of block requests in flight at once. Values are clamped to
+    /// the 1 to MAX_DOWNLOAD_CONCURRENCY range; 1 downloads blocks one after another.</param>
+    /// <returns>TitleStorageBlobResult object containing the client provided blob buffer and an updated title_storage_blob_metadata object.
+    /// The metadata object will contain updated ETag and Length properties.</returns>
+    /// <remarks>
+    /// Blocks are only requested concurrently for binary blobs whose metadata carries a length and an ETag, for example
+    /// metadata returned by get_blob_metadata. The first block is downloaded on its own; if its ETag matches the metadata,
+    /// the remaining blocks are requested with If-Match on that ETag and written straight into a presized blobBuffer.
+    /// Failed blocks are retried individually. Otherwise this behaves like the other download_blob overloads.
+    /// </remarks>
+    _XSAPIIMP pplx::task<xbox_live_result<title_storage_blob_result>> download_blob(
+        _In_ title_storage_blob_metadata blobMetadata,
+        _In_ std::shared_ptr<std::vector<unsigned char>> blobBuffer,
+        _In_ title_storage_e_tag_match_condition etagMatchCondition,
+        _In_ string_t selectQuery,
+        _In_ uint32_t preferredDownloadBlockSize,
+        _In_ uint32_t maxConcurrentDownloads
+        );
+
+    /// <summary>
+    /// Downloads blob data from title storage, handing each block to a caller supplied sink instead of a buffer.
+    /// </summary>
+    /// <param name="blobMetadata">The blob metadata for the title storage blob to download.</param>
+    /// <param name="blobSink">Called with each piece of the blob, in order. The data is only valid for the duration of the call.
+    /// Return false to stop the download.</param>
+    /// <param name="etagMatchCondition">The ETag match condition used to determine if the blob should be downloaded.</param>
+    /// <param name="selectQuery">ConfigStorage filter string or JSONStorage json property name string to filter. (Optional)</param>
+    /// <param name="preferredDownloadBlockSize">The preferred download block size in bytes for binary blobs. (Optional)</param>
+    /// <returns>An updated title_storage_blob_metadata object with the ETag and Length of the downloaded blob.</returns>
+    /// <remarks>
+    /// Only one block is held in memory at a time, so large binary blobs can be written straight to a file or other stream.
+    /// Once the first block has arrived the remaining blocks are requested with If-Match on its ETag, so the sink never receives
+    /// pieces of two different versions of the blob. The download fails with xbox_live_error_code::runtime_error if the sink returns false.
+    /// Calls the same endpoints as download_blob.
+    /// </remarks>
+    _XSAPIIMP pplx::task<xbox_live_result<title_storage_blob_metadata>> download_blob_to_sink(
+        _In_ title_storage_blob_metadata blobMetadata,
+        _In_ std::function<bool(const unsigned char* data, size_t length)> blobSink,
+        _In_ title_storage_e_tag_match_condition etagMatchCondition,
+        _In_ string_t selectQuery = string_t(),
+        _In_ uint32_t preferredDownloadBlockSize = DEFAULT_DOWNLOAD_BLOCK_SIZE
+        );
+
+    /// <summary>
+    /// Uploads blob data to title storage, reading it from a caller supplied source instead of a buffer.
+    /// </summary>
+    /// <param name="blobMetadata">Contains properties required to upload the blob to title storage.  Uploads require a service configuration Id, blob path, blob type and storage type at a minimum.</param>
+    /// <param name="blobSource">Called to fill the buffer it is given with up to bufferLength bytes of the blob, returning the number of bytes written.
+    /// Returning 0 marks the end of the blob.</param>
+    /// <param name="etagMatchCondition">The ETag match condition used to determine if the blob data should be uploaded.</param>
+    /// <param name="preferredUploadBlockSize">The preferred upload block size in bytes for binary blobs. See upload_blob. (Optional)</param>
+    /// <returns>title_storage_blob_metadata object with updated Etag and Length properties.</returns>
+    /// <remarks>
+    /// Binary blobs are read one block ahead of the block being sent, so at most two blocks are held in memory at a time.
+    /// Json blobs have to be sent in a single request and are read in full before uploading.
+    /// Calls the same endpoints as upload_blob.
+    /// </remarks>
+    _XSAPIIMP pplx::task<xbox_live_result<title_storage_blob_metadata>> upload_blob_from_source(
+        _In_ title_storage_blob_metadata blobMetadata,
+        _In_ std::function<size_t(unsigned char* buffer, size_t bufferLength)> blobSource,
+        _In_ title_storage_e_tag_match_condition etagMatchCondition,
+        _In_ uint32_t preferredUploadBlockSize = DEFAULT_UPLOAD_BLOCK_SIZE
+        );
+
     /// <summary>
     /// Uploads blob data to title storage.
     /// </summary>
@@ -698,11 +822,45 @@ public:
         _In_ uint32_t preferredUploadBlockSize = DEFAULT_UPLOAD_BLOCK_SIZE
         );
 
+    /// <summary>
+    /// Keeps copies of downloaded Json and Config blobs on disk so later downloads of an unchanged blob skip the body.
+    /// </summary>
+    /// <param name="cacheDirectory">A writable directory for the cache. It is created if it does not exist, and blobs cached there
+    /// by an earlier session are reused.</param>
+    /// <param name="maxSizeInBytes">The most disk space the cached blobs may use. The least recently used blobs are evicted to stay under it.</param>
+    /// <remarks>
+    /// While the cache is enabled, download_blob calls made with title_storage_e_tag_match_condition::not_used send the cached ETag
+    /// in an If-None-Match header. A 304 Not Modified response is then answered from the cache, and any other successful response replaces
+    /// the cached copy. Binary blobs and download_blob_to_sink are not cached.
+    /// </remarks>
+    _XSAPIIMP xbox_live_result<void> enable_blob_cache(
+        _In_ const string_t& cacheDirectory,
+        _In_ uint64_t maxSizeInBytes = DEFAULT_BLOB_CACHE_SIZE
+        );
+
+    /// <summary>
+    /// Stops using the blob cache. Cached blobs are left on disk for a later enable_blob_cache call.
+    /// </summary>
+    _XSAPIIMP void disable_blob_cache();
+
+    /// <summary>
+    /// Deletes every blob in the blob cache, if it is enabled.
+    /// </summary>
+    _XSAPIIMP void clear_blob_cache();
+
+    /// <summary>
+    /// Returns hit and miss counts and the current size of the blob cache. All values are 0 if the cache is not enabled.
+    /// </summary>
+    _XSAPIIMP title_storage_blob_cache_stats blob_cache_stats() const;
+
     _XSAPIIMP static const uint32_t MIN_UPLOAD_BLOCK_SIZE;
     _XSAPIIMP static const uint32_t MAX_UPLOAD_BLOCK_SIZE;
     _XSAPIIMP static const uint32_t DEFAULT_UPLOAD_BLOCK_SIZE;
     _XSAPIIMP static const uint32_t MIN_DOWNLOAD_BLOCK_SIZE;
     _XSAPIIMP static const uint32_t DEFAULT_DOWNLOAD_BLOCK_SIZE;
+    _XSAPIIMP static const uint32_t DEFAULT_DOWNLOAD_CONCURRENCY;
+    _XSAPIIMP static const uint32_t MAX_DOWNLOAD_CONCURRENCY;
+    _XSAPIIMP static const uint64_t DEFAULT_BLOB_CACHE_SIZE;
 
 private:
     title_storage_service() {}
@@ -737,6 +895,46 @@ private:
         _In_ uint32_t endByte
         );
 
+    static pplx::task<xbox_live_result<title_storage_blob_result>> download_next_blob_block(
+        _In_ std::shared_ptr<title_storage_blob_download> download
+        );
+
+    static pplx::task<xbox_live_result<title_storage_blob_metadata>> download_next_sink_block(
+        _In_ std::shared_ptr<title_storage_blob_sink_download> download
+        );
+
+    static pplx::task<std::error_code> download_blob_blocks(
+        _In_ const std::shared_ptr<xbox::services::xbox_live_context_settings>& xboxLiveContextSettings,
+        _In_ const std::shared_ptr<xbox::services::user_context>& userContext,
+        _In_ const std::shared_ptr<xbox::services::xbox_live_app_config>& appConfig,
+        _In_ const string_t& subpathAndQuery,
+        _In_ const string_t& eTag,
+        _In_ std::shared_ptr<std::vector<unsigned char>> blobBuffer,
+        _In_ uint32_t startByte,
+        _In_ uint32_t blockSize,
+        _In_ uint32_t maxConcurrentDownloads
+        );
+
+    static std::error_code upload_blob_block(
+        _In_ const std::shared_ptr<xbox::services::xbox_live_context_settings>& xboxLiveContextSettings,
+        _In_ const std::shared_ptr<xbox::services::user_context>& userContext,
+        _In_ const std::shared_ptr<xbox::services::xbox_live_app_config>& appConfig,
+        _In_ const std::shared_ptr<std::vector<unsigned char>>& blobBuffer,
+        _In_ size_t blockStart,
+        _In_ size_t blockLength,
+        _In_ bool isFinalBlock,
+        _In_ uint64_t blobLength,
+        _In_ title_storage_e_tag_match_condition etagMatchCondition,
+        _Inout_ string_t& continuationToken,
+        _Inout_ title_storage_blob_metadata& blobMetadata
+        );
+
+    static size_t read_blob_source(
+        _In_ const std::function<size_t(unsigned char* buffer, size_t bufferLength)>& blobSource,
+        _Inout_ std::vector<unsigned char>& block,
+        _In_ size_t blockSize
+        );
+
     static xbox_live_result<string_t> title_storage_quota_subpath(
         _In_ title_storage_type storageType,
         _In_ const string_t& serviceConfigurationId,
@@ -771,6 +969,7 @@ private:
     std::shared_ptr<xbox::services::user_context> m_userContext;
     std::shared_ptr<xbox::services::xbox_live_context_settings> m_xboxLiveContextSettings;
     std::shared_ptr<xbox::services::xbox_live_app_config> m_appConfig;
+    std::shared_ptr<title_storage_blob_cache> m_blobCache;
 
     friend xbox_live_context_impl;
     friend class title_storage_blob_metadata_result;
@@ -256,6 +256,69 @@ public:
     /// </summary>
     _XSAPIIMP void set_use_core_dispatcher_for_event_routing(_In_ bool value);
 
+    /// <summary>
+    /// Gets whether large service results decode their items on first access.
+    /// </summary>
+    _XSAPIIMP bool lazy_result_deserialization() const;
+
+    /// <summary>
+    /// Controls whether achievements_result and leaderboard_result keep the raw response and only decode
+    /// their items the first time items() or rows() is called, instead of when the response arrives.
+    /// Titles that read a few fields from large pages, or page through results without looking at every one,
+    /// spend less time and memory on results they never read.
+    /// Errors in individual items are logged rather than returned, since the result has already been handed out.
+    /// Default is false.
+    /// </summary>
+    _XSAPIIMP void set_lazy_result_deserialization(_In_ bool value);
+
+    /// <summary>
+    /// Gets the steady rate, in calls per second, at which calls to each Xbox Live API are sent. 0 means they are not rate limited.
+    /// </summary>
+    _XSAPIIMP double http_api_throttle_rate() const;
+
+    /// <summary>
+    /// Gets how many calls to an Xbox Live API can be sent back to back before the throttle rate applies.
+    /// </summary>
+    _XSAPIIMP uint32_t http_api_throttle_capacity() const;
+
+    /// <summary>
+    /// Rate limits calls to each Xbox Live API on the client with a token bucket, so bursts such as presence and profile
+    /// lookups for a large friends list are spread out before they reach the service instead of drawing 429 responses.
+    /// Calls over the limit wait in a queue and are sent as tokens come back, they are not failed.
+    /// Each API has its own bucket, and only the first attempt of a call takes a token.
+    /// The throttle is shared by every xbox_live_context in the process. It is off by default.
+    /// </summary>
+    /// <param name="callsPerSecond">The steady rate. 0 turns the throttle off and sends any waiting calls.</param>
+    /// <param name="capacity">How many calls can be sent back to back after a quiet period. Values below 1 are treated as 1.</param>
+    _XSAPIIMP void set_http_api_throttle(
+        _In_ double callsPerSecond,
+        _In_ uint32_t capacity
+        );
+
+    /// <summary>
+    /// Gets the steady rate, in calls per second, at which calls to a host are sent. 0 means they are not rate limited.
+    /// </summary>
+    _XSAPIIMP double http_host_throttle_rate(_In_ const string_t& host) const;
+
+    /// <summary>
+    /// Gets how many calls to a host can be sent back to back before the throttle rate applies.
+    /// </summary>
+    _XSAPIIMP uint32_t http_host_throttle_capacity(_In_ const string_t& host) const;
+
+    /// <summary>
+    /// Rate limits calls to every Xbox Live API served by a host, such as "presence.xboxlive.com", with a token bucket.
+    /// A call waits for the API throttle first and then for the host throttle.
+    /// The throttle is shared by every xbox_live_context in the process. It is off by default.
+    /// </summary>
+    /// <param name="host">The host name, without scheme or port.</param>
+    /// <param name="callsPerSecond">The steady rate. 0 turns the throttle off and sends any waiting calls.</param>
+    /// <param name="capacity">How many calls can be sent back to back after a quiet period. Values below 1 are treated as 1.</param>
+    _XSAPIIMP void set_http_host_throttle(
+        _In_ const string_t& host,
+        _In_ double callsPerSecond,
+        _In_ uint32_t capacity
+        );
+
     /// <summary>
     /// Disables asserts for Xbox Live throttling in dev sandboxes.
     /// The asserts will not fire in RETAIL sandbox, and this setting has has no affect in RETAIL sandboxes.
@@ -317,6 +380,7 @@ private:
     bool m_useCoreDispatcherForEventRouting;
     bool m_disableAssertsForXboxLiveThrottlingInDevSandboxes;
     bool m_disableAssertsForMaxNumberOfWebsocketsActivated;
+    bool m_lazyResultDeserialization;
 };
 
 
@@ -419,7 +419,9 @@ achievement_service::get_achievements(
     {
         if (response->response_body_json().size() > 0)
         {
-            auto jsonResult = xbox::services::achievements::achievements_result::_Deserialize(response->response_body_json());
+            auto jsonResult = xboxLiveContextSettings != nullptr && xboxLiveContextSettings->lazy_result_deserialization() ?
+                achievements_result::_Deserialize_lazy(std::shared_ptr<const web::json::value>(response, &response->response_body_json())) :
+                achievements_result::_Deserialize(response->response_body_json());
             auto achievementsResult = utils::generate_xbox_live_result<achievements_result>(
                 jsonResult,
                 response
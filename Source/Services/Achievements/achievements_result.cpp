@@ -41,6 +41,11 @@ void achievements_result::_Init_next_page_info(
 const std::vector<achievement>&
 achievements_result::items() const
 {
+    if (m_lazyItems != nullptr)
+    {
+        return m_lazyItems->items();
+    }
+
     return m_items;
 }
 
@@ -98,6 +103,46 @@ achievements_result::_Deserialize(
     return xbox_live_result<achievements_result>(result, errCode);
 }
 
+xbox_live_result<achievements_result>
+achievements_result::_Deserialize_lazy(
+    _In_ std::shared_ptr<const web::json::value> json
+    )
+{
+    if (json == nullptr || json->is_null()) return xbox_live_result<achievements_result>();
+
+    achievements_result result;
+
+    std::error_code errCode = xbox_live_error_code::no_error;
+
+    // Only the shape of the page is checked here, the achievements are decoded on the first call to items()
+    if (!json->has_field(_T("achievements")) || !json->at(_T("achievements")).is_array())
+    {
+        return xbox_live_result<achievements_result>(result, xbox_live_error_code::json_error);
+    }
+
+    result.m_lazyItems = std::make_shared<lazy_json_vector<achievement>>(
+        json,
+        _T("achievements"),
+        [](const web::json::value& itemJson)
+    {
+        auto item = achievement::_Deserialize(itemJson);
+        if (item.err())
+        {
+            LOGS_ERROR << "Failed to decode achievement: " << item.err_message();
+        }
+
+        return item.payload();
+    });
+
+    auto pageInfoJson = utils::extract_json_field(*json, _T("pagingInfo"), errCode, false);
+    if (!pageInfoJson.is_null())
+    {
+        result.m_continuationToken = utils::extract_json_string(pageInfoJson, _T("continuationToken"), errCode, true);
+    }
+
+    return xbox_live_result<achievements_result>(result, errCode);
+}
+
 
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_ACHIEVEMENTS_CPP_END
\ No newline at end of file
@@ -43,6 +43,7 @@
 
 #include <cpprest/http_client.h>
 #include <cpprest/filestream.h>
+#include <cpprest/rawptrstream.h>
 #include <cpprest/http_listener.h>              // HTTP server
 #include <cpprest/json.h>                       // JSON library
 #include <cpprest/uri.h>                        // URI library
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "xsapi/events.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_BEGIN
+
+/// <summary>
+/// Whether a name can be used for an in-game event, or with allowUnderscore false, for one of its fields
+/// </summary>
+bool is_valid_in_game_event_name(
+    _In_ const string_t& name,
+    _In_ bool allowUnderscore
+    );
+
+struct in_game_event
+{
+    string_t name;
+    web::json::value dimensions;
+    web::json::value measurements;
+};
+
+struct in_game_event_batch_stats
+{
+    in_game_event_batch_stats() :
+        queuedCount(0),
+        flushedCount(0),
+        droppedCount(0),
+        pendingCount(0)
+    {
+    }
+
+    uint64_t queuedCount;
+    uint64_t flushedCount;
+    // Events that never reached the platform, either because the buffer was full or because the write failed
+    uint64_t droppedCount;
+    uint32_t pendingCount;
+};
+
+/// <summary>
+/// Buffers in-game events queued by the title until enough have built up, or enough time has passed, to hand
+/// them to the platform in one go. The buffer is allocated up front and events queued while it is full are
+/// dropped rather than growing it, so a title that logs faster than the events can be written never grows
+/// without bound. Thread safe; copies of events_service share one batch.
+/// </summary>
+class in_game_event_batch
+{
+public:
+    static const size_t DEFAULT_CAPACITY = 512;
+    static const size_t DEFAULT_FLUSH_SIZE = 64;
+    static const uint32_t DEFAULT_FLUSH_INTERVAL_MS = 5000;
+
+    in_game_event_batch();
+
+    in_game_event_batch(
+        _In_ size_t capacity,
+        _In_ size_t flushSize,
+        _In_ std::chrono::milliseconds flushInterval
+        );
+
+    /// <summary>
+    /// Adds an event to the buffer. Returns false if the buffer is full and the event was dropped.
+    /// flushNow is set when the buffer reached the flush size and the caller should flush it,
+    /// startTimer is set when this is the first event since the last flush and the caller should schedule one.
+    /// </summary>
+    bool push(
+        _In_ in_game_event&& evt,
+        _Out_ bool& flushNow,
+        _Out_ bool& startTimer
+        );
+
+    /// <summary>
+    /// Removes and returns every buffered event.
+    /// </summary>
+    std::vector<in_game_event> take();
+
+    void on_flush_timer_elapsed();
+
+    void on_flushed(
+        _In_ size_t writtenCount,
+        _In_ size_t failedCount
+        );
+
+    std::chrono::milliseconds flush_interval() const;
+
+    in_game_event_batch_stats stats() const;
+
+private:
+    mutable std::mutex m_lock;
+    std::vector<in_game_event> m_events;
+    size_t m_capacity;
+    size_t m_flushSize;
+    std::chrono::milliseconds m_flushInterval;
+    bool m_isFlushRequested;
+    bool m_isTimerPending;
+
+    uint64_t m_queuedCount;
+    uint64_t m_flushedCount;
+    uint64_t m_droppedCount;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_END
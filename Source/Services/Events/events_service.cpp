@@ -4,9 +4,15 @@
 #include "pch.h"
 #if !UNIT_TEST_SERVICES
 #include "xsapi/events.h"
+#include "events_internal.h"
 #include "xbox_system_factory.h"
 #include "utils.h"
 #include "user_context.h"
+#if XSAPI_U
+#include "ppltasks_extra_unix.h"
+#else
+#include "ppltasks_extra.h"
+#endif
 #if XSAPI_A
 #include "a/user_impl_a.h"
 #include "a/java_interop.h"
@@ -16,7 +22,6 @@
 
 #if UWP_API
 #include <initguid.h>
-#include <regex>
 #include <debugapi.h>
 #include "service_call_logger_data.h"
 #include "service_call_logger.h"
@@ -37,6 +42,7 @@ DEFINE_GUID(GUID_LOGGING_CHANNEL,
 #endif
 
 using namespace xbox::services::system;
+using namespace Concurrency::extras;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_BEGIN
 
@@ -46,7 +52,8 @@ events_service::events_service(
     _In_ std::shared_ptr<xbox::services::xbox_live_app_config> appConfig
 ) :
     m_userContext(std::move(userContext)),
-    m_appConfig(std::move(appConfig))
+    m_appConfig(std::move(appConfig)),
+    m_eventBatch(std::make_shared<in_game_event_batch>())
 {
     m_playSession = utils::create_guid(true).c_str();
 #if UWP_API
@@ -72,12 +79,47 @@ events_service::write_in_game_event(_In_ const string_t& eventName)
     return write_in_game_event(eventName, web::json::value::null(), web::json::value::null());
 }
 
+struct events_service::common_event_fields
+{
+    common_event_fields() :
+        isServiceCallLoggingEnabled(false)
+    {
+    }
+
+    bool isServiceCallLoggingEnabled;
+#if UWP_API
+    String^ appInsightsKey;
+    String^ serviceConfigId;
+    String^ playerSessionId;
+    String^ titleId;
+    String^ userId;
+#elif XSAPI_U
+    web::json::value baseData;
+    string_t eventNamePrefix;
+#endif
+};
+
 xbox_live_result<void>
 events_service::write_in_game_event(
     _In_ const string_t& eventName,
     _In_ const web::json::value& dimensions,
     _In_ const web::json::value& measurements
 )
+{
+    common_event_fields commonFields;
+    auto result = create_common_event_fields(commonFields);
+    if (result.err())
+    {
+        return result;
+    }
+
+    return write_in_game_event(commonFields, eventName, dimensions, measurements);
+}
+
+xbox_live_result<void>
+events_service::create_common_event_fields(
+    _Inout_ common_event_fields& commonFields
+    )
 {
     try
     {
@@ -90,17 +132,68 @@ events_service::write_in_game_event(
             return xbox_live_result<void>(xbox_live_error_code::auth_user_not_signed_in, "User must be signed in to call this API");
         }
 
+#ifdef _WIN32
+        commonFields.isServiceCallLoggingEnabled = xbox::services::service_call_logger::get_singleton_instance()->is_enabled();
+#endif
+#if UWP_API
+        if (!m_appInsightsKey.empty())
+        {
+            commonFields.appInsightsKey = "AIX-" + ref new String(m_appInsightsKey.c_str());
+        }
+
+        commonFields.serviceConfigId = ref new String(m_appConfig->scid().c_str());
+        commonFields.playerSessionId = ref new String(m_playSession.c_str());
+        commonFields.titleId = m_appConfig->title_id().ToString();
+        commonFields.userId = ref new String(m_userContext->xbox_user_id().c_str());
+#elif XSAPI_U
+        stringstream_t ss;
+        ss << m_appConfig->title_id();
+
+        commonFields.baseData[_T("serviceConfigId")] = web::json::value::string(m_appConfig->scid().c_str());
+        commonFields.baseData[_T("playerSessionId")] = web::json::value::string(m_playSession.c_str());
+        commonFields.baseData[_T("titleId")] = web::json::value::string(ss.str());
+        commonFields.baseData[_T("userId")] = web::json::value::string(m_userContext->xbox_user_id().c_str());
+        commonFields.baseData[_T("ver")] = web::json::value::number(1);
+
+        stringstream_t eventNamePrefix;
+        eventNamePrefix << "Microsoft.XboxLive.T" << ss.str() << ".";
+        commonFields.eventNamePrefix = eventNamePrefix.str();
+#endif
+    }
+    catch (const std::exception& e)
+    {
+        xbox_live_error_code err = utils::convert_exception_to_xbox_live_error_code();
+        return xbox_live_result<void>(err, e.what());
+    }
+#if UWP_API
+    catch (Platform::Exception^ e)
+    {
+        xbox_live_error_code errc = static_cast<xbox_live_error_code>(e->HResult);
+        return xbox_live_result<void>(errc, utility::conversions::to_utf8string(e->Message->Data()));
+    }
+#endif
+    return xbox_live_result<void>();
+}
+
+xbox_live_result<void>
+events_service::write_in_game_event(
+    _In_ const common_event_fields& commonFields,
+    _In_ const string_t& eventName,
+    _In_ const web::json::value& dimensions,
+    _In_ const web::json::value& measurements
+    )
+{
+    try
+    {
         // Check event name
-        regex_t regex(_T("[A-Za-z]+[A-Za-z0-9_]*"));
-        bool matchFound = std::regex_match(eventName, regex);
-        if (!matchFound)
+        if (!is_valid_in_game_event_name(eventName, true))
         {
             return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "Invalid event name");
         }
 
 #ifdef _WIN32
         //Log service call
-        if (xbox::services::service_call_logger::get_singleton_instance()->is_enabled())
+        if (commonFields.isServiceCallLoggingEnabled)
         {
             std::shared_ptr<service_call_logger> tracker = service_call_logger::get_singleton_instance();
 
@@ -118,34 +211,26 @@ events_service::write_in_game_event(
 #endif
 #if UWP_API
 
-        auto fields = create_logging_field(eventName, dimensions, measurements);
+        auto fields = create_logging_field(commonFields, eventName, dimensions, measurements);
 
         m_loggingChannel->LogEvent(ref new String(eventName.c_str()), fields, LoggingLevel::Critical, m_loggingOptions);
 #elif XSAPI_U
-        stringstream_t ss;
-        ss << m_appConfig->title_id();
         web::json::value eventData;
         eventData[_T("baseType")] = web::json::value::string(_T("Microsoft.XboxLive.InGame"));
 
-        web::json::value baseData;
+        web::json::value baseData = commonFields.baseData;
         baseData[_T("name")] = web::json::value::string(eventName.c_str());
-        baseData[_T("serviceConfigId")] = web::json::value::string(m_appConfig->scid().c_str());
-        baseData[_T("playerSessionId")] = web::json::value::string(m_playSession.c_str());
-        baseData[_T("titleId")] = web::json::value::string(ss.str());
-        baseData[_T("userId")] = web::json::value::string(m_userContext->xbox_user_id().c_str());
-        baseData[_T("ver")] = web::json::value::number(1);
         baseData[_T("properties")] = dimensions;
         baseData[_T("measurements")] = measurements;
 
         eventData[_T("baseData")] = baseData;
 
-        stringstream_t eventNameStream;
-        eventNameStream << "Microsoft.XboxLive.T" << ss.str() << "." << eventName;
+        string_t fullEventName = commonFields.eventNamePrefix + eventName;
 #if XSAPI_A
         std::shared_ptr<java_interop> interop = java_interop::get_java_interop_singleton();
         if (interop)
         {
-            interop->log_cll(m_userContext->xbox_user_id(), eventNameStream.str(), eventData.serialize());
+            interop->log_cll(m_userContext->xbox_user_id(), fullEventName, eventData.serialize());
         }
 #elif XSAPI_I
         std::shared_ptr<xbox_cll> cll = xbox_cll::get_xbox_cll_singleton();
@@ -153,7 +238,7 @@ events_service::write_in_game_event(
         iOSCll* iCll = static_cast<iOSCll*>(cll->raw_cll().get());
         if (iCll)
         {
-            iCll->log(eventNameStream.str(),
+            iCll->log(fullEventName,
                 eventData.serialize(),
                 cll::Latency::LatencyRealtime,
                 cll::Persistence::PersistenceCritical,
@@ -180,18 +265,140 @@ events_service::write_in_game_event(
     return xbox_live_result<void>();
 }
 
+xbox_live_result<void>
+events_service::queue_in_game_event(_In_ const string_t& eventName)
+{
+    return queue_in_game_event(eventName, web::json::value::null(), web::json::value::null());
+}
+
+xbox_live_result<void>
+events_service::queue_in_game_event(
+    _In_ const string_t& eventName,
+    _In_ const web::json::value& dimensions,
+    _In_ const web::json::value& measurements
+    )
+{
+    if (m_eventBatch == nullptr)
+    {
+        return xbox_live_result<void>(xbox_live_error_code::logic_error, "events_service is not initialized");
+    }
+
+    // Reject bad names now, the title would never hear about them once the batch is written
+    if (!is_valid_in_game_event_name(eventName, true))
+    {
+        return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "Invalid event name");
+    }
+
+    in_game_event evt;
+    evt.name = eventName;
+    evt.dimensions = dimensions;
+    evt.measurements = measurements;
+
+    bool flushNow = false;
+    bool startTimer = false;
+    if (!m_eventBatch->push(std::move(evt), flushNow, startTimer))
+    {
+        return xbox_live_result<void>(xbox_live_error_code::out_of_range, "In-game event buffer is full, event dropped");
+    }
+
+    if (flushNow || startTimer)
+    {
+        schedule_flush(flushNow);
+    }
+
+    return xbox_live_result<void>();
+}
+
+xbox_live_result<void>
+events_service::flush_in_game_events()
+{
+    if (m_eventBatch == nullptr)
+    {
+        return xbox_live_result<void>();
+    }
+
+    auto events = m_eventBatch->take();
+    if (events.empty())
+    {
+        return xbox_live_result<void>();
+    }
+
+    // The sign in check and the fields every event shares are done once for the whole batch
+    common_event_fields commonFields;
+    xbox_live_result<void> result = create_common_event_fields(commonFields);
+    size_t failedCount = 0;
+    if (result.err())
+    {
+        failedCount = events.size();
+    }
+    else
+    {
+        for (const auto& evt : events)
+        {
+            auto writeResult = write_in_game_event(commonFields, evt.name, evt.dimensions, evt.measurements);
+            if (writeResult.err())
+            {
+                ++failedCount;
+                result = writeResult;
+            }
+        }
+    }
+
+    m_eventBatch->on_flushed(events.size() - failedCount, failedCount);
+    if (failedCount > 0)
+    {
+        LOGS_ERROR << "Failed to write " << failedCount << " of " << events.size() << " queued in-game events: " << result.err_message();
+    }
+
+    return result;
+}
+
+in_game_event_batch_stats
+events_service::_Batch_stats() const
+{
+    return m_eventBatch != nullptr ? m_eventBatch->stats() : in_game_event_batch_stats();
+}
+
+void
+events_service::schedule_flush(_In_ bool flushNow)
+{
+    // The copy keeps the user context and batch alive until the flush runs, then lets them go
+    events_service service = *this;
+    if (flushNow)
+    {
+        pplx::create_task([service]() mutable
+        {
+            service.flush_in_game_events();
+        });
+    }
+    else
+    {
+        create_delayed_task(
+            m_eventBatch->flush_interval(),
+            [service]() mutable
+        {
+            service.m_eventBatch->on_flush_timer_elapsed();
+            service.flush_in_game_events();
+        });
+    }
+}
+
 #if UWP_API
-void events_service::add_common_logging_field(_In_ Windows::Foundation::Diagnostics::LoggingFields^ fields)
+void events_service::add_common_logging_field(
+    _In_ Windows::Foundation::Diagnostics::LoggingFields^ fields,
+    _In_ const common_event_fields& commonFields
+    )
 {
-    fields->AddString("serviceConfigId", ref new String(m_appConfig->scid().c_str()));
-    fields->AddString("playerSessionId", ref new String(m_playSession.c_str()));
-    fields->AddString("titleId", m_appConfig->title_id().ToString());
-    fields->AddString("userId", ref new String(m_userContext->xbox_user_id().c_str()));
+    fields->AddString("serviceConfigId", commonFields.serviceConfigId);
+    fields->AddString("playerSessionId", commonFields.playerSessionId);
+    fields->AddString("titleId", commonFields.titleId);
+    fields->AddString("userId", commonFields.userId);
     fields->AddUInt16("ver", 1);
 }
 
 Windows::Foundation::Diagnostics::LoggingFields^
 events_service::create_logging_field(
+    _In_ const common_event_fields& commonFields,
     _In_ const string_t& eventName,
     _In_ const web::json::value& dimensions,
     _In_ const web::json::value& measurements
@@ -202,14 +409,14 @@ events_service::create_logging_field(
     THROW_CPP_INVALIDARGUMENT_IF(!(measurements.is_object() || measurements.is_null()));
 
     auto fields = ref new Windows::Foundation::Diagnostics::LoggingFields();
-    if (!m_appInsightsKey.empty())
+    if (commonFields.appInsightsKey != nullptr)
     {
-        fields->AddString("PartA_iKey", "AIX-" + ref new String(m_appInsightsKey.c_str()));
+        fields->AddString("PartA_iKey", commonFields.appInsightsKey);
     }
 
     fields->BeginStruct("PartB_Microsoft.XboxLive.InGame");
     fields->AddString("name", ref new String(eventName.c_str()));
-    add_common_logging_field(fields);
+    add_common_logging_field(fields, commonFields);
 
     if (dimensions.is_object())
     {
@@ -248,9 +455,7 @@ events_service::add_value_pair(
     const auto& name = pair.first;
     THROW_CPP_INVALIDARGUMENT_IF_STRING_EMPTY(name);
 
-    regex_t regex(_T("[A-Za-z]+[A-Za-z0-9]*"));
-    bool matchFound = std::regex_match(name, regex);
-    if (!matchFound)
+    if (!is_valid_in_game_event_name(name, false))
     {
         throw std::invalid_argument("Invalid properties or measurements name");
     }
@@ -0,0 +1,144 @@
+﻿// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "events_internal.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_BEGIN
+
+static bool is_ascii_letter(_In_ char_t c)
+{
+    return (c >= _T('A') && c <= _T('Z')) || (c >= _T('a') && c <= _T('z'));
+}
+
+// Matches [A-Za-z]+[A-Za-z0-9_]* for event names and [A-Za-z]+[A-Za-z0-9]* for field names. Checked by hand
+// rather than with std::regex, which had to be built on every event and cost more than writing the event.
+bool is_valid_in_game_event_name(
+    _In_ const string_t& name,
+    _In_ bool allowUnderscore
+    )
+{
+    if (name.empty() || !is_ascii_letter(name[0]))
+    {
+        return false;
+    }
+
+    for (size_t i = 1; i < name.size(); ++i)
+    {
+        char_t c = name[i];
+        if (!is_ascii_letter(c) && !(c >= _T('0') && c <= _T('9')) && !(allowUnderscore && c == _T('_')))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+in_game_event_batch::in_game_event_batch() :
+    in_game_event_batch(DEFAULT_CAPACITY, DEFAULT_FLUSH_SIZE, std::chrono::milliseconds(DEFAULT_FLUSH_INTERVAL_MS))
+{
+}
+
+in_game_event_batch::in_game_event_batch(
+    _In_ size_t capacity,
+    _In_ size_t flushSize,
+    _In_ std::chrono::milliseconds flushInterval
+    ) :
+    m_capacity(capacity),
+    m_flushSize(flushSize),
+    m_flushInterval(flushInterval),
+    m_isFlushRequested(false),
+    m_isTimerPending(false),
+    m_queuedCount(0),
+    m_flushedCount(0),
+    m_droppedCount(0)
+{
+    m_events.reserve(m_capacity);
+}
+
+bool
+in_game_event_batch::push(
+    _In_ in_game_event&& evt,
+    _Out_ bool& flushNow,
+    _Out_ bool& startTimer
+    )
+{
+    flushNow = false;
+    startTimer = false;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_events.size() >= m_capacity)
+    {
+        ++m_droppedCount;
+        return false;
+    }
+
+    m_events.push_back(std::move(evt));
+    ++m_queuedCount;
+
+    // Only ask for one flush at a time, events queued while it is pending go out with it
+    if (m_events.size() >= m_flushSize && !m_isFlushRequested)
+    {
+        m_isFlushRequested = true;
+        flushNow = true;
+    }
+    else if (!m_isTimerPending)
+    {
+        m_isTimerPending = true;
+        startTimer = true;
+    }
+
+    return true;
+}
+
+std::vector<in_game_event>
+in_game_event_batch::take()
+{
+    std::vector<in_game_event> events;
+    events.reserve(m_capacity);
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    events.swap(m_events);
+    m_isFlushRequested = false;
+    return events;
+}
+
+void
+in_game_event_batch::on_flush_timer_elapsed()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_isTimerPending = false;
+}
+
+void
+in_game_event_batch::on_flushed(
+    _In_ size_t writtenCount,
+    _In_ size_t failedCount
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_flushedCount += writtenCount;
+    m_droppedCount += failedCount;
+}
+
+std::chrono::milliseconds
+in_game_event_batch::flush_interval() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_flushInterval;
+}
+
+in_game_event_batch_stats
+in_game_event_batch::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    in_game_event_batch_stats stats;
+    stats.queuedCount = m_queuedCount;
+    stats.flushedCount = m_flushedCount;
+    stats.droppedCount = m_droppedCount;
+    stats.pendingCount = static_cast<uint32_t>(m_events.size());
+    return stats;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_END
@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "shared_macros.h"
+#include "utils.h"
 #include "leaderboard_query.h"
 #include "xsapi/leaderboard.h"
 
@@ -51,9 +52,19 @@ const std::vector<leaderboard_column>& leaderboard_result::columns() const
 
 const std::vector<leaderboard_row>& leaderboard_result::rows() const
 {
+    if (m_lazyRows != nullptr)
+    {
+        return m_lazyRows->items();
+    }
+
     return m_rows;
 }
 
+void leaderboard_result::_Set_lazy_rows(_In_ std::shared_ptr<xbox::services::lazy_json_vector<leaderboard_row>> lazyRows)
+{
+    m_lazyRows = std::move(lazyRows);
+}
+
 void leaderboard_result::_Set_next_query(std::shared_ptr<leaderboard_global_query> query)
 {
     m_globalQuery = std::move(query);
@@ -79,6 +90,13 @@ void leaderboard_result::_Parse_additional_columns(const std::vector<string_t>&
     }
     columns.push_back(m_columns[0]);
 
+    if (m_lazyRows != nullptr)
+    {
+        // The columns are filled in from every row, so decode them now. Nothing else holds the rows yet.
+        m_rows = std::move(m_lazyRows->items());
+        m_lazyRows = nullptr;
+    }
+
     std::unordered_map<string_t, leaderboard_stat_type> stats;
 
     for (auto& row : m_rows)
@@ -75,7 +75,7 @@ deserialize_column(
 
 xbox_live_result<leaderboard_result>
 deserialize_result(
-    _In_ const web::json::value& json,
+    _In_ std::shared_ptr<const web::json::value> json,
     _In_ std::shared_ptr<xbox::services::user_context> userContext,
     _In_ std::shared_ptr<xbox::services::xbox_live_context_settings> xboxLiveContextSettings,
     _In_ std::shared_ptr<xbox::services::xbox_live_app_config> appConfig,
@@ -84,10 +84,10 @@ deserialize_result(
     )
 {
     std::error_code errc;
-    web::json::value lb_info = utils::extract_json_field(json, _T("leaderboardInfo"), errc, true);
+    web::json::value lb_info = utils::extract_json_field(*json, _T("leaderboardInfo"), errc, true);
     int totalCount = utils::extract_json_int(lb_info, _T("totalCount"), errc, true);
 
-    web::json::value paging_info = utils::extract_json_field(json, _T("pagingInfo"), errc, false);
+    web::json::value paging_info = utils::extract_json_field(*json, _T("pagingInfo"), errc, false);
     string_t continuationToken;
     if (!paging_info.is_null())
     {
@@ -100,16 +100,28 @@ deserialize_result(
 
     columns.push_back(deserialize_column(json_column, errc));
 
+    bool lazyRows = xboxLiveContextSettings != nullptr && xboxLiveContextSettings->lazy_result_deserialization();
     std::vector<leaderboard_row> rows;
-    web::json::array json_rows = 
-        utils::extract_json_as_array(
-            utils::extract_json_field(json, _T("userList"), errc, true),
-            errc
-            );
-
-    for (const auto& row : json_rows)
+    if (lazyRows)
+    {
+        // Only the shape of the page is checked here, the rows are decoded on the first call to rows()
+        if (!json->has_field(_T("userList")) || !json->at(_T("userList")).is_array())
+        {
+            errc = xbox_live_error_code::json_error;
+        }
+    }
+    else
     {
-        rows.push_back(deserialize_row(row, errc));
+        web::json::array json_rows =
+            utils::extract_json_as_array(
+                utils::extract_json_field(*json, _T("userList"), errc, true),
+                errc
+                );
+
+        for (const auto& row : json_rows)
+        {
+            rows.push_back(deserialize_row(row, errc));
+        }
     }
 
     auto result = leaderboard_result(
@@ -123,6 +135,24 @@ deserialize_result(
         appConfig
         );
 
+    if (lazyRows)
+    {
+        result._Set_lazy_rows(std::make_shared<lazy_json_vector<leaderboard_row>>(
+            json,
+            _T("userList"),
+            [](const web::json::value& rowJson)
+        {
+            std::error_code rowErrc;
+            auto row = deserialize_row(rowJson, rowErrc);
+            if (rowErrc)
+            {
+                LOGS_ERROR << "Failed to decode leaderboard row: " << rowErrc.message();
+            }
+
+            return row;
+        }));
+    }
+
     if (version == _T("2017"))
     {
         query._Set_continuation_token(continuationToken);
@@ -14,8 +14,10 @@ leaderboard_row deserialize_row(_In_ const web::json::value& json, _In_ std::err
 
 leaderboard_column deserialize_column(_In_ const web::json::value& json, _In_ std::error_code& errc);
 
+// Decodes the rows on the first call to leaderboard_result::rows() when the settings ask for lazy results,
+// keeping json alive until then
 xbox_live_result<leaderboard_result> deserialize_result(
-    _In_ const web::json::value& json,
+    _In_ std::shared_ptr<const web::json::value> json,
     _In_ std::shared_ptr<xbox::services::user_context> userContext,
     _In_ std::shared_ptr<xbox::services::xbox_live_context_settings> xboxLiveContextSettings,
     _In_ std::shared_ptr<xbox::services::xbox_live_app_config> appConfig,
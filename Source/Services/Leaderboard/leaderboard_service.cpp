@@ -379,7 +379,7 @@ pplx::task<xbox_live_result<leaderboard_result>> leaderboard_service::get_leader
     {
         return utils::generate_xbox_live_result<leaderboard_result>(
             serializers::deserialize_result(
-                response->response_body_json(),
+                std::shared_ptr<const web::json::value>(response, &response->response_body_json()),
                 userContext,
                 xboxLiveContextSettings,
                 appConfig,
@@ -539,7 +539,7 @@ pplx::task<xbox_live_result<leaderboard_result>> leaderboard_service::get_leader
 
         return utils::generate_xbox_live_result<leaderboard_result>( 
             serializers::deserialize_result(
-                response->response_body_json(),
+                std::shared_ptr<const web::json::value>(response, &response->response_body_json()),
                 userContext,
                 xboxLiveContextSettings,
                 appConfig,
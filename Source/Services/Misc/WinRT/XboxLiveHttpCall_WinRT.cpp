@@ -30,7 +30,7 @@ XboxLiveHttpCallResponse::XboxLiveHttpCallResponse(
         m_headersMap->Insert(ref new Platform::String(header.first.c_str()), ref new Platform::String(header.second.c_str()));
     }
 
-    std::vector<unsigned char> cppVec = m_cppObj->response_body_vector();
+    const std::vector<unsigned char>& cppVec = m_cppObj->response_body_vector();
     if( cppVec.size() > 0 )
     {
         m_vec = ref new Platform::Array<byte>(&cppVec[0], static_cast<uint32>(cppVec.size()));
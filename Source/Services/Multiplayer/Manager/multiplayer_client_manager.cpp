@@ -26,7 +26,7 @@ multiplayer_client_manager::multiplayer_client_manager(const multiplayer_client_
     m_subscriptionLostContext = other.m_subscriptionLostContext;
     m_rtaResyncContext = other.m_rtaResyncContext;
     m_primaryXboxLiveContext = other.m_primaryXboxLiveContext == nullptr ? nullptr : other.m_primaryXboxLiveContext;
-    m_lastPendingRead = other.m_lastPendingRead == nullptr ? nullptr : other.m_lastPendingRead;
+    m_lastSnapshot = std::atomic_load(&other.m_lastSnapshot);
     m_latestPendingRead = other.m_latestPendingRead == nullptr ? nullptr : other.m_latestPendingRead;
 }
 
@@ -89,7 +89,7 @@ multiplayer_client_manager::initialize()
         m_multiplayerLocalUserManager
         );
 
-    m_lastPendingRead = std::make_shared<multiplayer_client_pending_reader>();
+    std::atomic_store(&m_lastSnapshot, std::make_shared<const multiplayer_client_snapshot>());
     m_subscriptionsLostFired.store(false);
     m_latestPendingRead->set_auto_fill_members_during_matchmaking(m_autoFillMembers);
 }
@@ -104,7 +104,7 @@ void
 multiplayer_client_manager::destroy()
 {
     m_latestPendingRead.reset();
-    m_lastPendingRead.reset();
+    std::atomic_store(&m_lastSnapshot, std::shared_ptr<const multiplayer_client_snapshot>());
     if (m_multiplayerLocalUserManager != nullptr)
     {
         m_multiplayerLocalUserManager->remove_multiplayer_session_changed_handler(m_sessionChangedContext);
@@ -597,11 +597,17 @@ multiplayer_client_manager::latest_pending_read() const
     return m_latestPendingRead;
 }
 
-std::shared_ptr<multiplayer_client_pending_reader>
-multiplayer_client_manager::last_pending_read() const
+std::shared_ptr<const multiplayer_client_snapshot>
+multiplayer_client_manager::last_snapshot() const
 {
-    std::lock_guard<std::mutex> guard(m_clientRequestLock);
-    return m_lastPendingRead;
+    // Snapshots are never modified once published, so readers don't need m_clientRequestLock
+    return std::atomic_load(&m_lastSnapshot);
+}
+
+void
+multiplayer_client_manager::publish_snapshot()
+{
+    std::atomic_store(&m_lastSnapshot, m_latestPendingRead->create_snapshot());
 }
 
 std::shared_ptr<multiplayer_lobby_client>
@@ -630,7 +636,8 @@ multiplayer_client_manager::is_update_avaialable()
         return false;
     }
 
-    if (m_lastPendingRead->is_update_avaialable(*m_latestPendingRead))
+    auto lastSnapshot = std::atomic_load(&m_lastSnapshot);
+    if (lastSnapshot == nullptr || m_latestPendingRead->is_update_avaialable(*lastSnapshot))
     {
         return true;
     }
@@ -658,12 +665,14 @@ multiplayer_client_manager::do_work()
 
     m_latestPendingRead->do_work();
 
-    process_events(m_latestPendingRead->lobby_client()->session(), m_lastPendingRead->lobby_client()->session(), multiplayer_session_type::lobby_session);
-    process_events(m_latestPendingRead->game_client()->session(), m_lastPendingRead->game_client()->session(), multiplayer_session_type::game_session);
-    process_events(m_latestPendingRead->match_client()->session(), m_lastPendingRead->match_client()->session(), multiplayer_session_type::match_session);
+    auto lastSnapshot = std::atomic_load(&m_lastSnapshot);
+    process_events(m_latestPendingRead->lobby_client()->session(), lastSnapshot->lobbySession, multiplayer_session_type::lobby_session);
+    process_events(m_latestPendingRead->game_client()->session(), lastSnapshot->gameSession, multiplayer_session_type::game_session);
+    process_events(m_latestPendingRead->match_client()->session(), lastSnapshot->matchSession, multiplayer_session_type::match_session);
 
-    m_lastPendingRead->deep_copy_if_updated(*m_latestPendingRead);
-    auto eventQueue = m_lastPendingRead->multiplayer_event_queue();
+    // Sessions are deep copied by whoever changes them, so the snapshot can share them with the pending reader
+    publish_snapshot();
+    auto eventQueue = m_latestPendingRead->take_multiplayer_event_queue();
 
     if (get_xbox_live_context_map().size() == 0 && !is_request_in_progress())
     {
@@ -680,9 +689,6 @@ multiplayer_client_manager::do_work()
         }
     }
 
-    m_latestPendingRead->clear_multiplayer_event_queue();
-    m_lastPendingRead->clear_multiplayer_event_queue();
-
     return eventQueue;
 }
 
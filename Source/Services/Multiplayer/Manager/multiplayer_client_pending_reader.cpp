@@ -10,39 +10,16 @@ using namespace xbox::services::multiplayer;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
 
-void multiplayer_client_pending_reader::deep_copy_if_updated(
-    _In_ const multiplayer_client_pending_reader& other
-    )
+std::shared_ptr<const multiplayer_client_snapshot>
+multiplayer_client_pending_reader::create_snapshot()
 {
-    std::lock_guard<std::mutex> lock(other.m_clientRequestLock);
+    auto snapshot = std::make_shared<multiplayer_client_snapshot>();
 
-    m_multiplayerEventQueue = other.m_multiplayerEventQueue;
-    if (other.m_lobbyClient == nullptr)
-    {
-        m_lobbyClient = nullptr;
-    }
-    else
-    {
-        m_lobbyClient->deep_copy_if_updated(*other.m_lobbyClient);
-    }
-
-    if (other.m_gameClient == nullptr)
-    {
-        m_gameClient = nullptr;
-    }
-    else
-    {
-        m_gameClient->deep_copy_if_updated(*other.m_gameClient);
-    }
-
-    if (other.m_matchClient == nullptr)
-    {
-        m_matchClient = nullptr;
-    }
-    else
-    {
-        m_matchClient->deep_copy_if_updated(*other.m_matchClient);
-    }
+    std::lock_guard<std::mutex> lock(m_clientRequestLock);
+    m_lobbyClient->copy_to_snapshot(*snapshot);
+    m_gameClient->copy_to_snapshot(*snapshot);
+    snapshot->matchSession = m_matchClient->session();
+    return snapshot;
 }
 
 multiplayer_client_pending_reader::multiplayer_client_pending_reader() :
@@ -78,28 +55,24 @@ multiplayer_client_pending_reader::multiplayer_client_pending_reader(
 
 bool
 multiplayer_client_pending_reader::is_update_avaialable(
-    _In_ const multiplayer_client_pending_reader& other
+    _In_ const multiplayer_client_snapshot& lastSnapshot
     )
 {
-    std::lock_guard<std::mutex> lock(other.m_clientRequestLock);
+    std::lock_guard<std::mutex> lock(m_clientRequestLock);
 
-    if (other.m_lobbyClient->is_pending_lobby_changes() ||
-        other.m_gameClient->is_pending_game_changes())
+    if (m_lobbyClient->is_pending_lobby_changes() ||
+        m_gameClient->is_pending_game_changes())
     {
         return true;
     }
 
-    auto lobbySession = m_lobbyClient->session();
-    auto otherLobbySession = other.m_lobbyClient->session();
-    auto gameSession = m_gameClient->session();
-    auto otherGameSession = other.m_gameClient->session();
-    if ( !multiplayer_manager_utils::compare_sessions(lobbySession, otherLobbySession) ||
-         !multiplayer_manager_utils::compare_sessions(gameSession, otherGameSession) ||
-         !multiplayer_manager_utils::compare_sessions(m_matchClient->session(), other.m_matchClient->session()) ||
-         m_lobbyClient->multiplayer_event_queue().size() != other.m_lobbyClient->multiplayer_event_queue().size() ||
-         m_gameClient->multiplayer_event_queue().size() != other.m_gameClient->multiplayer_event_queue().size() ||
-         m_matchClient->multiplayer_event_queue().size() != other.m_matchClient->multiplayer_event_queue().size() ||
-         m_multiplayerEventQueue.size() != other.m_multiplayerEventQueue.size())
+    if ( !multiplayer_manager_utils::compare_sessions(lastSnapshot.lobbySession, m_lobbyClient->session()) ||
+         !multiplayer_manager_utils::compare_sessions(lastSnapshot.gameSession, m_gameClient->session()) ||
+         !multiplayer_manager_utils::compare_sessions(lastSnapshot.matchSession, m_matchClient->session()) ||
+         m_lobbyClient->multiplayer_event_queue().size() > 0 ||
+         m_gameClient->multiplayer_event_queue().size() > 0 ||
+         m_matchClient->multiplayer_event_queue().size() > 0 ||
+         m_multiplayerEventQueue.size() > 0)
     {
         return true;
     }
@@ -200,9 +173,13 @@ multiplayer_client_pending_reader::is_match(
 }
 
 std::vector<multiplayer_event>
-multiplayer_client_pending_reader::multiplayer_event_queue() const
+multiplayer_client_pending_reader::take_multiplayer_event_queue()
 {
-    return m_multiplayerEventQueue;
+    std::vector<multiplayer_event> multiplayerEventQueue;
+
+    std::lock_guard<std::mutex> lock(m_clientRequestLock);
+    multiplayerEventQueue.swap(m_multiplayerEventQueue);
+    return multiplayerEventQueue;
 }
 
 void
@@ -229,13 +206,6 @@ multiplayer_client_pending_reader::add_to_multiplayer_event_queue(
     }
 }
 
-void
-multiplayer_client_pending_reader::clear_multiplayer_event_queue()
-{
-    std::lock_guard<std::mutex> lock(m_clientRequestLock);
-    m_multiplayerEventQueue.clear();
-}
-
 void
 multiplayer_client_pending_reader::do_work()
 {
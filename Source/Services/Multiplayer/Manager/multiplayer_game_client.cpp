@@ -12,7 +12,6 @@ using namespace xbox::services::multiplayer;
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
 
 multiplayer_game_client::multiplayer_game_client() :
-    m_updateNumber(0),
     m_pendingCommitInProgress(false)
 {
     m_sessionWriter = std::make_shared<multiplayer_session_writer>();
@@ -22,7 +21,6 @@ multiplayer_game_client::multiplayer_game_client(
     _In_ std::shared_ptr<multiplayer_local_user_manager> localUserManager
     ) :
     m_multiplayerLocalUserManager(localUserManager),
-    m_updateNumber(0),
     m_pendingCommitInProgress(false)
 {
     m_sessionWriter = std::make_shared<multiplayer_session_writer>(m_multiplayerLocalUserManager);
@@ -74,32 +72,20 @@ multiplayer_game_client::set_game_session_template(
 }
 
 void
-multiplayer_game_client::deep_copy_if_updated(
-    _In_ const multiplayer_game_client& other
+multiplayer_game_client::copy_to_snapshot(
+    _Inout_ multiplayer_client_snapshot& snapshot
     )
 {
-    std::lock_guard<std::mutex> lock(other.m_clientRequestLock);
+    std::lock_guard<std::mutex> lock(m_clientRequestLock);
 
-    if (other.m_sessionWriter->session() == nullptr)
-    {
-        m_sessionWriter->update_session(nullptr);
-        m_multiplayerGame = nullptr;
-    }
-    else if (other.m_multiplayerGame == nullptr)
-    {
-        m_multiplayerGame = nullptr;
-    }
-    else if (m_sessionWriter->session() == nullptr ||
-            other.m_sessionWriter->session()->change_number() > m_sessionWriter->session()->change_number() ||
-            other.m_sessionWriter->session()->e_tag() > m_sessionWriter->session()->e_tag())
-    {
-        m_sessionWriter->update_session(other.m_sessionWriter->session()->_Create_deep_copy());
-        m_multiplayerGame = other.m_multiplayerGame->_Create_deep_copy();
-    }
-    else if (m_updateNumber != other.m_updateNumber)
+    if (m_snapshotGameSource != m_multiplayerGame)
     {
-        m_multiplayerGame = other.m_multiplayerGame->_Create_deep_copy();
+        m_snapshotGameSource = m_multiplayerGame;
+        m_snapshotGame = m_multiplayerGame == nullptr ? nullptr : m_multiplayerGame->_Create_deep_copy();
     }
+
+    snapshot.gameSession = m_sessionWriter->session();
+    snapshot.game = snapshot.gameSession == nullptr ? nullptr : m_snapshotGame;
 }
 
 const std::shared_ptr<multiplayer_session_writer>&
@@ -119,7 +105,6 @@ multiplayer_game_client::update_game(
     _In_ const std::shared_ptr<multiplayer_game_session>& multiplayerGame
     )
 {
-    ++m_updateNumber;
     m_multiplayerGame = multiplayerGame;
 }
 
@@ -14,7 +14,6 @@ const string_t multiplayer_lobby_client::c_joinabilityPropertyName = _T("Joinabi
 
 multiplayer_lobby_client::multiplayer_lobby_client() :
     m_pendingCommitInProgress(false),
-    m_updateNumber(0),
     m_joinability(joinability::none)
 {
     m_sessionWriter = std::make_shared<multiplayer_session_writer>();
@@ -27,7 +26,6 @@ multiplayer_lobby_client::multiplayer_lobby_client(
     m_lobbySessionTemplateName(std::move(lobbySessionTemplateName)),
     m_multiplayerLocalUserManager(localUserManager),
     m_pendingCommitInProgress(false),
-    m_updateNumber(0),
     m_joinability(joinability::none)
 {
     m_sessionWriter = std::make_shared<multiplayer_session_writer>(localUserManager);
@@ -52,33 +50,21 @@ multiplayer_lobby_client::initialize()
     });
 }
 
-void multiplayer_lobby_client::deep_copy_if_updated(
-    _In_ const multiplayer_lobby_client& other
+void multiplayer_lobby_client::copy_to_snapshot(
+    _Inout_ multiplayer_client_snapshot& snapshot
     )
 {
-    std::lock_guard<std::mutex> lock(other.m_clientRequestLock);
+    std::lock_guard<std::mutex> lock(m_clientRequestLock);
 
-    m_joinability = other.m_joinability;
-    if (other.m_sessionWriter->session() == nullptr)
-    {
-        m_sessionWriter->update_session(nullptr);
-        m_multiplayerLobby = nullptr;
-    }
-    else if (other.m_multiplayerLobby == nullptr)
-    {
-        m_multiplayerLobby = nullptr;
-    }
-    else if (m_sessionWriter->session() == nullptr ||
-            other.m_sessionWriter->session()->change_number() > m_sessionWriter->session()->change_number() ||
-            other.m_sessionWriter->session()->e_tag() > m_sessionWriter->session()->e_tag())
-    {
-        m_sessionWriter->update_session(other.m_sessionWriter->session()->_Create_deep_copy());
-        m_multiplayerLobby = other.m_multiplayerLobby->_Create_deep_copy();
-    }
-    else if (m_updateNumber != other.m_updateNumber)
+    if (m_snapshotLobbySource != m_multiplayerLobby)
     {
-        m_multiplayerLobby = other.m_multiplayerLobby->_Create_deep_copy();
+        m_snapshotLobbySource = m_multiplayerLobby;
+        m_snapshotLobby = m_multiplayerLobby == nullptr ? nullptr : m_multiplayerLobby->_Create_deep_copy();
     }
+
+    snapshot.lobbyJoinability = m_joinability;
+    snapshot.lobbySession = m_sessionWriter->session();
+    snapshot.lobby = snapshot.lobbySession == nullptr ? nullptr : m_snapshotLobby;
 }
 
 std::shared_ptr<multiplayer_game_client>
@@ -116,7 +102,6 @@ multiplayer_lobby_client::update_lobby(
     _In_ std::shared_ptr<multiplayer_lobby_session> multiplayerLobby
     )
 {
-    ++m_updateNumber;
     m_multiplayerLobby = multiplayerLobby;
 }
 
@@ -848,7 +833,7 @@ multiplayer_lobby_client::commit_lobby_changes_helper(
                     localUser->lobby_state() == multiplayer_local_user_lobby_state::join)
                 {
                     auto updatedSession = sessionResult.payload();
-                    pThis->update_session(updatedSession);
+                    pThis->update_session(updatedSession);   // published, so only copies of it can be changed from here on
                     auto lobbyState = localUser->lobby_state();
                     localUser->set_lobby_state(multiplayer_local_user_lobby_state::in_session);
 
@@ -866,8 +851,9 @@ multiplayer_lobby_client::commit_lobby_changes_helper(
                     if (lobbyState == multiplayer_local_user_lobby_state::add &&
                         pThis->should_update_host_token(localUser, updatedSession))
                     {
-                        updatedSession->set_host_device_token(updatedSession->current_user()->device_token());
-                        auto writeHostTokenResult = pThis->m_sessionWriter->write_session(localUser->context(), updatedSession, multiplayer_session_write_mode::update_existing).get();
+                        auto sessionToCommitCopy = updatedSession->_Create_deep_copy();
+                        sessionToCommitCopy->set_host_device_token(sessionToCommitCopy->current_user()->device_token());
+                        auto writeHostTokenResult = pThis->m_sessionWriter->write_session(localUser->context(), sessionToCommitCopy, multiplayer_session_write_mode::update_existing).get();
                         if (writeHostTokenResult.err())
                         {
                             return xbox_live_result<std::vector<multiplayer_event>>(writeHostTokenResult.err(), writeHostTokenResult.err_message());
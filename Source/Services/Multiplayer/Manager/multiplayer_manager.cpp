@@ -100,12 +100,12 @@ multiplayer_manager::do_work()
         m_isDirty = true;
         eventQueue = m_multiplayerClientManager->do_work();
 
-        std::shared_ptr<multiplayer_client_pending_reader> clientRequest = m_multiplayerClientManager->last_pending_read();
-        if (clientRequest != nullptr)
+        auto snapshot = m_multiplayerClientManager->last_snapshot();
+        if (snapshot != nullptr)
         {
-            m_joinability = clientRequest->lobby_client()->joinability();
-            set_multiplayer_game_session(clientRequest->game_client()->game());
-            set_multiplayer_lobby_session(clientRequest->lobby_client()->lobby());
+            m_joinability = snapshot->lobbyJoinability;
+            set_multiplayer_game_session(snapshot->game);
+            set_multiplayer_lobby_session(snapshot->lobby);
         }
         else
         {
@@ -59,6 +59,28 @@ enum class pending_request_type
     non_synchronized_changes
 };
 
+/// <summary>
+/// The lobby, game and match state the title saw on its last do_work. Published by multiplayer_client_manager
+/// with an atomic pointer swap and never changed afterwards, so readers share it without a lock or a copy.
+/// The sessions are shared with the pending reader rather than copied, which is safe because the session writer
+/// never changes a session once it holds it. The lobby and game objects are copies, because multiplayer_manager
+/// hands them to the title, which sets their client manager.
+/// </summary>
+struct multiplayer_client_snapshot
+{
+    multiplayer_client_snapshot() :
+        lobbyJoinability(xbox::services::multiplayer::manager::joinability::none)
+    {
+    }
+
+    std::shared_ptr<xbox::services::multiplayer::multiplayer_session> lobbySession;
+    std::shared_ptr<xbox::services::multiplayer::multiplayer_session> gameSession;
+    std::shared_ptr<xbox::services::multiplayer::multiplayer_session> matchSession;
+    std::shared_ptr<multiplayer_lobby_session> lobby;
+    std::shared_ptr<multiplayer_game_session> game;
+    xbox::services::multiplayer::manager::joinability lobbyJoinability;
+};
+
 class multiplayer_client_pending_request 
 {
 public:
@@ -264,7 +286,7 @@ public:
         _In_ std::shared_ptr<multiplayer_local_user_manager> localUserManager
         );
 
-    void deep_copy_if_updated(_In_ const multiplayer_game_client& other);
+    void copy_to_snapshot(_Inout_ multiplayer_client_snapshot& snapshot);
 
     void initialize();
 
@@ -368,10 +390,12 @@ private:
     mutable std::mutex m_clientRequestLock;
     std::atomic<bool> m_pendingCommitInProgress;
     string_t m_gameSessionTemplateName;
-    uint64_t m_updateNumber;
     std::shared_ptr<multiplayer_session_writer> m_sessionWriter;
     std::vector<multiplayer_event> m_multiplayerEventQueue;
     std::shared_ptr<multiplayer_game_session> m_multiplayerGame;
+    // The title's copy of m_multiplayerGame, remade only when m_multiplayerGame is replaced
+    std::shared_ptr<multiplayer_game_session> m_snapshotGameSource;
+    std::shared_ptr<multiplayer_game_session> m_snapshotGame;
     std::shared_ptr<multiplayer_local_user_manager> m_multiplayerLocalUserManager;
     std::queue<std::shared_ptr<multiplayer_client_pending_request>> m_pendingRequestQueue;
     std::vector<std::shared_ptr<multiplayer_client_pending_request>> m_processingQueue;
@@ -389,7 +413,7 @@ public:
         _In_ std::shared_ptr<multiplayer_local_user_manager> localUserManager
         );
 
-    void deep_copy_if_updated(_In_ const multiplayer_lobby_client& other);
+    void copy_to_snapshot(_Inout_ multiplayer_client_snapshot& snapshot);
 
     void initialize();
 
@@ -561,13 +585,15 @@ private:
     string_t m_lobbySessionTemplateName;
     std::atomic<bool> m_pendingCommitInProgress;
 
-    uint64_t m_updateNumber;
     xbox::services::multiplayer::manager::joinability m_joinability;
     mutable std::mutex m_clientRequestLock;
     std::queue<std::shared_ptr<multiplayer_client_pending_request>> m_pendingRequestQueue;
     std::vector<multiplayer_event> m_multiplayerEventQueue;
     std::shared_ptr<multiplayer_session_writer> m_sessionWriter;
     std::shared_ptr<multiplayer_lobby_session> m_multiplayerLobby;
+    // The title's copy of m_multiplayerLobby, remade only when m_multiplayerLobby is replaced
+    std::shared_ptr<multiplayer_lobby_session> m_snapshotLobbySource;
+    std::shared_ptr<multiplayer_lobby_session> m_snapshotLobby;
     std::vector<std::shared_ptr<multiplayer_member>> m_localLobbyMembers;
     std::shared_ptr<multiplayer_local_user_manager> m_multiplayerLocalUserManager;
     std::vector<std::shared_ptr<multiplayer_client_pending_request>> m_processingQueue;
@@ -585,8 +611,8 @@ public:
         _In_ std::shared_ptr<multiplayer_local_user_manager> localUserManager
         );
 
-    void deep_copy_if_updated(_In_ const multiplayer_client_pending_reader& other);
-    bool is_update_avaialable(_In_ const multiplayer_client_pending_reader& other);
+    std::shared_ptr<const multiplayer_client_snapshot> create_snapshot();
+    bool is_update_avaialable(_In_ const multiplayer_client_snapshot& lastSnapshot);
 
     void do_work();
     void process_match_events();
@@ -595,9 +621,9 @@ public:
     std::shared_ptr<multiplayer_game_client> game_client();
     std::shared_ptr<multiplayer_match_client> match_client();
 
-    std::vector<multiplayer_event> multiplayer_event_queue() const;
+    // Removes and returns the queued events
+    std::vector<multiplayer_event> take_multiplayer_event_queue();
 
-    void clear_multiplayer_event_queue();
     void add_to_multiplayer_event_queue(_In_ multiplayer_event multiplayerEvent);
     void add_to_multiplayer_event_queue(_In_ std::vector<multiplayer_event> multiplayerEventQueue);
 
@@ -817,7 +843,8 @@ public:
 
     std::shared_ptr<multiplayer_lobby_client> lobby_client() const;
     std::shared_ptr<multiplayer_client_pending_reader> latest_pending_read() const;
-    std::shared_ptr<multiplayer_client_pending_reader> last_pending_read() const;
+    std::shared_ptr<const multiplayer_client_snapshot> last_snapshot() const;
+    void publish_snapshot();
 
     xbox_live_result<void> join_lobby_by_handle(
         _In_ const string_t& handleId,
@@ -1019,7 +1046,7 @@ private:
     xbox::services::multiplayer::multiplayer_service m_clientManagerMultiplayerService;
     std::shared_ptr<xbox_live_context_impl> m_primaryXboxLiveContext;
     std::shared_ptr<multiplayer_local_user_manager> m_multiplayerLocalUserManager;
-    std::shared_ptr<multiplayer_client_pending_reader> m_lastPendingRead;
+    std::shared_ptr<const multiplayer_client_snapshot> m_lastSnapshot;
     std::shared_ptr<multiplayer_client_pending_reader> m_latestPendingRead;
 };
 
@@ -1032,7 +1059,6 @@ public:
 
     std::vector<multiplayer_event> do_work();
     const std::vector<multiplayer_event>& multiplayer_event_queue();
-    void deep_copy_if_updated(_In_ const multiplayer_match_client& other);
 
     xbox::services::multiplayer::manager::match_status match_status() const;
     void set_match_status(_In_ xbox::services::multiplayer::manager::match_status status);
@@ -32,22 +32,6 @@ multiplayer_match_client::multiplayer_match_client(
     m_getSessionTask = pplx::create_task([]{});
 }
 
-void
-multiplayer_match_client::deep_copy_if_updated(
-    _In_ const multiplayer_match_client& other
-    )
-{
-    std::lock_guard<std::mutex> lock(m_lock.get());
-    if (other.m_matchSession == nullptr)
-    {
-        m_matchSession = nullptr;
-    }
-    else if (m_matchSession == nullptr || other.m_matchSession->change_number() > m_matchSession->change_number())
-    {
-        m_matchSession = other.m_matchSession->_Create_deep_copy();
-    }
-}
-
 const std::vector<multiplayer_event>&
 multiplayer_match_client::multiplayer_event_queue()
 {
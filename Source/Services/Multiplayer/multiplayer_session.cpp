@@ -208,6 +208,8 @@ void multiplayer_session::deep_copy_from(
         m_members.push_back(memberCopy);
     }
 
+    index_members();
+
     m_multiplayerSessionProperties->_Deep_copy(*(other.m_multiplayerSessionProperties));
     m_multiplayerSessionProperties->_Initialize(
         m_sessionRequest,
@@ -846,6 +848,7 @@ multiplayer_session::leave()
         if (member->is_current_user())
         {
             m_members.erase((m_members.begin() + i));
+            index_members();
             break;
         }
     }
@@ -1093,6 +1096,7 @@ multiplayer_session::add_member_reservation_helper(
     member->_Set_member_request(memberRequest);
     member->_Set_session_request(m_sessionRequest);
     m_members.push_back(member);
+    index_members();
 
     return xbox_live_error_code::no_error;
 }
@@ -1143,6 +1147,7 @@ multiplayer_session::join_helper(
     member->_Set_member_request(memberRequest);
     member->_Set_session_request(m_sessionRequest);
     m_members.push_back(member);
+    index_members();
     m_memberCurrentUser = member;
 
     return xbox_live_result<std::shared_ptr<multiplayer_session_member>>(member);
@@ -1406,6 +1411,39 @@ multiplayer_session::_Populate_members_with_members_list(
     return errc;
 }
 
+void
+multiplayer_session::index_members()
+{
+    m_membersByXuid.clear();
+    m_membersByXuid.reserve(m_members.size());
+    for (const auto& member : m_members)
+    {
+        m_membersByXuid.push_back(member.get());
+    }
+
+    std::sort(m_membersByXuid.begin(), m_membersByXuid.end(), [](const multiplayer_session_member* left, const multiplayer_session_member* right)
+    {
+        return compare_member_xuids(left, right) < 0;
+    });
+}
+
+int
+multiplayer_session::compare_member_xuids(
+    _In_ const multiplayer_session_member* left,
+    _In_ const multiplayer_session_member* right
+    )
+{
+    uint64_t leftXuid = left->_Xbox_user_id_number();
+    uint64_t rightXuid = right->_Xbox_user_id_number();
+    if (leftXuid != rightXuid)
+    {
+        return leftXuid < rightXuid ? -1 : 1;
+    }
+
+    // Xuids that are not numbers all parse to 0, only those need the string compare
+    return leftXuid != 0 ? 0 : utils::str_icmp(left->xbox_user_id(), right->xbox_user_id());
+}
+
 xbox_live_result<multiplayer_session_change_types>
 multiplayer_session::compare_multiplayer_sessions(
     _In_ std::shared_ptr<multiplayer_session> currentSession,
@@ -1436,50 +1474,56 @@ multiplayer_session::compare_multiplayer_sessions(
         currentType |= multiplayer_session_change_types::matchmaking_status_change;
     }
 
-    bool hasMemberChanged = false;
+    bool hasMemberChanged = currentSession->m_members.size() != oldSession->m_members.size();
     bool memberStatusChanged = false;
     bool memberCustomPropertyChanged = false;
 
-    if (currentSession->members().size() != oldSession->members().size())
+    // Both member lists are ordered by xuid, so matching members up is a single merge pass
+    const auto& currentMembers = currentSession->m_membersByXuid;
+    const auto& oldMembers = oldSession->m_membersByXuid;
+    size_t currentIndex = 0;
+    size_t oldIndex = 0;
+    while (currentIndex < currentMembers.size() && oldIndex < oldMembers.size())
     {
-        hasMemberChanged = true;
-    }
+        const multiplayer_session_member* currentSessionMember = currentMembers[currentIndex];
+        const multiplayer_session_member* olderSessionMember = oldMembers[oldIndex];
 
-    for (uint32_t i = 0; i < currentSession->members().size(); i++)
-    {
-        std::shared_ptr<multiplayer_session_member> currentSessionMember = currentSession->members()[i];
-        bool isMemberFound = false;
-        for (uint32_t j = 0; j < oldSession->members().size(); j++)
+        int order = compare_member_xuids(currentSessionMember, olderSessionMember);
+        if (order < 0)
         {
-            std::shared_ptr<multiplayer_session_member> olderSessionMember = oldSession->members()[j];
-
-            if (utils::str_icmp(currentSessionMember->xbox_user_id(),
-                olderSessionMember->xbox_user_id()) == 0)
-            {
-                isMemberFound = true;
-
-                if (currentSessionMember->status() != olderSessionMember->status())
-                {
-                    memberStatusChanged = true;
-                }
+            hasMemberChanged = true;
+            ++currentIndex;
+            continue;
+        }
+        else if (order > 0)
+        {
+            hasMemberChanged = true;
+            ++oldIndex;
+            continue;
+        }
 
-                if (utils::str_icmp(currentSessionMember->member_custom_properties_json().serialize(),
-                    olderSessionMember->member_custom_properties_json().serialize()) != 0)
-                {
-                    memberCustomPropertyChanged = true;
-                }
-            }
+        if (currentSessionMember->status() != olderSessionMember->status())
+        {
+            memberStatusChanged = true;
         }
 
-        if (!isMemberFound)
+        if (currentSessionMember->_Member_custom_properties_hash() != olderSessionMember->_Member_custom_properties_hash())
         {
-            hasMemberChanged = true;
+            memberCustomPropertyChanged = true;
         }
 
         if (memberStatusChanged && hasMemberChanged && memberCustomPropertyChanged)
         {
             break;
         }
+
+        ++currentIndex;
+        ++oldIndex;
+    }
+
+    if (currentIndex < currentMembers.size())
+    {
+        hasMemberChanged = true;
     }
 
     if (hasMemberChanged)
@@ -1508,7 +1552,7 @@ multiplayer_session::compare_multiplayer_sessions(
         currentType |= multiplayer_session_change_types::session_joinability_change;
     }
 
-    if (utils::str_icmp(currentSession->session_properties()->session_custom_properties_json().serialize(), oldSession->session_properties()->session_custom_properties_json().serialize()) != 0)
+    if (currentSession->session_properties()->_Session_custom_properties_hash() != oldSession->session_properties()->_Session_custom_properties_hash())
     {
         currentType |= multiplayer_session_change_types::custom_property_change;
     }
@@ -1588,6 +1632,7 @@ multiplayer_session::_Deserialize(
     }
 
     _Populate_members_with_members_list(returnResult.m_members);
+    returnResult.index_members();
 
     auto multiplayerSessionProperties = multiplayer_session_properties::_Deserialize(
         utils::extract_json_field(
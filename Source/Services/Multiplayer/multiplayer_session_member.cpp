@@ -28,8 +28,10 @@ void multiplayer_session_member::deep_copy_from(
     m_memberId = other.m_memberId;
     m_customConstantsJson = other.m_customConstantsJson;
     m_customPropertiesJson = other.m_customPropertiesJson;
+    m_customPropertiesHash = other.m_customPropertiesHash;
     m_gamertag = other.m_gamertag;
     m_xboxUserId = other.m_xboxUserId;
+    m_xboxUserIdNumber = other.m_xboxUserIdNumber;
     m_isCurrentUser = other.m_isCurrentUser;
     m_isTurnAvailable = other.m_isTurnAvailable;
     m_isReserved = other.m_isReserved;
@@ -64,6 +66,7 @@ void multiplayer_session_member::deep_copy_from(
 
 multiplayer_session_member::multiplayer_session_member() :
     m_memberId(0),
+    m_xboxUserIdNumber(0),
     m_isCurrentUser(false),
     m_isTurnAvailable(false),
     m_isReserved(false),
@@ -80,6 +83,7 @@ multiplayer_session_member::multiplayer_session_member() :
     m_matchmakingResultServerMeasurementsJson = web::json::value::object();
     m_customConstantsJson = web::json::value::object();
     m_customPropertiesJson = web::json::value::object();
+    m_customPropertiesHash = utils::hash_json(m_customPropertiesJson);
     m_memberMeasurements = std::make_shared<std::vector<multiplayer_quality_of_service_measurements>>();
 }
 
@@ -108,6 +112,8 @@ multiplayer_session_member::multiplayer_session_member(
     m_matchmakingResultServerMeasurementsJson = web::json::value::object();
     m_customConstantsJson = web::json::value::object();
     m_customPropertiesJson = web::json::value::object();
+    m_customPropertiesHash = utils::hash_json(m_customPropertiesJson);
+    m_xboxUserIdNumber = utils::string_t_to_uint64(m_xboxUserId);
     m_memberMeasurements = std::make_shared<std::vector<multiplayer_quality_of_service_measurements>>();
 }
 
@@ -195,6 +201,18 @@ multiplayer_session_member::member_custom_properties_json() const
     return m_customPropertiesJson;
 }
 
+uint64_t
+multiplayer_session_member::_Xbox_user_id_number() const
+{
+    return m_xboxUserIdNumber;
+}
+
+uint64_t
+multiplayer_session_member::_Member_custom_properties_hash() const
+{
+    return m_customPropertiesHash;
+}
+
 const string_t&
 multiplayer_session_member::gamertag() const
 {
@@ -709,8 +727,10 @@ multiplayer_session_member::_Deserialize(
     
     returnResult.m_isReserved = utils::extract_json_bool(json, _T("reserved"), errc);
     returnResult.m_xboxUserId = utils::extract_json_string(constantsSystemJson, _T("xuid"), errc);
+    returnResult.m_xboxUserIdNumber = utils::string_t_to_uint64(returnResult.m_xboxUserId);
     returnResult.m_initialize = utils::extract_json_bool(constantsSystemJson, _T("initialize"), errc);
     returnResult.m_customPropertiesJson = utils::extract_json_field(propertiesJson, _T("custom"), errc, false);
+    returnResult.m_customPropertiesHash = utils::hash_json(returnResult.m_customPropertiesJson);
     returnResult.m_customConstantsJson = utils::extract_json_field(constantsJson, _T("custom"), errc, false);
     returnResult.m_teamId = utils::extract_json_string(constantsSystemJson, _T("team"), errc);
     returnResult.m_arbitrationStatus = multiplayer_service::_Convert_string_to_arbitration_status(utils::extract_json_string(constantsSystemJson, _T("arbitrationStatus"), errc));
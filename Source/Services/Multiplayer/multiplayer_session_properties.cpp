@@ -18,6 +18,7 @@ multiplayer_session_properties::multiplayer_session_properties() :
 {
     m_matchmakingTargetSessionConstants = web::json::value::object();
     m_customPropertiesJson = web::json::value::object();
+    m_customPropertiesHash = utils::hash_json(m_customPropertiesJson);
     m_sessionRequest = std::make_shared<multiplayer_session_request>();
 }
 
@@ -26,6 +27,7 @@ multiplayer_session_properties& multiplayer_session_properties::_Deep_copy(
     )
 {
     m_customPropertiesJson = other.m_customPropertiesJson;
+    m_customPropertiesHash = other.m_customPropertiesHash;
     m_keywords = other.m_keywords;
     m_sessionOwnerIndices = other.m_sessionOwnerIndices;
     m_turnCollection = other.m_turnCollection;
@@ -130,6 +132,12 @@ multiplayer_session_properties::session_custom_properties_json() const
     return m_customPropertiesJson;
 }
 
+uint64_t
+multiplayer_session_properties::_Session_custom_properties_hash() const
+{
+    return m_customPropertiesHash;
+}
+
 const string_t& 
 multiplayer_session_properties::matchmaking_server_connection_string() const
 {
@@ -326,6 +334,7 @@ multiplayer_session_properties::_Deserialize(
 
     returnResult.m_matchmakingTargetSessionConstants = utils::extract_json_field(systemMatchmakingJson, _T("targetSessionConstants"), errc, false);
     returnResult.m_customPropertiesJson = utils::extract_json_field(json, _T("custom"), errc, false);
+    returnResult.m_customPropertiesHash = utils::hash_json(returnResult.m_customPropertiesJson);
     
     returnResult.m_host = utils::extract_json_string(systemJson, _T("host"), errc);
     returnResult.m_serverConnectionString = utils::extract_json_string(systemMatchmakingJson, _T("serverConnectionString"), errc);
@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "xsapi/presence.h"
+#include "real_time_activity_internal.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_PRESENCE_CPP_BEGIN
 
@@ -91,37 +92,9 @@ device_presence_change_subscription::on_event_received(
 {
     std::error_code errc;
     auto dataAsString = utils::extract_json_as_string(data, errc);
-    xbox_live_result<device_presence_change_event_args> eventArgs;
     if (!errc)
     {
-        std::vector<string_t> devicePresenceValues = utils::string_split(dataAsString, ':');
-
-        if (devicePresenceValues.size() != 2)
-        {
-            if (m_subscriptionErrorHandler != nullptr)
-            {
-                m_subscriptionErrorHandler(
-                    xbox::services::real_time_activity::real_time_activity_subscription_error_event_args(
-                        *this,
-                        xbox_live_error_code::json_error,
-                        "JSON deserialization failed"
-                        )
-                    );
-            }
-            
-            return;
-        }
-
-        if (m_devicePresenceChangeHandler != nullptr)
-        {
-            m_devicePresenceChangeHandler(
-                device_presence_change_event_args(
-                    m_xboxUserId,
-                    presence_device_record::_Convert_string_to_presence_device_type(devicePresenceValues[0]),
-                    utils::str_icmp(devicePresenceValues[1], _T("true")) == 0
-                    )
-                );
-        }
+        on_device_presence_received(dataAsString);
     }
     else
     {
@@ -145,4 +118,57 @@ device_presence_change_subscription::xbox_user_id() const
     return m_xboxUserId;
 }
 
-NAMESPACE_MICROSOFT_XBOX_SERVICES_PRESENCE_CPP_END
\ No newline at end of file
+void
+device_presence_change_subscription::_On_event_received(
+    _In_ const char_t* payload,
+    _In_ size_t payloadLength
+    )
+{
+    // Device presence arrives as a plain "<device type>:<is logged on>" string, which needs no DOM
+    string_t devicePresence;
+    if (xbox::services::real_time_activity::real_time_activity_frame::try_decode_string(payload, payloadLength, devicePresence))
+    {
+        on_device_presence_received(devicePresence);
+    }
+    else
+    {
+        real_time_activity_subscription::_On_event_received(payload, payloadLength);
+    }
+}
+
+void
+device_presence_change_subscription::on_device_presence_received(
+    _In_ const string_t& devicePresence
+    )
+{
+    std::vector<string_t> devicePresenceValues = utils::string_split(devicePresence, ':');
+
+    if (devicePresenceValues.size() != 2)
+    {
+        if (m_subscriptionErrorHandler != nullptr)
+        {
+            m_subscriptionErrorHandler(
+                xbox::services::real_time_activity::real_time_activity_subscription_error_event_args(
+                    *this,
+                    xbox_live_error_code::json_error,
+                    "JSON deserialization failed"
+                    )
+                );
+        }
+
+        return;
+    }
+
+    if (m_devicePresenceChangeHandler != nullptr)
+    {
+        m_devicePresenceChangeHandler(
+            device_presence_change_event_args(
+                m_xboxUserId,
+                presence_device_record::_Convert_string_to_presence_device_type(devicePresenceValues[0]),
+                utils::str_icmp(devicePresenceValues[1], _T("true")) == 0
+                )
+            );
+    }
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_PRESENCE_CPP_END
@@ -144,7 +144,8 @@ public:
 
     xbox_live_result<std::shared_ptr<title_presence_change_subscription>> subscribe_to_title_presence_change(
         _In_ const string_t& xboxUserId,
-        _In_ uint32_t titleId
+        _In_ uint32_t titleId,
+        _In_ xbox::services::real_time_activity::real_time_activity_subscription_priority priority = xbox::services::real_time_activity::real_time_activity_subscription_priority::normal
         );
 
     xbox_live_result<void> unsubscribe_from_title_presence_change(
@@ -156,7 +157,8 @@ public:
     void remove_title_presence_changed_handler(_In_ function_context context);
 
     xbox_live_result<std::shared_ptr<device_presence_change_subscription>> subscribe_to_device_presence_change(
-        _In_ const string_t& xboxUserId
+        _In_ const string_t& xboxUserId,
+        _In_ xbox::services::real_time_activity::real_time_activity_subscription_priority priority = xbox::services::real_time_activity::real_time_activity_subscription_priority::normal
         );
 
     xbox_live_result<void> unsubscribe_from_device_presence_change(
@@ -232,7 +232,8 @@ presence_service_impl::title_presence_changed(
 
 xbox_live_result<std::shared_ptr<device_presence_change_subscription>>
 presence_service_impl::subscribe_to_device_presence_change(
-    _In_ const string_t& xboxUserId
+    _In_ const string_t& xboxUserId,
+    _In_ xbox::services::real_time_activity::real_time_activity_subscription_priority priority
     )
 {
     std::weak_ptr<presence_service_impl> thisWeakPtr = shared_from_this();
@@ -258,6 +259,8 @@ presence_service_impl::subscribe_to_device_presence_change(
         })
         );
 
+    // Set before the subscription is queued so it is sent in priority order
+    deviceSub->set_priority(priority);
     auto subscriptionSucceded = m_realTimeActivityService->_Add_subscription(
         deviceSub
         );
@@ -283,7 +286,8 @@ presence_service_impl::unsubscribe_from_device_presence_change(
 xbox_live_result<std::shared_ptr<title_presence_change_subscription>>
 presence_service_impl::subscribe_to_title_presence_change(
     _In_ const string_t& xboxUserId,
-    _In_ uint32_t titleId
+    _In_ uint32_t titleId,
+    _In_ xbox::services::real_time_activity::real_time_activity_subscription_priority priority
     )
 {
     std::weak_ptr<presence_service_impl> thisWeakPtr = shared_from_this();
@@ -310,6 +314,7 @@ presence_service_impl::subscribe_to_title_presence_change(
         })
         );
 
+    titleSub->set_priority(priority);
     auto subscriptionSucceded = m_realTimeActivityService->_Add_subscription(
         titleSub
         );
@@ -4,6 +4,7 @@
 #pragma once
 #include "pch.h"
 #include "xsapi/presence.h"
+#include "real_time_activity_internal.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_PRESENCE_CPP_BEGIN
 
@@ -118,19 +119,7 @@ title_presence_change_subscription::on_event_received(
         std::error_code errc;
         auto titlePresenceValue = utils::extract_json_as_string(data, errc);
 
-        title_presence_state titlePresenceState = title_presence_state::unknown;
-        if (!errc)
-        {
-            if (utils::str_icmp(titlePresenceValue, _T("started")) == 0)
-            {
-                titlePresenceState = title_presence_state::started;
-            }
-            else if (utils::str_icmp(titlePresenceValue, _T("ended")) == 0)
-            {
-                titlePresenceState = title_presence_state::ended;
-            }
-        }
-        else
+        if (errc)
         {
             if(m_subscriptionErrorHandler != nullptr)
             {
@@ -146,16 +135,55 @@ title_presence_change_subscription::on_event_received(
             return;
         }
 
-        auto presenceEventArgs = title_presence_change_event_args(
-            m_xboxUserId,
-            m_titleId,
-            std::move(titlePresenceState)
-            );
+        on_title_presence_received(titlePresenceValue);
+    }
+}
 
-        m_handler(presenceEventArgs);
+void
+title_presence_change_subscription::_On_event_received(
+    _In_ const char_t* payload,
+    _In_ size_t payloadLength
+    )
+{
+    // Title presence arrives as a plain "started" or "ended" string, which needs no DOM
+    string_t titlePresence;
+    if (xbox::services::real_time_activity::real_time_activity_frame::try_decode_string(payload, payloadLength, titlePresence))
+    {
+        if (m_handler)
+        {
+            on_title_presence_received(titlePresence);
+        }
+    }
+    else
+    {
+        real_time_activity_subscription::_On_event_received(payload, payloadLength);
     }
 }
 
+void
+title_presence_change_subscription::on_title_presence_received(
+    _In_ const string_t& titlePresence
+    )
+{
+    title_presence_state titlePresenceState = title_presence_state::unknown;
+    if (utils::str_icmp(titlePresence, _T("started")) == 0)
+    {
+        titlePresenceState = title_presence_state::started;
+    }
+    else if (utils::str_icmp(titlePresence, _T("ended")) == 0)
+    {
+        titlePresenceState = title_presence_state::ended;
+    }
+
+    auto presenceEventArgs = title_presence_change_event_args(
+        m_xboxUserId,
+        m_titleId,
+        std::move(titlePresenceState)
+        );
+
+    m_handler(presenceEventArgs);
+}
+
 const string_t&
 title_presence_change_subscription::xbox_user_id() const
 {
@@ -0,0 +1,313 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "xsapi/real_time_activity.h"
+#include "real_time_activity_internal.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_BEGIN
+
+real_time_activity_frame::real_time_activity_frame() :
+    m_data(nullptr),
+    m_length(0),
+    m_elementCount(0)
+{
+}
+
+bool
+real_time_activity_frame::decode(
+    _In_ const string_t& message
+    )
+{
+    m_data = message.c_str();
+    m_length = message.size();
+    m_elementCount = 0;
+
+    size_t position = skip_whitespace(0);
+    if (position >= m_length || m_data[position] != _T('['))
+    {
+        return false;
+    }
+
+    position = skip_whitespace(position + 1);
+    if (position < m_length && m_data[position] == _T(']'))
+    {
+        return true;
+    }
+
+    while (position < m_length)
+    {
+        size_t start = position;
+        if (!skip_value(position))
+        {
+            return false;
+        }
+
+        // Frames never have more elements than this, anything past it is checked for shape and skipped
+        if (m_elementCount < MAX_ELEMENTS)
+        {
+            m_elements[m_elementCount].offset = start;
+            m_elements[m_elementCount].length = position - start;
+            ++m_elementCount;
+        }
+
+        position = skip_whitespace(position);
+        if (position >= m_length)
+        {
+            return false;
+        }
+        else if (m_data[position] == _T(']'))
+        {
+            return true;
+        }
+        else if (m_data[position] != _T(','))
+        {
+            return false;
+        }
+
+        position = skip_whitespace(position + 1);
+    }
+
+    return false;
+}
+
+size_t
+real_time_activity_frame::element_count() const
+{
+    return m_elementCount;
+}
+
+bool
+real_time_activity_frame::try_get_integer(
+    _In_ size_t index,
+    _Out_ int32_t& value
+    ) const
+{
+    value = 0;
+    if (index >= m_elementCount)
+    {
+        return false;
+    }
+
+    const char_t* data = m_data + m_elements[index].offset;
+    size_t length = m_elements[index].length;
+    size_t position = 0;
+    bool isNegative = false;
+    if (length > 0 && data[0] == _T('-'))
+    {
+        isNegative = true;
+        ++position;
+    }
+
+    if (position >= length)
+    {
+        return false;
+    }
+
+    int64_t result = 0;
+    for (; position < length; ++position)
+    {
+        if (data[position] < _T('0') || data[position] > _T('9'))
+        {
+            return false;
+        }
+
+        result = result * 10 + (data[position] - _T('0'));
+        if (result > static_cast<int64_t>(INT32_MAX) + 1)
+        {
+            return false;
+        }
+    }
+
+    result = isNegative ? -result : result;
+    if (result > INT32_MAX || result < INT32_MIN)
+    {
+        return false;
+    }
+
+    value = static_cast<int32_t>(result);
+    return true;
+}
+
+const char_t*
+real_time_activity_frame::element_data(
+    _In_ size_t index
+    ) const
+{
+    return index < m_elementCount ? m_data + m_elements[index].offset : nullptr;
+}
+
+size_t
+real_time_activity_frame::element_length(
+    _In_ size_t index
+    ) const
+{
+    return index < m_elementCount ? m_elements[index].length : 0;
+}
+
+web::json::value
+real_time_activity_frame::element_json(
+    _In_ size_t index
+    ) const
+{
+    if (index >= m_elementCount)
+    {
+        return web::json::value::null();
+    }
+
+    return web::json::value::parse(string_t(element_data(index), element_length(index)));
+}
+
+bool
+real_time_activity_frame::try_decode_string(
+    _In_ const char_t* json,
+    _In_ size_t length,
+    _Out_ string_t& value
+    )
+{
+    value.clear();
+    if (json == nullptr || length < 2 || json[0] != _T('"') || json[length - 1] != _T('"'))
+    {
+        return false;
+    }
+
+    value.reserve(length - 2);
+    for (size_t position = 1; position < length - 1; ++position)
+    {
+        char_t c = json[position];
+        if (c == _T('"'))
+        {
+            // An unescaped quote ends the string early, so this is not a single string
+            return false;
+        }
+        else if (c != _T('\\'))
+        {
+            value.push_back(c);
+            continue;
+        }
+
+        if (++position >= length - 1)
+        {
+            return false;
+        }
+
+        switch (json[position])
+        {
+        case _T('"'): value.push_back(_T('"')); break;
+        case _T('\\'): value.push_back(_T('\\')); break;
+        case _T('/'): value.push_back(_T('/')); break;
+        case _T('b'): value.push_back(_T('\b')); break;
+        case _T('f'): value.push_back(_T('\f')); break;
+        case _T('n'): value.push_back(_T('\n')); break;
+        case _T('r'): value.push_back(_T('\r')); break;
+        case _T('t'): value.push_back(_T('\t')); break;
+        default: return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+real_time_activity_frame::skip_value(
+    _Inout_ size_t& position
+    ) const
+{
+    if (position >= m_length)
+    {
+        return false;
+    }
+
+    char_t c = m_data[position];
+    if (c == _T('"'))
+    {
+        return skip_string(position);
+    }
+
+    if (c == _T('[') || c == _T('{'))
+    {
+        // Only the nesting depth is tracked, the subscription that parses the payload will validate it
+        uint32_t depth = 0;
+        while (position < m_length)
+        {
+            c = m_data[position];
+            if (c == _T('"'))
+            {
+                if (!skip_string(position))
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            if (c == _T('[') || c == _T('{'))
+            {
+                ++depth;
+            }
+            else if (c == _T(']') || c == _T('}'))
+            {
+                if (--depth == 0)
+                {
+                    ++position;
+                    return true;
+                }
+            }
+
+            ++position;
+        }
+
+        return false;
+    }
+
+    // Numbers, true, false and null run until the next separator
+    size_t start = position;
+    while (position < m_length)
+    {
+        c = m_data[position];
+        if (c == _T(',') || c == _T(']') || c == _T('}') || c == _T(' ') || c == _T('\t') || c == _T('\r') || c == _T('\n'))
+        {
+            break;
+        }
+        ++position;
+    }
+
+    return position > start;
+}
+
+bool
+real_time_activity_frame::skip_string(
+    _Inout_ size_t& position
+    ) const
+{
+    // position is on the opening quote
+    for (++position; position < m_length; ++position)
+    {
+        if (m_data[position] == _T('\\'))
+        {
+            ++position;
+        }
+        else if (m_data[position] == _T('"'))
+        {
+            ++position;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t
+real_time_activity_frame::skip_whitespace(
+    _In_ size_t position
+    ) const
+{
+    while (position < m_length &&
+        (m_data[position] == _T(' ') || m_data[position] == _T('\t') || m_data[position] == _T('\r') || m_data[position] == _T('\n')))
+    {
+        ++position;
+    }
+
+    return position;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_END
@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #pragma once
+#include <deque>
 
 namespace xbox { namespace services { namespace real_time_activity {
 
@@ -34,4 +35,185 @@ private:
     std::unordered_map <string_t, real_time_activity_service_factory_counter> m_xuidToRTAMap;
 };
 
-}}}
\ No newline at end of file
+/// <summary>
+/// An RTA websocket frame such as [<API_ID>, <SUB_ID>, <DATA>], decoded in place. Decoding only finds where each
+/// top level element starts and ends in the frame text, without building a JSON document or allocating, so that
+/// payloads are parsed later and only by the subscriptions that need them.
+/// </summary>
+class real_time_activity_frame
+{
+public:
+    // The longest RTA frame is a subscribe response: [<API_ID>, <SEQUENCE_N>, <CODE_N>, <SUB_ID>, <DATA>]
+    static const size_t MAX_ELEMENTS = 5;
+
+    real_time_activity_frame();
+
+    /// <summary>
+    /// Locates the elements of a frame. The frame refers into message, which must outlive it.
+    /// Returns false if the message is not a JSON array.
+    /// </summary>
+    bool decode(_In_ const string_t& message);
+
+    size_t element_count() const;
+
+    /// <summary>
+    /// Reads an element that holds a 32 bit integer. Returns false if it is missing or is not one.
+    /// </summary>
+    bool try_get_integer(
+        _In_ size_t index,
+        _Out_ int32_t& value
+        ) const;
+
+    /// <summary>
+    /// The JSON text of an element, or nullptr if it is missing
+    /// </summary>
+    const char_t* element_data(_In_ size_t index) const;
+
+    size_t element_length(_In_ size_t index) const;
+
+    /// <summary>
+    /// Parses an element into a JSON value, or returns null if it is missing
+    /// </summary>
+    web::json::value element_json(_In_ size_t index) const;
+
+    /// <summary>
+    /// Decodes JSON text holding a single string. Returns false for anything else, and for strings with \u escapes,
+    /// which callers leave to the full JSON parser.
+    /// </summary>
+    static bool try_decode_string(
+        _In_ const char_t* json,
+        _In_ size_t length,
+        _Out_ string_t& value
+        );
+
+private:
+    bool skip_value(_Inout_ size_t& position) const;
+    bool skip_string(_Inout_ size_t& position) const;
+    size_t skip_whitespace(_In_ size_t position) const;
+
+    struct element
+    {
+        size_t offset;
+        size_t length;
+    };
+
+    const char_t* m_data;
+    size_t m_length;
+    element m_elements[MAX_ELEMENTS];
+    size_t m_elementCount;
+};
+
+/// <summary>
+/// Routes change events to subscriptions by subscription id without taking the service lock.
+/// Ids are spread over shards that each publish an immutable map. Readers load the current map and look up
+/// in it without locking. Writers copy one shard, change it and publish the copy, so churn on one shard never
+/// blocks dispatch and only costs a copy of a fraction of the table.
+/// </summary>
+class real_time_activity_routing_table
+{
+public:
+    real_time_activity_routing_table();
+
+    std::shared_ptr<real_time_activity_subscription> find(_In_ uint32_t subscriptionId) const;
+
+    void insert(
+        _In_ uint32_t subscriptionId,
+        _In_ std::shared_ptr<real_time_activity_subscription> subscription
+        );
+
+    void erase(_In_ uint32_t subscriptionId);
+
+    void clear();
+
+private:
+    typedef std::unordered_map<uint32_t, std::shared_ptr<real_time_activity_subscription>> route_map;
+
+    static const size_t SHARD_COUNT = 16;
+
+    struct shard
+    {
+        std::mutex writeLock;
+        std::shared_ptr<const route_map> routes;
+    };
+
+    shard& shard_for(_In_ uint32_t subscriptionId) const;
+
+    mutable shard m_shards[SHARD_COUNT];
+};
+
+struct real_time_activity_submission_stats
+{
+    real_time_activity_submission_stats() :
+        sentCount(0),
+        queueLength(0),
+        inFlightCount(0),
+        windowSize(0),
+        resubscribeCount(0),
+        lastResubscribeLatency(0)
+    {
+    }
+
+    uint64_t sentCount;
+    uint32_t queueLength;
+    uint32_t inFlightCount;
+    uint32_t windowSize;
+    // Reconnects after which every queued subscription got a response, and how long the last one took
+    uint32_t resubscribeCount;
+    std::chrono::milliseconds lastResubscribeLatency;
+};
+
+/// <summary>
+/// Subscriptions waiting to be sent to RTA, highest priority first and in the order they were queued within a
+/// priority. The service only sends as many as fit in the in-flight window and sends more as responses arrive,
+/// so resubscribing thousands of subscriptions after a reconnect never floods the socket and the subscriptions
+/// the title cares about are answered first. Not thread safe, the service guards it with its own lock.
+/// </summary>
+class real_time_activity_submission_queue
+{
+public:
+    static const uint32_t DEFAULT_WINDOW_SIZE = 64;
+
+    real_time_activity_submission_queue();
+
+    void push(_In_ std::shared_ptr<real_time_activity_subscription> subscription);
+
+    std::shared_ptr<real_time_activity_subscription> pop();
+
+    bool remove(_In_ const string_t& subscriptionGuid);
+
+    std::vector<std::shared_ptr<real_time_activity_subscription>> remove_all();
+
+    size_t size() const;
+
+    bool empty() const;
+
+    uint32_t window_size() const;
+
+    void set_window_size(_In_ uint32_t windowSize);
+
+    void on_sent();
+
+    /// <summary>
+    /// Starts timing how long it takes until the queue and the in-flight window are both empty again.
+    /// </summary>
+    void start_resubscribe();
+
+    void cancel_resubscribe();
+
+    void on_response_received(_In_ size_t inFlightCount);
+
+    real_time_activity_submission_stats stats(_In_ size_t inFlightCount) const;
+
+private:
+    static const size_t PRIORITY_COUNT = 3;
+
+    std::deque<std::shared_ptr<real_time_activity_subscription>> m_queues[PRIORITY_COUNT];
+    uint32_t m_windowSize;
+    uint64_t m_sentCount;
+    bool m_isResubscribing;
+    chrono_clock_t::time_point m_resubscribeStartTime;
+    uint32_t m_resubscribeCount;
+    std::chrono::milliseconds m_lastResubscribeLatency;
+};
+
+}}}
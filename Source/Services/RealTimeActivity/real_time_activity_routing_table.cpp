@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "xsapi/real_time_activity.h"
+#include "real_time_activity_internal.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_BEGIN
+
+real_time_activity_routing_table::real_time_activity_routing_table()
+{
+    for (auto& shard : m_shards)
+    {
+        shard.routes = std::make_shared<const route_map>();
+    }
+}
+
+std::shared_ptr<real_time_activity_subscription>
+real_time_activity_routing_table::find(
+    _In_ uint32_t subscriptionId
+    ) const
+{
+    std::shared_ptr<const route_map> routes = std::atomic_load(&shard_for(subscriptionId).routes);
+
+    auto iter = routes->find(subscriptionId);
+    return iter == routes->end() ? nullptr : iter->second;
+}
+
+void
+real_time_activity_routing_table::insert(
+    _In_ uint32_t subscriptionId,
+    _In_ std::shared_ptr<real_time_activity_subscription> subscription
+    )
+{
+    auto& shard = shard_for(subscriptionId);
+    std::lock_guard<std::mutex> lock(shard.writeLock);
+
+    auto routes = std::make_shared<route_map>(*shard.routes);
+    (*routes)[subscriptionId] = std::move(subscription);
+    std::atomic_store(&shard.routes, std::shared_ptr<const route_map>(routes));
+}
+
+void
+real_time_activity_routing_table::erase(
+    _In_ uint32_t subscriptionId
+    )
+{
+    auto& shard = shard_for(subscriptionId);
+    std::lock_guard<std::mutex> lock(shard.writeLock);
+
+    if (shard.routes->find(subscriptionId) == shard.routes->end())
+    {
+        return;
+    }
+
+    auto routes = std::make_shared<route_map>(*shard.routes);
+    routes->erase(subscriptionId);
+    std::atomic_store(&shard.routes, std::shared_ptr<const route_map>(routes));
+}
+
+void
+real_time_activity_routing_table::clear()
+{
+    for (auto& shard : m_shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.writeLock);
+        std::atomic_store(&shard.routes, std::make_shared<const route_map>());
+    }
+}
+
+real_time_activity_routing_table::shard&
+real_time_activity_routing_table::shard_for(
+    _In_ uint32_t subscriptionId
+    ) const
+{
+    // The service hands out ids sequentially, so the low bits spread them evenly
+    return m_shards[subscriptionId % SHARD_COUNT];
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_END
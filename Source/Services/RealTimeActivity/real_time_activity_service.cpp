@@ -10,10 +10,20 @@
 #include "web_socket_connection_state.h"
 #include "web_socket_client.h"
 #include "utils.h"
+#include "real_time_activity_internal.h"
+#if !XSAPI_U
+#include "ppltasks_extra.h"
+#else
+#include "ppltasks_extra_unix.h"
+#endif
 using namespace pplx;
+using namespace Concurrency::extras;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_BEGIN
 
+static const std::chrono::milliseconds RESUBMIT_BASE_INTERVAL(100);
+static const std::chrono::milliseconds RESUBMIT_MAX_INTERVAL(30 * 1000);
+
 real_time_activity_service::real_time_activity_service(
     _In_ std::shared_ptr<xbox::services::user_context> userContext,
     _In_ std::shared_ptr<xbox::services::xbox_live_context_settings> xboxLiveContextSettings,
@@ -26,7 +36,11 @@ real_time_activity_service::real_time_activity_service(
     m_subscriptionErrorHandlerCounter(0),
     m_connectionStateChangeHandlerCounter(0),
     m_resyncHandlerCounter(0),
-    m_connectionState(real_time_activity_connection_state::disconnected)
+    m_connectionState(real_time_activity_connection_state::disconnected),
+    m_routingTable(std::make_shared<real_time_activity_routing_table>()),
+    m_pendingSubmission(std::make_shared<real_time_activity_submission_queue>()),
+    m_resubmitInterval(0),
+    m_isResubmitScheduled(false)
 {
 }
 
@@ -354,6 +368,7 @@ void real_time_activity_service::clear_all_subscriptions()
         subscription->_Set_state(real_time_activity_subscription_state::closed);
     }
     m_subscriptions.clear();
+    m_routingTable->clear();
 
     for (auto& subscriptionPair : m_pendingUnsubscriptions)
     {
@@ -362,11 +377,11 @@ void real_time_activity_service::clear_all_subscriptions()
     }
     m_pendingUnsubscriptions.clear();
 
-    for (auto& subscription : m_pendingSubmission)
+    for (auto& subscription : m_pendingSubmission->remove_all())
     {
         subscription->_Set_state(real_time_activity_subscription_state::closed);
     }
-    m_pendingSubmission.clear();
+    m_pendingSubmission->cancel_resubscribe();
 }
 
 void
@@ -397,15 +412,16 @@ real_time_activity_service::on_socket_connection_state_change(
             {
                 auto subscription = subscriptionPair.second;
                 subscription->_Set_state(real_time_activity_subscription_state::pending_subscribe);
-                m_pendingSubmission.push_back(subscription);
+                m_pendingSubmission->push(subscription);
             }
             m_subscriptions.clear();
+            m_routingTable->clear();
 
             for (auto& subscriptionPair : m_pendingResponseSubscriptions)
             {
                 auto subscription = subscriptionPair.second;
                 subscription->_Set_state(real_time_activity_subscription_state::pending_subscribe);
-                m_pendingSubmission.push_back(subscription);
+                m_pendingSubmission->push(subscription);
             }
             m_pendingResponseSubscriptions.clear();
 
@@ -424,6 +440,8 @@ real_time_activity_service::on_socket_connection_state_change(
         if (newState == web_socket_connection_state::connected)
         {
             m_connectionState = real_time_activity_connection_state::connected;
+            m_resubmitInterval = std::chrono::milliseconds(0);
+            m_pendingSubmission->start_resubscribe();
             submit_subscriptions();
             trigger_connection_state_changed_event(real_time_activity_connection_state::connected);
         }
@@ -462,19 +480,26 @@ real_time_activity_service::on_socket_message_received(
     _In_ const string_t& message
     )
 {
-    auto msgJson = web::json::value::parse(message);
-    real_time_activity_message_type messageType = static_cast<real_time_activity_message_type>(msgJson[0].as_integer());
+    // Only the envelope is decoded here, payloads stay as text until a subscription asks for them
+    real_time_activity_frame frame;
+    int32_t messageTypeValue = 0;
+    if (!frame.decode(message) || !frame.try_get_integer(0, messageTypeValue))
+    {
+        throw std::runtime_error("Unexpected websocket message");
+    }
+
+    real_time_activity_message_type messageType = static_cast<real_time_activity_message_type>(messageTypeValue);
 
     switch (messageType)
     {
     case real_time_activity_message_type::subscribe:
-        complete_subscribe(msgJson);
+        complete_subscribe(frame);
         break;
     case real_time_activity_message_type::unsubscribe:
-        complete_unsubscribe(msgJson);
+        complete_unsubscribe(frame);
         break;
     case real_time_activity_message_type::change_event:
-        handle_change_event(msgJson);
+        handle_change_event(frame);
         break;
     case real_time_activity_message_type::resync:
         trigger_resync_event();
@@ -487,39 +512,41 @@ real_time_activity_service::on_socket_message_received(
 
 void
 real_time_activity_service::handle_change_event(
-    _In_ web::json::value& message
+    _In_ const real_time_activity_frame& frame
     )
 {
     // response format:
     //[<API_ID>, <SUB_ID>, <DATA>]
-    int subscriptionId = message[1].as_integer();
-    const auto& data = message[2];
-
-    std::shared_ptr<real_time_activity_subscription> subscription;
+    int32_t subscriptionId = 0;
+    if (!frame.try_get_integer(1, subscriptionId))
     {
-        std::lock_guard<std::recursive_mutex> lock(m_lock);
-        auto iter = m_subscriptions.find(subscriptionId);
-        if (iter != m_subscriptions.end())
-        {
-            subscription = iter->second;
-        }
+        LOG_ERROR("RTA change event has no subscription id");
+        return;
     }
 
+    // Dispatch never takes m_lock, so it does not wait behind subscription churn or connection state changes
+    auto subscription = m_routingTable->find(subscriptionId);
     if (subscription != nullptr)
     {
-        subscription->on_event_received(data);
+        subscription->_On_event_received(frame.element_data(2), frame.element_length(2));
     }
 }
 
 void
 real_time_activity_service::complete_subscribe(
-    _In_ web::json::value& message
+    _In_ const real_time_activity_frame& frame
     )
 {
     // subscribe response format:
     //  [<API_ID>, <SEQUENCE_N>, <CODE_N>, <SUB_ID>, <DATA>]
-    int32_t sequenceNum = message[1].as_integer();
-    int32_t code = message[2].as_integer();
+    int32_t sequenceNum = 0;
+    int32_t code = 0;
+    if (!frame.try_get_integer(1, sequenceNum) || !frame.try_get_integer(2, code))
+    {
+        LOG_ERROR("RTA subscribe response is malformed");
+        return;
+    }
+
     std::shared_ptr<real_time_activity_subscription> subscription;
     {
         std::lock_guard<std::recursive_mutex> guard(m_lock);
@@ -528,20 +555,29 @@ real_time_activity_service::complete_subscribe(
         {
             subscription = iter->second;
             m_pendingResponseSubscriptions.erase(iter);
+            m_resubmitInterval = std::chrono::milliseconds(0);
 
+            // The response frees a slot in the window
+            if (m_connectionState == real_time_activity_connection_state::connected)
+            {
+                submit_subscriptions();
+            }
         }
+        m_pendingSubmission->on_response_received(in_flight_count());
     }
 
     if (subscription != nullptr)
     {
         if (code == 0)
         {
-            int subscriptionId = message[3].as_integer();
-            const auto& data = message[4];
+            int32_t subscriptionId = 0;
+            frame.try_get_integer(3, subscriptionId);
+            auto data = frame.element_json(4);
 
             {
                 std::lock_guard<std::recursive_mutex> guard(m_lock);
                 m_subscriptions[subscriptionId] = subscription;
+                m_routingTable->insert(subscriptionId, subscription);
             }
 
             subscription->on_subscription_created(subscriptionId, data);
@@ -551,7 +587,13 @@ real_time_activity_service::complete_subscribe(
             auto xboxLiveErrCode = convert_rta_error_code_to_xbox_live_error_code(code);
             subscription->_Set_state(real_time_activity_subscription_state::closed);
 
-            std::string errorStr = utility::conversions::to_utf8string(message[3].as_string());
+            string_t errorMessage;
+            if (!real_time_activity_frame::try_decode_string(frame.element_data(3), frame.element_length(3), errorMessage))
+            {
+                errorMessage = frame.element_json(3).serialize();
+            }
+
+            std::string errorStr = utility::conversions::to_utf8string(errorMessage);
             _Trigger_subscription_error(
                 real_time_activity_subscription_error_event_args(
                     *subscription,
@@ -569,12 +611,17 @@ real_time_activity_service::complete_subscribe(
 
 void
 real_time_activity_service::complete_unsubscribe(
-    _In_ web::json::value& message
+    _In_ const real_time_activity_frame& frame
     )
 {
     // response format:
     // [<API_ID>, <SEQUENCE_N>, <CODE_N>]
-    int sequenceNum = message[1].as_integer();
+    int32_t sequenceNum = 0;
+    if (!frame.try_get_integer(1, sequenceNum))
+    {
+        LOG_ERROR("RTA unsubscribe response is malformed");
+        return;
+    }
 
     std::shared_ptr<real_time_activity_subscription> subscription;
     {
@@ -586,7 +633,13 @@ real_time_activity_service::complete_unsubscribe(
             m_pendingUnsubscriptions.erase(iter);
 
             subscription->_Set_state(real_time_activity_subscription_state::closed);
+
+            if (m_connectionState == real_time_activity_connection_state::connected)
+            {
+                submit_subscriptions();
+            }
         }
+        m_pendingSubmission->on_response_received(in_flight_count());
     }
 }
 
@@ -611,7 +664,7 @@ real_time_activity_service::_Add_subscription(
     }
 
     subscription->_Set_state(real_time_activity_subscription_state::pending_subscribe);
-    m_pendingSubmission.push_back(subscription);
+    m_pendingSubmission->push(subscription);
     if (m_connectionState == real_time_activity_connection_state::connected)
     {
         submit_subscriptions();
@@ -623,10 +676,14 @@ real_time_activity_service::_Add_subscription(
 void
 real_time_activity_service::submit_subscriptions()
 {
-    while (m_webSocketConnection != nullptr && !m_pendingSubmission.empty())
+    std::weak_ptr<real_time_activity_service> thisWeakPtr = shared_from_this();
+
+    // Requests are pipelined up to the window without waiting on each other, responses refill the window
+    while (m_webSocketConnection != nullptr &&
+        !m_pendingSubmission->empty() &&
+        in_flight_count() < m_pendingSubmission->window_size())
     {
-        auto subscription = m_pendingSubmission.back();
-        m_pendingSubmission.pop_back();
+        auto subscription = m_pendingSubmission->pop();
         int sequenceNumber = utils::interlocked_increment(m_sequenceNumber);
         m_pendingResponseSubscriptions[sequenceNumber] = subscription;
 
@@ -635,8 +692,9 @@ real_time_activity_service::submit_subscriptions()
         request[1] = sequenceNumber;
         request[2] = web::json::value(subscription->resource_uri());
 
+        m_pendingSubmission->on_sent();
         m_webSocketConnection->send(request.serialize())
-        .then([](task<void> t)
+        .then([thisWeakPtr, sequenceNumber](task<void> t)
         {
             try
             {
@@ -644,12 +702,109 @@ real_time_activity_service::submit_subscriptions()
             }
             catch (...)
             {
-                // Throws this exception on failure to send, our retry logic once the websocket comes back online will resend
+                // Throws this exception on failure to send, the subscription is queued again and resent after a backoff
+                std::shared_ptr<real_time_activity_service> pThis(thisWeakPtr.lock());
+                if (pThis != nullptr)
+                {
+                    pThis->on_send_failed(sequenceNumber);
+                }
             }
         });
     }
 }
 
+void
+real_time_activity_service::on_send_failed(
+    _In_ uint32_t sequenceNumber
+    )
+{
+    std::lock_guard<std::recursive_mutex> guard(m_lock);
+
+    // No response will ever come for a request that was not sent, so it gives its slot in the window back
+    auto subscribeIter = m_pendingResponseSubscriptions.find(sequenceNumber);
+    if (subscribeIter != m_pendingResponseSubscriptions.end())
+    {
+        m_pendingSubmission->push(subscribeIter->second);
+        m_pendingResponseSubscriptions.erase(subscribeIter);
+    }
+
+    // The service drops the subscriptions of a connection that fails, so an unsent unsubscribe is treated as done
+    auto unsubscribeIter = m_pendingUnsubscriptions.find(sequenceNumber);
+    if (unsubscribeIter != m_pendingUnsubscriptions.end())
+    {
+        unsubscribeIter->second->_Set_state(real_time_activity_subscription_state::closed);
+        m_pendingUnsubscriptions.erase(unsubscribeIter);
+    }
+
+    m_pendingSubmission->on_response_received(in_flight_count());
+
+    // Nothing else may come along to submit the re-queued subscriptions, so retry them on a timer
+    if (!m_pendingSubmission->empty())
+    {
+        schedule_resubmit();
+    }
+}
+
+void
+real_time_activity_service::schedule_resubmit()
+{
+    if (m_isResubmitScheduled) return;
+    m_isResubmitScheduled = true;
+
+    // Back off exponentially while sends keep failing, a response resets it
+    m_resubmitInterval = m_resubmitInterval.count() == 0 ?
+        RESUBMIT_BASE_INTERVAL :
+        std::chrono::milliseconds(__min(2 * m_resubmitInterval.count(), RESUBMIT_MAX_INTERVAL.count()));
+
+    std::weak_ptr<real_time_activity_service> thisWeakPtr = shared_from_this();
+    create_delayed_task(m_resubmitInterval, [thisWeakPtr]()
+    {
+        std::shared_ptr<real_time_activity_service> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            std::lock_guard<std::recursive_mutex> guard(pThis->m_lock);
+            pThis->m_isResubmitScheduled = false;
+            if (pThis->m_connectionState == real_time_activity_connection_state::connected)
+            {
+                pThis->submit_subscriptions();
+            }
+        }
+    });
+}
+
+size_t
+real_time_activity_service::in_flight_count() const
+{
+    return m_pendingResponseSubscriptions.size() + m_pendingUnsubscriptions.size();
+}
+
+size_t
+real_time_activity_service::_Subscription_Count()
+{
+    std::lock_guard<std::recursive_mutex> guard(m_lock);
+    return m_pendingSubmission->size() + m_pendingResponseSubscriptions.size() + m_subscriptions.size() + m_pendingUnsubscriptions.size();
+}
+
+void
+real_time_activity_service::_Set_submission_window(
+    _In_ uint32_t windowSize
+    )
+{
+    std::lock_guard<std::recursive_mutex> guard(m_lock);
+    m_pendingSubmission->set_window_size(windowSize);
+    if (m_connectionState == real_time_activity_connection_state::connected)
+    {
+        submit_subscriptions();
+    }
+}
+
+real_time_activity_submission_stats
+real_time_activity_service::_Submission_stats()
+{
+    std::lock_guard<std::recursive_mutex> guard(m_lock);
+    return m_pendingSubmission->stats(in_flight_count());
+}
+
 xbox_live_result<void>
 real_time_activity_service::_Remove_subscription(
     _In_ std::shared_ptr<real_time_activity_subscription> subscription
@@ -673,6 +828,7 @@ real_time_activity_service::_Remove_subscription(
         {
             auto subscriptionIter = iter->second;
             m_subscriptions.erase(iter);
+            m_routingTable->erase(subscriptionId);
 
             int sequenceNumber = utils::interlocked_increment(m_sequenceNumber);
             subscriptionIter->_Set_state(real_time_activity_subscription_state::pending_unsubscribe);
@@ -683,8 +839,9 @@ real_time_activity_service::_Remove_subscription(
             request[1] = sequenceNumber;
             request[2] = subscriptionId;
 
+            std::weak_ptr<real_time_activity_service> thisWeakPtr = shared_from_this();
             auto asyncOp = m_webSocketConnection->send(request.serialize())
-                .then([subscriptionIter](task<void> t)
+                .then([thisWeakPtr, sequenceNumber](task<void> t)
             {
                 try
                 {
@@ -692,26 +849,19 @@ real_time_activity_service::_Remove_subscription(
                 }
                 catch (const web::websockets::client::websocket_exception&)
                 {
+                    std::shared_ptr<real_time_activity_service> pThis(thisWeakPtr.lock());
+                    if (pThis != nullptr)
+                    {
+                        pThis->on_send_failed(sequenceNumber);
+                    }
                 }
             });
         }
     }
     else if(subscription->state() == real_time_activity_subscription_state::pending_subscribe)
     {
-        std::vector<std::shared_ptr<real_time_activity_subscription>>::iterator it = m_pendingSubmission.begin();
-        bool found = false;
-        for (it; it != m_pendingSubmission.end(); ++it)
-        {
-            auto pendingSubmission = *it;
-            if (pendingSubmission->m_guid == subscription->m_guid)
-            {
-                found = true;
-                m_pendingSubmission.erase(it);
-                break;
-            }
-        }
-
-        if (!found)
+        // A subscription that was never sent is dropped locally instead of costing a subscribe and an unsubscribe
+        if (!m_pendingSubmission->remove(subscription->m_guid))
         {
             std::map<uint32_t, std::shared_ptr<real_time_activity_subscription>>::iterator responseIt = m_pendingResponseSubscriptions.begin();
             for (responseIt; responseIt != m_pendingResponseSubscriptions.end(); ++responseIt)
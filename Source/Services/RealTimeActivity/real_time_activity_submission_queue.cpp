@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "xsapi/real_time_activity.h"
+#include "real_time_activity_internal.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_BEGIN
+
+real_time_activity_submission_queue::real_time_activity_submission_queue() :
+    m_windowSize(DEFAULT_WINDOW_SIZE),
+    m_sentCount(0),
+    m_isResubscribing(false),
+    m_resubscribeCount(0),
+    m_lastResubscribeLatency(0)
+{
+}
+
+void
+real_time_activity_submission_queue::push(
+    _In_ std::shared_ptr<real_time_activity_subscription> subscription
+    )
+{
+    size_t priority = static_cast<size_t>(subscription->priority());
+    m_queues[__min(priority, PRIORITY_COUNT - 1)].push_back(std::move(subscription));
+}
+
+std::shared_ptr<real_time_activity_subscription>
+real_time_activity_submission_queue::pop()
+{
+    for (size_t priority = PRIORITY_COUNT; priority > 0; --priority)
+    {
+        auto& queue = m_queues[priority - 1];
+        if (!queue.empty())
+        {
+            auto subscription = queue.front();
+            queue.pop_front();
+            return subscription;
+        }
+    }
+
+    return nullptr;
+}
+
+bool
+real_time_activity_submission_queue::remove(
+    _In_ const string_t& subscriptionGuid
+    )
+{
+    for (auto& queue : m_queues)
+    {
+        for (auto iter = queue.begin(); iter != queue.end(); ++iter)
+        {
+            if ((*iter)->m_guid == subscriptionGuid)
+            {
+                queue.erase(iter);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+std::vector<std::shared_ptr<real_time_activity_subscription>>
+real_time_activity_submission_queue::remove_all()
+{
+    std::vector<std::shared_ptr<real_time_activity_subscription>> subscriptions;
+    subscriptions.reserve(size());
+    for (auto& queue : m_queues)
+    {
+        subscriptions.insert(subscriptions.end(), queue.begin(), queue.end());
+        queue.clear();
+    }
+
+    return subscriptions;
+}
+
+size_t
+real_time_activity_submission_queue::size() const
+{
+    size_t size = 0;
+    for (const auto& queue : m_queues)
+    {
+        size += queue.size();
+    }
+
+    return size;
+}
+
+bool
+real_time_activity_submission_queue::empty() const
+{
+    return size() == 0;
+}
+
+uint32_t
+real_time_activity_submission_queue::window_size() const
+{
+    return m_windowSize;
+}
+
+void
+real_time_activity_submission_queue::set_window_size(
+    _In_ uint32_t windowSize
+    )
+{
+    // A window of zero would never send anything
+    m_windowSize = __max(windowSize, 1u);
+}
+
+void
+real_time_activity_submission_queue::on_sent()
+{
+    ++m_sentCount;
+}
+
+void
+real_time_activity_submission_queue::start_resubscribe()
+{
+    if (empty())
+    {
+        return;
+    }
+
+    m_isResubscribing = true;
+    m_resubscribeStartTime = chrono_clock_t::now();
+}
+
+void
+real_time_activity_submission_queue::cancel_resubscribe()
+{
+    m_isResubscribing = false;
+}
+
+void
+real_time_activity_submission_queue::on_response_received(
+    _In_ size_t inFlightCount
+    )
+{
+    if (!m_isResubscribing || !empty() || inFlightCount > 0)
+    {
+        return;
+    }
+
+    m_isResubscribing = false;
+    ++m_resubscribeCount;
+    m_lastResubscribeLatency = std::chrono::duration_cast<std::chrono::milliseconds>(chrono_clock_t::now() - m_resubscribeStartTime);
+    LOGS_INFO << "RTA resubscribed after reconnect in " << m_lastResubscribeLatency.count() << "ms";
+}
+
+real_time_activity_submission_stats
+real_time_activity_submission_queue::stats(
+    _In_ size_t inFlightCount
+    ) const
+{
+    real_time_activity_submission_stats stats;
+    stats.sentCount = m_sentCount;
+    stats.queueLength = static_cast<uint32_t>(size());
+    stats.inFlightCount = static_cast<uint32_t>(inFlightCount);
+    stats.windowSize = m_windowSize;
+    stats.resubscribeCount = m_resubscribeCount;
+    stats.lastResubscribeLatency = m_lastResubscribeLatency;
+    return stats;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_END
@@ -13,6 +13,7 @@ real_time_activity_subscription::real_time_activity_subscription(
     ) :
     m_subscriptionErrorHandler(std::move(subscriptionErrorHandler)),
     m_state(real_time_activity_subscription_state::unknown),
+    m_priority(real_time_activity_subscription_priority::normal),
     m_guid(xbox::services::utils::create_guid(true))
 {
     XSAPI_ASSERT(m_subscriptionErrorHandler != nullptr);
@@ -66,6 +67,20 @@ real_time_activity_subscription::set_subscription_id(
     m_subscriptionId = id;
 }
 
+real_time_activity_subscription_priority
+real_time_activity_subscription::priority() const
+{
+    return m_priority;
+}
+
+void
+real_time_activity_subscription::set_priority(
+    _In_ real_time_activity_subscription_priority priority
+    )
+{
+    m_priority = priority;
+}
+
 void
 real_time_activity_subscription::on_event_received(
     _In_ const web::json::value& data
@@ -75,6 +90,26 @@ real_time_activity_subscription::on_event_received(
     UNREFERENCED_PARAMETER(data);
 }
 
+void
+real_time_activity_subscription::_On_event_received(
+    _In_ const char_t* payload,
+    _In_ size_t payloadLength
+    )
+{
+    web::json::value data;
+    try
+    {
+        data = web::json::value::parse(string_t(payload, payloadLength));
+    }
+    catch (...)
+    {
+        LOG_ERROR("RTA event payload is not valid JSON");
+        return;
+    }
+
+    on_event_received(data);
+}
+
 void 
 real_time_activity_subscription::on_subscription_created(
     _In_ uint32_t id, 
@@ -108,6 +108,44 @@ internal_social_event::internal_social_event(
 {
 }
 
+internal_social_event::internal_social_event(
+    _Inout_ internal_social_event&& other
+    ) :
+    m_socialEventType(other.m_socialEventType),
+    m_completionContext(std::move(other.m_completionContext)),
+    m_presenceRecords(std::move(other.m_presenceRecords)),
+    m_usersAffected(std::move(other.m_usersAffected)),
+    m_usersAffectedAsStringVec(std::move(other.m_usersAffectedAsStringVec)),
+    m_userList(std::move(other.m_userList)),
+    m_tce(std::move(other.m_tce)),
+    m_devicePresenceArgs(std::move(other.m_devicePresenceArgs)),
+    m_titlePresenceArgs(std::move(other.m_titlePresenceArgs)),
+    m_error(std::move(other.m_error))
+{
+}
+
+internal_social_event&
+internal_social_event::operator=(
+    _Inout_ internal_social_event&& other
+    )
+{
+    if (this != &other)
+    {
+        m_socialEventType = other.m_socialEventType;
+        m_completionContext = std::move(other.m_completionContext);
+        m_presenceRecords = std::move(other.m_presenceRecords);
+        m_usersAffected = std::move(other.m_usersAffected);
+        m_usersAffectedAsStringVec = std::move(other.m_usersAffectedAsStringVec);
+        m_userList = std::move(other.m_userList);
+        m_tce = std::move(other.m_tce);
+        m_devicePresenceArgs = std::move(other.m_devicePresenceArgs);
+        m_titlePresenceArgs = std::move(other.m_titlePresenceArgs);
+        m_error = std::move(other.m_error);
+    }
+
+    return *this;
+}
+
 internal_social_event_type
 internal_social_event::event_type() const
 {
@@ -176,4 +214,164 @@ internal_social_event::set_completion_context(
     m_completionContext = compleitionContext;
 }
 
+internal_event_queue::internal_event_queue(
+    _In_ size_t capacity
+    ) :
+    m_enqueuePos(0),
+    m_dequeuePos(0),
+    m_publishedCount(0),
+    m_overflowCount(0)
+{
+    // ring indexing needs a power of two
+    size_t ringSize = 2;
+    while (ringSize < capacity)
+    {
+        ringSize <<= 1;
+    }
+
+    m_mask = ringSize - 1;
+    m_events.resize(ringSize);
+    m_sequences.reset(new std::atomic<size_t>[ringSize]);
+    for (size_t i = 0; i < ringSize; ++i)
+    {
+        m_sequences[i].store(i, std::memory_order_relaxed);
+    }
+}
+
+void
+internal_event_queue::push(
+    _In_ internal_social_event&& socialEvent
+    )
+{
+    // once anything has spilled, keep spilling until the consumer catches up so events stay in order
+    if (m_overflowCount.load(std::memory_order_acquire) == 0 && try_push_ring(socialEvent))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_overflowMutex.get());
+    m_overflowQueue.push_back(std::move(socialEvent));
+    m_overflowCount.fetch_add(1, std::memory_order_release);
+}
+
+bool
+internal_event_queue::try_push_ring(
+    _Inout_ internal_social_event& socialEvent
+    )
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        auto& sequence = m_sequences[pos & m_mask];
+        size_t seq = sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                m_events[pos & m_mask] = std::move(socialEvent);
+
+                // counted before the slot is published, so the consumer's decrement can never run first and wrap the count
+                m_publishedCount.fetch_add(1, std::memory_order_relaxed);
+                sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;   // ring is full
+        }
+        else
+        {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool
+internal_event_queue::try_pop_ring(
+    _Out_ internal_social_event& socialEvent
+    )
+{
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    auto& sequence = m_sequences[pos & m_mask];
+    size_t seq = sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+    {
+        return false;   // empty, or the producer that claimed this slot has not published yet
+    }
+
+    auto& slot = m_events[pos & m_mask];
+    socialEvent = std::move(slot);
+    slot = internal_social_event();
+    m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    sequence.store(pos + m_mask + 1, std::memory_order_release);
+    m_publishedCount.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+bool
+internal_event_queue::try_pop(
+    _Out_ internal_social_event& socialEvent
+    )
+{
+    if (try_pop_ring(socialEvent))
+    {
+        return true;
+    }
+
+    // a claimed slot that has not been published yet is older than anything that spilled after it,
+    // so wait for it rather than letting the overflow queue jump ahead
+    if (m_enqueuePos.load(std::memory_order_acquire) != m_dequeuePos.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    if (m_overflowCount.load(std::memory_order_acquire) == 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_overflowMutex.get());
+    if (m_overflowQueue.empty())
+    {
+        return false;
+    }
+
+    socialEvent = std::move(m_overflowQueue.front());
+    m_overflowQueue.pop_front();
+    m_overflowCount.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+size_t
+internal_event_queue::drain(
+    _Inout_ xsapi_internal_vector(internal_social_event)& socialEvents,
+    _In_ size_t maxEvents
+    )
+{
+    size_t numDrained = 0;
+    internal_social_event socialEvent;
+    while (numDrained < maxEvents && try_pop(socialEvent))
+    {
+        socialEvents.push_back(std::move(socialEvent));
+        ++numDrained;
+    }
+
+    return numDrained;
+}
+
+size_t
+internal_event_queue::size() const
+{
+    // a slot is counted once its event has been written, claimed slots that are still empty are not
+    return m_publishedCount.load(std::memory_order_acquire) + m_overflowCount.load(std::memory_order_acquire);
+}
+
+bool
+internal_event_queue::empty() const
+{
+    return size() == 0;
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_END
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "xsapi/system.h"
 #include "xsapi/presence.h"
 #include "xbox_live_context_impl.h"
+#include "presence_internal.h"
+#include "social_internal.h"
 #include "system_internal.h"
 #include "xbox_system_factory.h"
 
@@ -215,10 +217,15 @@ social_graph::initialize()
                 auto& inactiveBufferSocialGraph = pThis->m_userBuffer.inactive_buffer()->socialUserGraph;
                 for (auto& user : inactiveBufferSocialGraph)
                 {
-                    auto devicePresenceSubResult = pThis->m_xboxLiveContextImpl->presence_service().subscribe_to_device_presence_change(user.second.socialUser->xbox_user_id());
-                    auto titlePresenceSubResult = pThis->m_xboxLiveContextImpl->presence_service().subscribe_to_title_presence_change(
+                    auto presenceService = pThis->m_xboxLiveContextImpl->presence_service()._Impl();
+                    auto devicePresenceSubResult = presenceService->subscribe_to_device_presence_change(
                         user.second.socialUser->xbox_user_id(),
-                        pThis->m_xboxLiveContextImpl->application_config()->title_id()
+                        real_time_activity_subscription_priority::low
+                        );
+                    auto titlePresenceSubResult = presenceService->subscribe_to_title_presence_change(
+                        user.second.socialUser->xbox_user_id(),
+                        pThis->m_xboxLiveContextImpl->application_config()->title_id(),
+                        real_time_activity_subscription_priority::low
                         );
 
                     if (devicePresenceSubResult.err() || titlePresenceSubResult.err())
@@ -266,6 +273,14 @@ social_graph::active_buffer_social_graph()
     return &m_userBuffer.active_buffer()->socialUserGraph;
 }
 
+const social_user_columns*
+social_graph::active_buffer_user_columns()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_socialGraphMutex);
+    std::lock_guard<std::recursive_mutex> priorityLock(m_socialGraphPriorityMutex);
+    return &m_userBuffer.active_buffer()->userColumns;
+}
+
 bool
 social_graph::do_event_work()
 {
@@ -280,7 +295,7 @@ social_graph::do_event_work()
 
             m_perfTester.start_timer(_T("do_event_work: event_processing"));
             m_perfTester.start_timer(_T("do_event_work: has_cached_events"));
-            hasCachedEvents = m_isInitialized && m_userBuffer.inactive_buffer() && !m_userBuffer.inactive_buffer()->socialUserEventQueue.empty(true);
+            hasCachedEvents = m_isInitialized && m_userBuffer.inactive_buffer() && !m_userBuffer.inactive_buffer()->socialUserEventQueue.empty();
             m_perfTester.stop_timer(_T("do_event_work: has_cached_events"));
             if (hasCachedEvents)
             {
@@ -301,7 +316,7 @@ social_graph::do_event_work()
             std::lock_guard<std::recursive_mutex> priorityLock(m_socialGraphPriorityMutex);
             m_perfTester.start_timer(_T("do_event_work: process_events"));
             set_state(social_graph_state::normal);
-            hasRemainingEvent = process_events(); //effectively a coroutine here so that each event yields when it is done processing
+            hasRemainingEvent = process_events(); //effectively a coroutine here so that each batch yields when it is done processing
             m_perfTester.stop_timer(_T("do_event_work: process_events"));
         }
         else
@@ -340,9 +355,9 @@ social_graph::process_cached_events()
     {
         auto inactiveBuffer = m_userBuffer.inactive_buffer();
         auto& eventQueue = inactiveBuffer->socialUserEventQueue;
-        while (!eventQueue.empty())
+        internal_social_event evt;
+        while (eventQueue.try_pop(evt))
         {
-            auto evt = eventQueue.pop();
             apply_event(evt, false);
         }
 
@@ -355,16 +370,23 @@ social_graph::process_cached_events()
 bool
 social_graph::process_events()
 {
-    bool shouldApplyEvent = !m_internalEventQueue.empty() && m_numEventsThisFrame < NUM_EVENTS_PER_FRAME;
-    if(shouldApplyEvent)
+    if (m_numEventsThisFrame >= NUM_EVENTS_PER_FRAME)
+    {
+        return false;
+    }
+
+    // take the whole batch allowed this frame in one go, the queue is lock free so this costs no locking per event
+    m_eventBatch.clear();
+    auto numEvents = m_internalEventQueue.drain(m_eventBatch, NUM_EVENTS_PER_FRAME - m_numEventsThisFrame);
+    m_numEventsThisFrame += static_cast<uint32_t>(numEvents);
+    for (auto& evt : m_eventBatch)
     {
-        ++m_numEventsThisFrame;
-        auto evt = m_internalEventQueue.pop();
         apply_event(evt, true);
-        m_userBuffer.add_event(evt);
+        m_userBuffer.add_event(std::move(evt));
     }
+    m_eventBatch.clear();
 
-    return shouldApplyEvent;
+    return numEvents > 0;
 }
 
 void
@@ -419,12 +441,13 @@ social_graph::apply_event(
                 LOG_ERROR("social graph: social user not found in title presence change");
                 break;
             }
-            auto& userPresenceRecord = inactiveBuffer->socialUserGraph.at(xuid).socialUser->m_presenceRecord;
+            auto& userPresenceRecord = xuidIter->second.socialUser->m_presenceRecord;
             if (titlePresenceChanged.title_state() == xbox::services::presence::title_presence_state::ended)
             {
                 userPresenceRecord._Remove_title(
                     titlePresenceChanged.title_id()
                 );
+                user_buffers_holder::refresh_user_columns(*inactiveBuffer, xuidIter->second);
             }
 
             eventType = social_event_type::presence_changed;
@@ -443,7 +466,14 @@ social_graph::apply_event(
             m_perfTester.start_timer(_T("profiles_changed"));
             for (auto& user : evt.users_affected())
             {
-                *inactiveBuffer->socialUserGraph[user._Xbox_user_id_as_integer()].socialUser = user;
+                auto userIter = inactiveBuffer->socialUserGraph.find(user._Xbox_user_id_as_integer());
+                if (userIter == inactiveBuffer->socialUserGraph.end() || userIter->second.socialUser == nullptr)
+                {
+                    LOG_ERROR("social graph: social user not found in profile change");
+                    continue;
+                }
+                *userIter->second.socialUser = user;
+                user_buffers_holder::refresh_user_columns(*inactiveBuffer, userIter->second);
             }
 
             eventType = social_event_type::profiles_changed;
@@ -584,6 +614,7 @@ social_graph::apply_users_change_event(
             else
             {
                 *userIter->second.socialUser = user;
+                user_buffers_holder::refresh_user_columns(*inactiveBuffer, userIter->second);
                 usersChanged.push_back(user);
             }
         }
@@ -664,6 +695,7 @@ void social_graph::apply_device_presence_changed_event(
             devicePresenceChangedArgs.device_type(),
             devicePresenceChangedArgs.is_user_logged_on_device()
         );
+        user_buffers_holder::refresh_user_columns(*inactiveBuffer, xuidIter->second);
 
         eventType = social_event_type::presence_changed;
     }
@@ -697,16 +729,11 @@ void social_graph::apply_presence_changed_event(
                 LOG_ERROR("social_graph: User not found in updating presence");
                 continue;
             }
-            auto userPresenceRecord = socialUser->presence_record();
+            const auto& userPresenceRecord = socialUser->presence_record();
             if (userPresenceRecord._Compare(presenceRecord))    // TODO: potential optimization, limits the number of compares that can happen in a single event (i.e. if presence result has 100 record split it up into 10 events)
             {
-                auto socialUserGraphUser = inactiveBuffer->socialUserGraph.at(presenceRecord._Xbox_user_id()).socialUser;
-                if (socialUserGraphUser == nullptr)
-                {
-                    LOG_ERROR("social_graph: User not found in social user graph");
-                    continue;
-                }
-                socialUserGraphUser->_Set_presence_record(presenceRecord);
+                socialUser->_Set_presence_record(presenceRecord);
+                user_buffers_holder::refresh_user_columns(*inactiveBuffer, userPresenceRecordIter->second);
                 userAddedVec.push_back(presenceRecord._Xbox_user_id());
             }
         }
@@ -782,8 +809,10 @@ social_graph::setup_rta_subscriptions(
     std::lock_guard<std::recursive_mutex> priorityLock(m_socialGraphPriorityMutex);
     m_perfTester.start_timer(_T("setup_rta_subscriptions"));
     m_xboxLiveContextImpl->real_time_activity_service()->activate();
-    auto socialRelationshipChangeResult = m_xboxLiveContextImpl->social_service().subscribe_to_social_relationship_change(
-        m_xboxLiveContextImpl->xbox_live_user_id()
+    // A single subscription that drives the whole graph, so it goes ahead of the per friend presence after a reconnect
+    auto socialRelationshipChangeResult = m_xboxLiveContextImpl->social_service()._Impl()->subscribe_to_social_relationship_change(
+        m_xboxLiveContextImpl->xbox_live_user_id(),
+        real_time_activity_subscription_priority::high
         );
 
     if (socialRelationshipChangeResult.err())
@@ -863,10 +892,15 @@ social_graph::setup_device_and_presence_subscriptions_helper(
         str << xuid;
         auto xuidStr = str.str();
 
-        auto devicePresenceSubResult = m_xboxLiveContextImpl->presence_service().subscribe_to_device_presence_change(xuidStr);
-        auto titlePresenceSubResult = m_xboxLiveContextImpl->presence_service().subscribe_to_title_presence_change(
+        auto presenceService = m_xboxLiveContextImpl->presence_service()._Impl();
+        auto devicePresenceSubResult = presenceService->subscribe_to_device_presence_change(
+            xuidStr,
+            real_time_activity_subscription_priority::low
+            );
+        auto titlePresenceSubResult = presenceService->subscribe_to_title_presence_change(
             xuidStr,
-            m_xboxLiveContextImpl->application_config()->title_id()
+            m_xboxLiveContextImpl->application_config()->title_id(),
+            real_time_activity_subscription_priority::low
             );
 
         if (devicePresenceSubResult.err() || titlePresenceSubResult.err())
@@ -1005,9 +1039,10 @@ social_graph::refresh_graph()
             {
                 auto& socialList = socialListResult.payload();
                 xsapi_internal_unordered_map(uint64_t, xbox_social_user) socialMap;
+                socialMap.reserve(socialList.size());
                 for (auto& user : socialList)
                 {
-                    socialMap[user._Xbox_user_id_as_integer()] = user;
+                    socialMap.emplace(user._Xbox_user_id_as_integer(), user);
                 }
 
                 pThis->perform_diff(socialMap);
@@ -1039,77 +1074,93 @@ social_graph::perform_diff(
         m_perfTester.stop_timer(_T("set_state"));
     }
 
-    xsapi_internal_vector(xbox_social_user) usersAddedList;
-    xsapi_internal_vector(uint64_t) usersRemovedList;
-    xsapi_internal_vector(social_manager_presence_record) presenceChangeList;
-    xsapi_internal_vector(xbox_social_user) socialRelationshipChangeList;
-    xsapi_internal_vector(xbox_social_user) profileChangeList;
+    social_graph_diff socialGraphDiff;
+    m_perfTester.start_timer(_T("perform_diff: compute_diff"));
+    compute_diff(xboxSocialUsers, m_userBuffer.inactive_buffer()->socialUserGraph, socialGraphDiff);
+    m_perfTester.stop_timer(_T("perform_diff: compute_diff"));
 
+    if (!socialGraphDiff.usersAddedList.empty())
+    {
+        m_internalEventQueue.push(internal_social_event_type::users_changed, socialGraphDiff.usersAddedList);
+    }
+    if (!socialGraphDiff.usersRemovedList.empty())
+    {
+        m_internalEventQueue.push(internal_social_event_type::users_removed, socialGraphDiff.usersRemovedList);
+    }
+    if (!socialGraphDiff.presenceChangeList.empty())
+    {
+        m_internalEventQueue.push(internal_social_event_type::presence_changed, socialGraphDiff.presenceChangeList);
+    }
+    if (!socialGraphDiff.profileChangeList.empty())
+    {
+        m_internalEventQueue.push(internal_social_event_type::profiles_changed, socialGraphDiff.profileChangeList);
+    }
+    if (!socialGraphDiff.socialRelationshipChangeList.empty())
+    {
+        m_internalEventQueue.push(internal_social_event_type::social_relationships_changed, socialGraphDiff.socialRelationshipChangeList);
+    }
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_socialGraphMutex);
+        std::lock_guard<std::recursive_mutex> priorityLock(m_socialGraphPriorityMutex);
+        m_perfTester.start_timer(_T("set_state normal"));
+        set_state(social_graph_state::normal);
+        m_perfTester.stop_timer(_T("set_state normal"));
+    }
+}
+
+void
+social_graph::compute_diff(
+    _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user)& xboxSocialUsers,
+    _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& previousSocialUsers,
+    _Inout_ social_graph_diff& socialGraphDiff
+    )
+{
     for (auto& currentUserPair : xboxSocialUsers)
     {
-        m_perfTester.start_timer(_T("perform_diff: start"));
-        auto inactiveBufferUserGraph = m_userBuffer.inactive_buffer()->socialUserGraph;
-        if (inactiveBufferUserGraph.find(currentUserPair.first) == inactiveBufferUserGraph.end())
+        auto previousUserIter = previousSocialUsers.find(currentUserPair.first);
+        if (previousUserIter == previousSocialUsers.end())
         {
-            usersAddedList.push_back(currentUserPair.second);
+            socialGraphDiff.usersAddedList.push_back(currentUserPair.second);
+            continue;
+        }
+
+        auto previousUser = previousUserIter->second.socialUser;
+        if (previousUser == nullptr)
+        {
+            // user is pending a lookup from an add, the lookup result will populate it
             continue;
         }
 
-        auto previousUser = inactiveBufferUserGraph.at(currentUserPair.first).socialUser;
         change_list_enum didChange = xbox_social_user::_Compare(*previousUser, currentUserPair.second);
+        if (didChange == change_list_enum::no_change)
+        {
+            continue;
+        }
 
         if ((didChange & change_list_enum::presence_change) == change_list_enum::presence_change)
         {
-            presenceChangeList.push_back(currentUserPair.second.presence_record());
+            socialGraphDiff.presenceChangeList.push_back(currentUserPair.second.presence_record());
         }
         if ((didChange & change_list_enum::profile_change) == change_list_enum::profile_change)
         {
-            profileChangeList.push_back(currentUserPair.second);
+            socialGraphDiff.profileChangeList.push_back(currentUserPair.second);
         }
         if ((didChange & change_list_enum::social_relationship_change) == change_list_enum::social_relationship_change)
         {
-            socialRelationshipChangeList.push_back(currentUserPair.second);
+            socialGraphDiff.socialRelationshipChangeList.push_back(currentUserPair.second);
         }
     }
 
-    auto inactiveBufferUserGraph = m_userBuffer.inactive_buffer()->socialUserGraph;
-    for (auto& previousUserPair : inactiveBufferUserGraph)
+    for (auto& previousUserPair : previousSocialUsers)
     {
-        if (xboxSocialUsers.find(previousUserPair.first) == xboxSocialUsers.end() && 
-            (previousUserPair.second.socialUser != nullptr && previousUserPair.second.socialUser->is_following_user()))
+        if (previousUserPair.second.socialUser != nullptr &&
+            previousUserPair.second.socialUser->is_following_user() &&
+            xboxSocialUsers.find(previousUserPair.first) == xboxSocialUsers.end())
         {
-            usersRemovedList.push_back(previousUserPair.first);
+            socialGraphDiff.usersRemovedList.push_back(previousUserPair.first);
         }
     }
-
-    if (usersAddedList.size() > 0)
-    {
-        m_internalEventQueue.push(internal_social_event_type::users_changed, usersAddedList);
-    }
-    if (usersRemovedList.size() > 0)
-    {
-        m_internalEventQueue.push(internal_social_event_type::users_removed, usersRemovedList);
-    }
-    if (presenceChangeList.size() > 0)
-    {
-        m_internalEventQueue.push(internal_social_event_type::presence_changed, presenceChangeList);
-    }
-    if (profileChangeList.size() > 0)
-    {
-        m_internalEventQueue.push(internal_social_event_type::profiles_changed, profileChangeList);
-    }
-    if (socialRelationshipChangeList.size() > 0)
-    {
-        m_internalEventQueue.push(internal_social_event_type::social_relationships_changed, socialRelationshipChangeList);
-    }
-
-    {
-        std::lock_guard<std::recursive_mutex> lock(m_socialGraphMutex);
-        std::lock_guard<std::recursive_mutex> priorityLock(m_socialGraphPriorityMutex);
-        m_perfTester.start_timer(_T("set_state normal"));
-        set_state(social_graph_state::normal);
-        m_perfTester.stop_timer(_T("set_state normal"));
-    }
 }
 
 uint32_t
@@ -1130,6 +1181,7 @@ social_graph::do_work(
     m_numEventsThisFrame = 0;
     change_struct changeStruct;
     changeStruct.socialUsers = nullptr;
+    changeStruct.userColumns = nullptr;
     m_perfTester.start_timer(_T("social_graph_state_check"));
     if (m_socialGraphState == social_graph_state::normal && m_userBuffer.inactive_buffer() != nullptr && m_userBuffer.inactive_buffer()->socialUserEventQueue.empty())
     {
@@ -1142,6 +1194,7 @@ social_graph::do_work(
     if (m_userBuffer.active_buffer() != nullptr)
     {
         changeStruct.socialUsers = &m_userBuffer.active_buffer()->socialUserGraph;
+        changeStruct.userColumns = &m_userBuffer.active_buffer()->userColumns;
     }
     m_perfTester.stop_timer(_T("assgin active buffer"));
     m_perfTester.start_timer(_T("!m_socialEventQueue.empty()"));
@@ -1194,7 +1247,7 @@ social_graph::social_graph_timer_callback(
                     }
                     internal_social_event evt(internal_social_event_type::users_changed, xbox_live_result<void>(socialListResult.err(), socialListResult.err_message()), xsapiStrVec);
                     evt.set_completion_context(completionContext);
-                    pThis->m_internalEventQueue.push(evt);
+                    pThis->m_internalEventQueue.push(std::move(evt));
                 }
             }
         }
@@ -1269,7 +1322,7 @@ social_graph::handle_title_presence_change(
     else
     {
         internal_social_event titlePresenceChangeEvent(internal_social_event_type::title_presence_changed, titlePresenceChanged);
-        m_internalEventQueue.push(titlePresenceChangeEvent);
+        m_internalEventQueue.push(std::move(titlePresenceChangeEvent));
     }
 }
 
@@ -1410,19 +1463,17 @@ social_graph::presence_timer_callback(
                     pThis->m_perfTester.start_timer(_T("social graph refresh state set"));
                 }
 
-                auto presenceRecordReturnVec = presenceRecordsResult.payload();
-                xsapi_internal_vector(social_manager_presence_record) socialManagerPresenceVec;
-                socialManagerPresenceVec.reserve(presenceRecordReturnVec.size());
-                for (auto& presenceRecord : presenceRecordReturnVec)
-                {
-                    socialManagerPresenceVec.push_back(social_manager_presence_record(presenceRecord));
-                }
+                auto inactiveBuffer = pThis->m_userBuffer.inactive_buffer();
 
-                std::vector<social_manager_presence_record> presenceRecordChanges;
-                for (auto& record : socialManagerPresenceVec)
+                // Events that haven't been applied yet can still move the buffer, so it can only be used to drop unchanged records when nothing is pending
+                bool isBufferCurrent = pThis->m_internalEventQueue.empty() && inactiveBuffer->socialUserEventQueue.empty();
+
+                xsapi_internal_vector(social_manager_presence_record) presenceRecordChanges;
+                for (auto& presenceRecord : presenceRecordsResult.payload())
                 {
-                    auto previousRecordIter = pThis->m_userBuffer.inactive_buffer()->socialUserGraph.find(record._Xbox_user_id());
-                    if (previousRecordIter == pThis->m_userBuffer.inactive_buffer()->socialUserGraph.end())
+                    social_manager_presence_record record(presenceRecord);
+                    auto previousRecordIter = inactiveBuffer->socialUserGraph.find(record._Xbox_user_id());
+                    if (previousRecordIter == inactiveBuffer->socialUserGraph.end())
                     {
                         continue;
                     }
@@ -1432,16 +1483,26 @@ social_graph::presence_timer_callback(
                         continue;
                     }
                     auto& previousRecord = previousRecordIter->second.socialUser->presence_record();
-                    if (previousRecord._Compare(record))
+                    bool hasChanged = previousRecord._Compare(record);
+                    pThis->m_presencePollScheduler.on_presence_polled(
+                        record._Xbox_user_id(),
+                        hasChanged,
+                        record.user_state() == user_presence_state::online
+                        );
+
+                    if (hasChanged || !isBufferCurrent)
                     {
-                        presenceRecordChanges.push_back(record);
+                        presenceRecordChanges.push_back(std::move(record));
                     }
                 }
 
-                pThis->m_internalEventQueue.push(
-                    internal_social_event_type::presence_changed,
-                    socialManagerPresenceVec
-                    );
+                if (!presenceRecordChanges.empty())
+                {
+                    pThis->m_internalEventQueue.push(
+                        internal_social_event_type::presence_changed,
+                        presenceRecordChanges
+                        );
+                }
 
                 {
                     std::lock_guard<std::recursive_mutex> lock(pThis->m_socialGraphMutex);
@@ -1503,17 +1564,12 @@ social_graph::presence_refresh_callback()
                 set_state(social_graph_state::refresh);
                 m_perfTester.stop_timer(_T("presence refresh state set"));
             }
-            userList.reserve(m_userBuffer.inactive_buffer()->socialUserGraph.size());
-            for (auto& user : m_userBuffer.inactive_buffer()->socialUserGraph)
+            userList = m_presencePollScheduler.next_round(m_userBuffer.inactive_buffer()->socialUserGraph);
+            if (!userList.empty())
             {
-                if (user.second.socialUser != nullptr)
-                {
-                    userList.push_back(user.second.socialUser->xbox_user_id());
-                }
+                m_presencePollingTimer->fire(userList);
             }
 
-            m_presencePollingTimer->fire(userList);
-
             {
                 std::lock_guard<std::recursive_mutex> lock(m_socialGraphMutex);
                 std::lock_guard<std::recursive_mutex> priorityLock(m_socialGraphPriorityMutex);
@@ -1582,6 +1638,84 @@ void social_graph::print_debug_info()
 {
 }
 
+presence_poll_scheduler::presence_poll_scheduler() :
+    m_round(0)
+{
+}
+
+std::vector<string_t>
+presence_poll_scheduler::next_round(
+    _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& socialUserGraph
+    )
+{
+    for (auto iter = m_pollStates.begin(); iter != m_pollStates.end();)
+    {
+        if (socialUserGraph.find(iter->first) == socialUserGraph.end())
+        {
+            iter = m_pollStates.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    std::vector<string_t> userList;
+    for (auto& user : socialUserGraph)
+    {
+        if (user.second.socialUser == nullptr)
+        {
+            continue;
+        }
+
+        // Users new to the graph start with nextRound 0 so they are polled straight away
+        auto& pollState = m_pollStates[user.first];
+        if (pollState.nextRound <= m_round)
+        {
+            userList.push_back(user.second.socialUser->xbox_user_id());
+            pollState.nextRound = m_round + pollState.interval;
+        }
+    }
+
+    ++m_round;
+    return userList;
+}
+
+void
+presence_poll_scheduler::on_presence_polled(
+    _In_ uint64_t xboxUserId,
+    _In_ bool hasChanged,
+    _In_ bool isOnline
+    )
+{
+    auto iter = m_pollStates.find(xboxUserId);
+    if (iter == m_pollStates.end())
+    {
+        return;
+    }
+
+    auto& pollState = iter->second;
+    if (hasChanged || isOnline)
+    {
+        // Presence can also come back from an RTA triggered refresh, so pull the user forward if it was waiting out a long interval
+        pollState.interval = 1;
+        pollState.nextRound = __min(pollState.nextRound, m_round);
+    }
+    else
+    {
+        pollState.interval = __min(pollState.interval * 2, MAX_IDLE_POLL_INTERVAL);
+    }
+}
+
+uint32_t
+presence_poll_scheduler::poll_interval(
+    _In_ uint64_t xboxUserId
+    ) const
+{
+    auto iter = m_pollStates.find(xboxUserId);
+    return iter == m_pollStates.end() ? 0 : iter->second.interval;
+}
+
 const uint32_t user_buffers_holder::EXTRA_USER_FREE_SPACE = 5;
 
 user_buffers_holder::user_buffers_holder() : m_activeBuffer(nullptr), m_inactiveBuffer(nullptr)
@@ -1655,6 +1789,8 @@ void user_buffers_holder::buffer_init(
 
     auto usersSize = users.size();
     auto socialUserSize = sizeof(xbox_social_user);
+    auto totalFreeSpace = EXTRA_USER_FREE_SPACE + freeSpaceRequired;
+    userBuffer.userColumns.reset(usersSize + totalFreeSpace);
 
     for (uint32_t i = 0; i < usersSize; ++i)
     {
@@ -1664,7 +1800,6 @@ void user_buffers_holder::buffer_init(
         *xboxSocialUser = users[i];
     }
 
-    auto totalFreeSpace = EXTRA_USER_FREE_SPACE + freeSpaceRequired;
     auto startOffset = userBuffer.buffer + users.size() * socialUserSize;
     for (uint32_t i = 0; i < totalFreeSpace; ++i)
     {
@@ -1701,10 +1836,12 @@ user_buffers_holder::initialize_users_in_map(
 {
     xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& socialUserGraph = userBuffer.socialUserGraph;
     auto buffer = userBuffer.buffer + bufferOffset;
+    auto firstIndex = static_cast<uint32_t>(bufferOffset / sizeof(xbox_social_user));
     for (uint32_t i = 0; i < numUsers; ++i)
     {
         auto userPtr = (buffer + i * sizeof(xbox_social_user));
         xbox_social_user* socialUser = reinterpret_cast<xbox_social_user*>(userPtr);
+        uint32_t index = firstIndex + i;
 
         auto userIter = socialUserGraph.find(socialUser->_Xbox_user_id_as_integer());
         if (userIter == socialUserGraph.end())
@@ -1712,13 +1849,17 @@ user_buffers_holder::initialize_users_in_map(
             xbox_social_user_context userContext;
             userContext.refCount = 1;
             userContext.socialUser = socialUser;
+            userContext.index = index;
 
             socialUserGraph[socialUser->_Xbox_user_id_as_integer()] = userContext;
         }
         else
         {
             userIter->second.socialUser = socialUser;
+            userIter->second.index = index;
         }
+
+        userBuffer.userColumns.update(index, socialUser);
     }
 }
 
@@ -1777,7 +1918,8 @@ user_buffers_holder::remove_users_from_buffer(
         auto xboxSocialUserContextIter = userBufferInactive.socialUserGraph.find(user);
         if (xboxSocialUserContextIter != userBufferInactive.socialUserGraph.end())
         {
-            auto userPtr = userBufferInactive.socialUserGraph[user].socialUser;
+            auto userPtr = xboxSocialUserContextIter->second.socialUser;
+            userBufferInactive.userColumns.clear(xboxSocialUserContextIter->second.index);
             userBufferInactive.freeData.push(reinterpret_cast<byte*>(userPtr));
             userBufferInactive.socialUserGraph.erase(xboxSocialUserContextIter);
         }
@@ -1788,6 +1930,18 @@ user_buffers_holder::remove_users_from_buffer(
     }
 }
 
+void
+user_buffers_holder::refresh_user_columns(
+    _Inout_ user_buffer& userBuffer,
+    _In_ const xbox_social_user_context& userContext
+    )
+{
+    if (userContext.socialUser != nullptr)
+    {
+        userBuffer.userColumns.update(userContext.index, userContext.socialUser);
+    }
+}
+
 void
 user_buffers_holder::swap()
 {
@@ -1816,10 +1970,91 @@ user_buffers_holder::inactive_buffer()
 
 void
 user_buffers_holder::add_event(
-    _In_ const internal_social_event& internalSocialEvent
+    _Inout_ internal_social_event&& internalSocialEvent
+    )
+{
+    m_activeBuffer->socialUserEventQueue.push(std::move(internalSocialEvent));
+}
+
+void
+social_user_columns::reset(
+    _In_ size_t capacity
+    )
+{
+    m_xboxUserIds.assign(capacity, 0);
+    m_socialUsers.assign(capacity, nullptr);
+    m_flags.assign(capacity, social_user_flags::none);
+    m_presenceStates.assign(capacity, user_presence_state::unknown);
+    m_presenceTitleIds.assign(capacity * NUM_PRESENCE_RECORDS, 0);
+}
+
+void
+social_user_columns::update(
+    _In_ uint32_t index,
+    _In_ xbox_social_user* socialUser
+    )
+{
+    if (index >= m_xboxUserIds.size())
+    {
+        LOG_ERROR("social_user_columns: index out of range in update");
+        return;
+    }
+
+    const auto& user = *socialUser;
+    m_socialUsers[index] = socialUser;
+
+    social_user_flags flags = social_user_flags::none;
+    if (user.is_favorite()) flags = flags | social_user_flags::favorite;
+    if (user.is_following_user()) flags = flags | social_user_flags::following_caller;
+    if (user.is_followed_by_caller()) flags = flags | social_user_flags::followed_by_caller;
+    if (user.title_history().has_user_played()) flags = flags | social_user_flags::has_played_title;
+
+    m_xboxUserIds[index] = user._Xbox_user_id_as_integer();
+    m_flags[index] = flags;
+
+    const auto& presenceRecord = user.presence_record();
+    m_presenceStates[index] = presenceRecord.user_state();
+    auto titleIds = &m_presenceTitleIds[index * NUM_PRESENCE_RECORDS];
+    for (uint32_t i = 0; i < NUM_PRESENCE_RECORDS; ++i)
+    {
+        const auto& titleRecord = presenceRecord.m_presenceVec[i];
+        titleIds[i] = titleRecord._Is_null() ? 0 : titleRecord.title_id();
+    }
+}
+
+void
+social_user_columns::clear(
+    _In_ uint32_t index
     )
 {
-    m_activeBuffer->socialUserEventQueue.push(internalSocialEvent);
+    if (index >= m_xboxUserIds.size())
+    {
+        return;
+    }
+
+    m_xboxUserIds[index] = 0;
+    m_socialUsers[index] = nullptr;
+    m_flags[index] = social_user_flags::none;
+    m_presenceStates[index] = user_presence_state::unknown;
+    std::fill_n(m_presenceTitleIds.begin() + index * NUM_PRESENCE_RECORDS, NUM_PRESENCE_RECORDS, 0);
+}
+
+bool
+social_user_columns::is_user_playing_title(
+    _In_ uint32_t index,
+    _In_ uint32_t titleId
+    ) const
+{
+    auto titleIds = &m_presenceTitleIds[index * NUM_PRESENCE_RECORDS];
+    for (uint32_t i = 0; i < NUM_PRESENCE_RECORDS; ++i)
+    {
+        if (titleIds[i] == titleId && titleId != 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 event_queue::event_queue() :
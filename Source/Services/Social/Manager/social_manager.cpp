@@ -71,7 +71,8 @@ social_manager::create_social_user_group_from_filters(
     {
         
         m_xboxSocialUserGroups[viewHash]->initialize_filter_list(
-            *m_localGraphs[ownerUserId]->active_buffer_social_graph()
+            *m_localGraphs[ownerUserId]->active_buffer_social_graph(),
+            m_localGraphs[ownerUserId]->active_buffer_user_columns()
             );
 
         std::lock_guard<std::mutex> eventLock(m_socialManagerEventLock);
@@ -306,7 +307,8 @@ social_manager::add_local_user(
                                 {
                                     std::weak_ptr<social_manager> socialManagerWeakPtr = pThis;
                                     currentView->initialize_filter_list(
-                                        *pThis->m_localGraphs[userString]->active_buffer_social_graph()
+                                        *pThis->m_localGraphs[userString]->active_buffer_social_graph(),
+                                        pThis->m_localGraphs[userString]->active_buffer_user_columns()
                                         );
 
                                     std::lock_guard<std::mutex> eventLock(pThis->m_socialManagerEventLock);
@@ -408,17 +410,25 @@ social_manager::do_work()
     m_perfTester.stop_timer(_T("do_work: eventqueue clear"));
     for (auto& graph : m_localGraphs)
     {
+        size_t firstGraphEvent = socialEvents.size();
         m_perfTester.start_timer(_T("do_work: social_graph do_work"));
         auto graphData = graph.second->do_work(socialEvents);
         m_perfTester.stop_timer(_T("do_work: social_graph do_work"));
         const auto& userViewList = m_userToViewMap[graph.first];
+        if (userViewList.empty())
+        {
+            continue;
+        }
+
+        social_user_group_delta groupDelta;
+        groupDelta.add_events(socialEvents, firstGraphEvent);
         for (auto& viewHash : userViewList)
         {
             auto& view = m_xboxSocialUserGroups[viewHash];
             if(graphData.socialUsers != nullptr)
             {
                 m_perfTester.start_timer(_T("do_work: update_view"));
-                view->update_view(*graphData.socialUsers, socialEvents);
+                view->update_view(*graphData.socialUsers, graphData.userColumns, groupDelta);
                 m_perfTester.stop_timer(_T("do_work: update_view"));
             }
         }
@@ -99,6 +99,9 @@ public:
         _In_ xsapi_internal_vector(xsapi_internal_string) userAddList
         );
 
+    internal_social_event(_Inout_ internal_social_event&& other);
+    internal_social_event& operator=(_Inout_ internal_social_event&& other);
+
     const call_buffer_timer_completion_context& completion_context() const;
     void set_completion_context(_In_ const call_buffer_timer_completion_context& compleitionContext);
     const xsapi_internal_vector(xbox_social_user)& users_affected() const;
@@ -112,6 +115,10 @@ public:
     internal_social_event_type event_type() const;
 
 private:
+    // events are moved through the event pipeline, never copied
+    internal_social_event(const internal_social_event&);
+    internal_social_event& operator=(const internal_social_event&);
+
     internal_social_event_type m_socialEventType;
     call_buffer_timer_completion_context m_completionContext;
     xsapi_internal_vector(social_manager_presence_record) m_presenceRecords;
@@ -124,10 +131,67 @@ private:
     xbox_live_result<void> m_error;
 };
 
+static const uint32_t INVALID_SOCIAL_USER_INDEX = UINT32_MAX;
+
 struct xbox_social_user_context
 {
+    xbox_social_user_context() : refCount(0), socialUser(nullptr), index(INVALID_SOCIAL_USER_INDEX) {}
+
     uint32_t refCount;
     xbox_social_user* socialUser;
+    uint32_t index;     // dense slot of socialUser in its user_buffer, used to address social_user_columns
+};
+
+/// <summary>
+/// internal only
+/// </summary>
+enum class social_user_flags : uint8_t
+{
+    none = 0x0,
+    favorite = 0x1,
+    following_caller = 0x2,
+    followed_by_caller = 0x4,
+    has_played_title = 0x8
+};
+
+inline social_user_flags operator|(social_user_flags lhs, social_user_flags rhs)
+{
+    return static_cast<social_user_flags>(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+}
+
+inline social_user_flags operator&(social_user_flags lhs, social_user_flags rhs)
+{
+    return static_cast<social_user_flags>(static_cast<uint8_t>(lhs) & static_cast<uint8_t>(rhs));
+}
+
+/// <summary>
+/// internal only
+/// Columnar copy of the fields that filtering reads every frame, addressed by the dense slot index of a user in a user_buffer.
+/// The xbox_social_user records hold the cold string data and stay where they are since user groups hand out pointers to them.
+/// </summary>
+class social_user_columns
+{
+public:
+    void reset(_In_ size_t capacity);
+    void update(_In_ uint32_t index, _In_ xbox_social_user* user);
+    void clear(_In_ uint32_t index);
+
+    size_t capacity() const { return m_xboxUserIds.size(); }
+    bool is_valid_index(_In_ uint32_t index) const { return index < m_xboxUserIds.size() && m_xboxUserIds[index] != 0; }
+
+    uint64_t xbox_user_id(_In_ uint32_t index) const { return m_xboxUserIds[index]; }
+    xbox_social_user* social_user(_In_ uint32_t index) const { return m_socialUsers[index]; }
+    social_user_flags flags(_In_ uint32_t index) const { return m_flags[index]; }
+    bool has_flag(_In_ uint32_t index, _In_ social_user_flags flag) const { return (m_flags[index] & flag) == flag; }
+    xbox::services::presence::user_presence_state presence_state(_In_ uint32_t index) const { return m_presenceStates[index]; }
+    bool is_user_playing_title(_In_ uint32_t index, _In_ uint32_t titleId) const;
+
+private:
+    xsapi_internal_vector(uint64_t) m_xboxUserIds;
+    xsapi_internal_vector(xbox_social_user*) m_socialUsers;
+    xsapi_internal_vector(social_user_flags) m_flags;
+    xsapi_internal_vector(xbox::services::presence::user_presence_state) m_presenceStates;
+    xsapi_internal_vector(uint32_t) m_presenceTitleIds;     // NUM_PRESENCE_RECORDS entries per user, 0 for empty records
 };
 
 struct xbox_social_user_subscriptions
@@ -136,82 +200,113 @@ struct xbox_social_user_subscriptions
     std::shared_ptr<xbox::services::presence::title_presence_change_subscription> titlePresenceChangeSubscription;
 };
 
+/// <summary>
+/// internal only
+/// Users touched by the social events of one social_graph::do_work, grouped by how a filter group reacts to them.
+/// Built once per graph and shared by all of its groups
+/// </summary>
+struct social_user_group_delta
+{
+    void add_events(
+        _In_ const std::vector<social_event>& socialEvents,
+        _In_ size_t firstEvent
+        );
+
+    xsapi_internal_vector(uint64_t) refilterList;
+    xsapi_internal_vector(uint64_t) addedList;
+    xsapi_internal_vector(uint64_t) removedList;
+};
+
 struct change_struct
 {
     const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)* socialUsers;
+    const social_user_columns* userColumns;
 };
 
+/// <summary>
+/// internal only
+/// Bounded multi-producer single-consumer ring of internal_social_event. Producers (RTA callbacks, HTTP continuations)
+/// never take a lock while the ring has room; events are moved in and moved out so no event data is copied.
+/// If the ring fills up, events spill into a locked overflow queue until the consumer has drained it, so nothing is
+/// dropped and producers never wait on the consumer. Everything in the ring is older than the overflow queue, so the
+/// consumer only reads the overflow queue once every claimed ring slot has been published and popped.
+/// </summary>
 class internal_event_queue
 {
 public:
+    internal_event_queue(_In_ size_t capacity = DEFAULT_CAPACITY);
+
     template<typename T, typename U>
-    void push(_In_ internal_social_event_type socialEventType, _In_ const std::vector<T, U> userList, _In_ const call_buffer_timer_completion_context& completionContext = call_buffer_timer_completion_context())
+    void push(_In_ internal_social_event_type socialEventType, _In_ const std::vector<T, U>& userList, _In_ const call_buffer_timer_completion_context& completionContext = call_buffer_timer_completion_context())
     {
-        std::lock_guard<std::mutex> lock(m_eventMutex.get());
-        std::lock_guard<std::mutex> priorityLock(m_eventPriorityMutex.get());
         auto numGroupsofUsers = userList.size() / MAX_USERS_AFFECTED_PER_EVENT + 1;
         for (uint32_t i = 0; i < numGroupsofUsers; ++i)
         {
             auto endLoc = __min((i + 1) * MAX_USERS_AFFECTED_PER_EVENT, userList.size());
             std::vector<T, U> usersAffected(userList.begin() + i * MAX_USERS_AFFECTED_PER_EVENT, userList.begin() + endLoc);
-            auto evt = internal_social_event(socialEventType, usersAffected);
+            internal_social_event evt(socialEventType, std::move(usersAffected));
             if (i == 0 && !completionContext.isNull)
             {
                 evt.set_completion_context(completionContext);
             }
-            m_eventQueue.push_back(evt);
+            push(std::move(evt));
         }
     }
 
-    void push(_In_ const internal_social_event& socialEvent)
-    {
-        std::lock_guard<std::mutex> lock(m_eventMutex.get());
-        std::lock_guard<std::mutex> priorityLock(m_eventPriorityMutex.get());
-        m_eventQueue.push_back(socialEvent);
-    }
+    void push(_In_ internal_social_event&& socialEvent);
 
-    internal_social_event pop()
-    {
-        std::lock_guard<std::mutex> lock(m_eventMutex.get());
-        std::lock_guard<std::mutex> priorityLock(m_eventPriorityMutex.get());
-        internal_social_event evt = m_eventQueue.front();
-        m_eventQueue.pop_front();
-        return evt;
-    }
+    /// <summary>
+    /// Consumer only. Moves the oldest event into socialEvent, returns false if there was nothing to pop or if the
+    /// oldest event is still being published by its producer.
+    /// </summary>
+    bool try_pop(_Out_ internal_social_event& socialEvent);
 
-    size_t size()
-    {
-        std::lock_guard<std::mutex> lock(m_eventMutex.get());
-        std::lock_guard<std::mutex> priorityLock(m_eventPriorityMutex.get());
-        return m_eventQueue.size();
-    }
+    /// <summary>
+    /// Consumer only. Moves up to maxEvents events onto the end of socialEvents and returns how many were moved.
+    /// </summary>
+    size_t drain(
+        _Inout_ xsapi_internal_vector(internal_social_event)& socialEvents,
+        _In_ size_t maxEvents = SIZE_MAX
+        );
 
-    bool empty(_In_ bool isPriority = false)
-    {
-        if (!isPriority)
-        {
-            std::lock_guard<std::mutex> lock(m_eventMutex.get());
-        }
-        std::lock_guard<std::mutex> priorityLock(m_eventPriorityMutex.get());
-        return m_eventQueue.empty();
-    }
+    /// <summary>
+    /// The number of events in the queue, not counting ring slots that have been claimed but not written yet
+    /// </summary>
+    size_t size() const;
+
+    bool empty() const;
 
 private:
-    static const uint32_t MAX_USERS_AFFECTED_PER_EVENT = 10;
+    internal_event_queue(const internal_event_queue&);
+    internal_event_queue& operator=(const internal_event_queue&);
 
-    bool m_useLock;
-    xsapi_internal_dequeue(internal_social_event) m_eventQueue;
-    xbox::services::system::xbox_live_mutex m_eventMutex;
-    xbox::services::system::xbox_live_mutex m_eventPriorityMutex;
+    bool try_push_ring(_Inout_ internal_social_event& socialEvent);
+    bool try_pop_ring(_Out_ internal_social_event& socialEvent);
+
+    static const uint32_t MAX_USERS_AFFECTED_PER_EVENT = 10;
+    static const size_t DEFAULT_CAPACITY = 256;
+
+    size_t m_mask;
+    xsapi_internal_vector(internal_social_event) m_events;
+    std::unique_ptr<std::atomic<size_t>[]> m_sequences;
+    std::atomic<size_t> m_enqueuePos;
+    std::atomic<size_t> m_dequeuePos;
+    std::atomic<size_t> m_publishedCount;
+
+    std::atomic<size_t> m_overflowCount;
+    xsapi_internal_dequeue(internal_social_event) m_overflowQueue;
+    xbox::services::system::xbox_live_mutex m_overflowMutex;
 };
 
 struct user_buffer
 {
-    user_buffer() : buffer(nullptr) {}
+    // the cached queue only holds the events applied to the other buffer since the last swap
+    user_buffer() : buffer(nullptr), socialUserEventQueue(32) {}
 
     byte* buffer;
     std::queue<byte*> freeData;
     xsapi_internal_unordered_map(uint64_t, xbox_social_user_context) socialUserGraph;
+    social_user_columns userColumns;
     internal_event_queue socialUserEventQueue;
 };
 
@@ -231,13 +326,18 @@ public:
     user_buffer* inactive_buffer();
 
     void add_event(
-        _In_ const internal_social_event& internalSocialEvent
+        _Inout_ internal_social_event&& internalSocialEvent
         );
 
     void add_users_to_buffer(_In_ const std::vector<xbox_social_user>& users, _Inout_ user_buffer& userBufferInactive, _In_ size_t finalSize = 0);
 
     void remove_users_from_buffer(_In_ const std::vector<uint64_t>& users, _Inout_ user_buffer& userBufferInactive);
 
+    /// <summary>
+    /// Re-reads the hot fields of a user after its xbox_social_user record was modified in place
+    /// </summary>
+    static void refresh_user_columns(_Inout_ user_buffer& userBuffer, _In_ const xbox_social_user_context& userContext);
+
     static void initialize_users_in_map(_Inout_ user_buffer& userBuffer, _In_ size_t numUsers, _In_ size_t bufferOffset);
 
 protected:
@@ -362,6 +462,63 @@ private:
 };
 
 
+/// <summary>
+/// internal only
+/// Change lists produced by diffing a freshly fetched social graph against the inactive buffer
+/// </summary>
+struct social_graph_diff
+{
+    xsapi_internal_vector(xbox_social_user) usersAddedList;
+    xsapi_internal_vector(uint64_t) usersRemovedList;
+    xsapi_internal_vector(social_manager_presence_record) presenceChangeList;
+    xsapi_internal_vector(xbox_social_user) socialRelationshipChangeList;
+    xsapi_internal_vector(xbox_social_user) profileChangeList;
+};
+
+/// <summary>
+/// internal only
+/// Picks the users each rich presence poll asks for. Users who are online or whose presence just changed are
+/// polled every round, everyone else is polled half as often after each poll that finds nothing new, down to
+/// once every MAX_IDLE_POLL_INTERVAL rounds. Not thread safe, social_graph uses it under m_socialGraphStateMutex.
+/// </summary>
+class presence_poll_scheduler
+{
+public:
+    static const uint32_t MAX_IDLE_POLL_INTERVAL = 8;
+
+    presence_poll_scheduler();
+
+    /// <summary>
+    /// Starts the next round and returns the users due a poll in it. Users that left the graph are forgotten.
+    /// </summary>
+    std::vector<string_t> next_round(
+        _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& socialUserGraph
+        );
+
+    void on_presence_polled(
+        _In_ uint64_t xboxUserId,
+        _In_ bool hasChanged,
+        _In_ bool isOnline
+        );
+
+    /// <summary>
+    /// Number of rounds between polls of the user, 0 if the user isn't scheduled
+    /// </summary>
+    uint32_t poll_interval(_In_ uint64_t xboxUserId) const;
+
+private:
+    struct poll_state
+    {
+        poll_state() : interval(1), nextRound(0) {}
+
+        uint32_t interval;
+        uint64_t nextRound;
+    };
+
+    uint64_t m_round;
+    xsapi_internal_unordered_map(uint64_t, poll_state) m_pollStates;
+};
+
 class social_graph : public std::enable_shared_from_this<social_graph>
 {
 public:
@@ -395,6 +552,17 @@ public:
 
     const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)* active_buffer_social_graph();
 
+    const social_user_columns* active_buffer_user_columns();
+
+    /// <summary>
+    /// Walks the fetched graph and the previous graph once each, without copying either, and fills in the change lists
+    /// </summary>
+    static void compute_diff(
+        _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user)& xboxSocialUsers,
+        _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& previousSocialUsers,
+        _Inout_ social_graph_diff& socialGraphDiff
+        );
+
 protected:
     static const std::chrono::minutes REFRESH_TIME_MIN;
 
@@ -514,6 +682,7 @@ protected:
     std::shared_ptr<xbox_live_context_impl> m_xboxLiveContextImpl;
     std::shared_ptr<call_buffer_timer> m_presenceRefreshTimer;
     std::shared_ptr<call_buffer_timer> m_presencePollingTimer;
+    presence_poll_scheduler m_presencePollScheduler;
     std::shared_ptr<call_buffer_timer> m_socialGraphRefreshTimer;
     std::shared_ptr<call_buffer_timer> m_resyncRefreshTimer;
     std::shared_ptr<xbox::services::social::social_relationship_change_subscription> m_socialRelationshipChangeSubscription;
@@ -527,6 +696,7 @@ protected:
     xbox::services::perf_tester m_perfTester;
     event_queue m_socialEventQueue;
     internal_event_queue m_internalEventQueue;
+    xsapi_internal_vector(internal_social_event) m_eventBatch;
     user_buffers_holder m_userBuffer;
 };
 
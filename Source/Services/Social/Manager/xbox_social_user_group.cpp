@@ -10,6 +10,40 @@ using namespace xbox::services::presence;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_BEGIN
 
+void
+social_user_group_delta::add_events(
+    _In_ const std::vector<social_event>& socialEvents,
+    _In_ size_t firstEvent
+    )
+{
+    for (size_t i = firstEvent; i < socialEvents.size(); ++i)
+    {
+        const auto& evt = socialEvents[i];
+        xsapi_internal_vector(uint64_t)* targetList = nullptr;
+        switch (evt.event_type())
+        {
+        case social_event_type::presence_changed:
+        case social_event_type::profiles_changed:
+        case social_event_type::social_relationships_changed:
+            targetList = &refilterList;
+            break;
+        case social_event_type::users_added_to_social_graph:
+            targetList = &addedList;
+            break;
+        case social_event_type::users_removed_from_social_graph:
+            targetList = &removedList;
+            break;
+        default:
+            continue;
+        }
+
+        for (auto& user : evt.users_affected())
+        {
+            targetList->push_back(utils::string_t_to_uint64(user.xbox_user_id()));
+        }
+    }
+}
+
 xbox_social_user_group::xbox_social_user_group(
     _In_ string_t viewHash,
     _In_ presence_filter presenceFilter,
@@ -24,7 +58,8 @@ xbox_social_user_group::xbox_social_user_group(
     m_xboxLiveUser(xboxLiveUser),
     m_userGroupType(social_user_group_type::filter_type),
     m_detailLevel(social_manager_extra_detail_level::no_extra_detail),
-    m_needsUpdate(true)
+    m_needsUpdate(true),
+    m_lastSnapshot(nullptr)
 {
 }
 
@@ -40,7 +75,8 @@ xbox_social_user_group::xbox_social_user_group(
     m_relationshipFilter(relationship_filter::friends),
     m_detailLevel(social_manager_extra_detail_level::no_extra_detail),
     m_titleId(0),
-    m_needsUpdate(true)
+    m_needsUpdate(true),
+    m_lastSnapshot(nullptr)
 {
     for (auto& user : userList)
     {
@@ -51,8 +87,10 @@ xbox_social_user_group::xbox_social_user_group(
             continue;
         }
 
-        m_userUpdateListString.push_back(user.c_str());
-        m_userUpdateListInt.push_back(id);
+        if (m_userPositions.find(id) == m_userPositions.end())
+        {
+            add_tracked_user(id, user.c_str());
+        }
     }
 }
 
@@ -83,6 +121,9 @@ xbox_social_user_group::destroy()
     m_userUpdateListInt.clear();
     m_userGroupVector.clear();
     m_userUpdateListString.clear();
+    m_userPositions.clear();
+    m_userIndices.clear();
+    m_lastSnapshot = nullptr;
 }
 
 const std::vector<uint64_t>&
@@ -94,7 +135,8 @@ xbox_social_user_group::tracking_users()
 
 void xbox_social_user_group::update_view(
     _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& snapshotList,
-    _In_ const std::vector<social_event>& socialEvents
+    _In_opt_ const social_user_columns* userColumns,
+    _In_ const social_user_group_delta& groupDelta
     )
 {
     std::lock_guard<std::mutex> lock(m_groupMutex);
@@ -102,7 +144,8 @@ void xbox_social_user_group::update_view(
     {
         filter_list(
             snapshotList,
-            socialEvents
+            userColumns,
+            groupDelta
             );
     }
     else if (m_userGroupType == social_user_group_type::user_list_type)
@@ -112,13 +155,10 @@ void xbox_social_user_group::update_view(
             m_userGroupVector.clear();
             for (auto userUpdateInt : m_userUpdateListInt)
             {
-                if (snapshotList.find(userUpdateInt) != snapshotList.end())
+                auto userIter = snapshotList.find(userUpdateInt);
+                if (userIter != snapshotList.end() && userIter->second.socialUser != nullptr)
                 {
-                    auto socialUser = snapshotList.at(userUpdateInt).socialUser;
-                    if (socialUser != nullptr)
-                    {
-                        m_userGroupVector.push_back(socialUser);
-                    }
+                    m_userGroupVector.push_back(userIter->second.socialUser);
                 }
             }
         }
@@ -145,213 +185,172 @@ void xbox_social_user_group::update_view(
 
 void
 xbox_social_user_group::initialize_filter_list(
-    _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& users
+    _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& users,
+    _In_opt_ const social_user_columns* userColumns
     )
 {
     std::lock_guard<std::mutex> lock(m_groupMutex);
-    std::vector<uint64_t> resultVec;
+    destroy();
+    m_lastSnapshot = &users;
+
     for (auto& userPairMap : users)
     {
-        auto user = userPairMap.second.socialUser;
-        if (user == nullptr)
+        if (userPairMap.second.socialUser == nullptr)
         {
             continue;
         }
-        if ((m_relationshipFilter == relationship_filter::favorite && user->is_favorite()) ||
-            (m_relationshipFilter == relationship_filter::friends && user->is_followed_by_caller())
-            )
-        {
-            bool userValid = get_presence_filter_result(
-                user,
-                m_presenceFilter
-            );
-
-            if (userValid)
-            {
-                m_userUpdateListInt.push_back(userPairMap.first);
-                m_userGroupVector.push_back(user);
 
-                m_userUpdateListString.push_back(userPairMap.second.socialUser->xbox_user_id());
-            }
+        if (get_filter_result(userPairMap.second, userColumns))
+        {
+            add_group_user(userPairMap.first, userPairMap.second);
         }
     }
 }
 
 void
-xbox_social_user_group::remove_users(
-    _In_ const std::vector<xbox_removal_struct>& usersToRemove
+xbox_social_user_group::add_tracked_user(
+    _In_ uint64_t xboxUserId,
+    _In_ const char_t* xboxUserIdString
+    )
+{
+    m_userPositions[xboxUserId] = m_userUpdateListInt.size();
+    m_userUpdateListInt.push_back(xboxUserId);
+    m_userUpdateListString.push_back(xboxUserIdString);
+}
+
+void
+xbox_social_user_group::add_group_user(
+    _In_ uint64_t xboxUserId,
+    _In_ const xbox_social_user_context& userContext
+    )
+{
+    add_tracked_user(xboxUserId, userContext.socialUser->xbox_user_id());
+    m_userGroupVector.push_back(userContext.socialUser);
+    m_userIndices.push_back(userContext.index);
+}
+
+void
+xbox_social_user_group::remove_user_at(
+    _In_ size_t position
     )
 {
-    for (auto& userRemovalStruct : usersToRemove)
+    // swap with the last entry so removal does not shift the rest of the group
+    bool isFilterGroup = m_userGroupType == social_user_group_type::filter_type;
+    size_t lastPosition = m_userUpdateListInt.size() - 1;
+    m_userPositions.erase(m_userUpdateListInt[position]);
+    if (position != lastPosition)
     {
-        for (auto userUpdateIter = m_userUpdateListString.begin(); userUpdateIter != m_userUpdateListString.end(); ++userUpdateIter)
+        m_userUpdateListInt[position] = m_userUpdateListInt[lastPosition];
+        m_userUpdateListString[position] = m_userUpdateListString[lastPosition];
+        if (isFilterGroup)
         {
-            const char_t* xuid = userUpdateIter->xbox_user_id();
-            if (utils::char_t_cmp(xuid, userRemovalStruct.xuidContainer.xbox_user_id()) == 0)
-            {
-                m_userUpdateListString.erase(userUpdateIter);
-                break;
-            }
-        }
-        for (auto userUpdateIter = m_userGroupVector.begin(); userUpdateIter != m_userGroupVector.end(); ++userUpdateIter)
-        {
-            auto xuid = (*userUpdateIter)->_Xbox_user_id_as_integer();
-            if (xuid == userRemovalStruct.xuidNum)
-            {
-                m_userGroupVector.erase(userUpdateIter);
-                break;
-            }
-        }
-        for (auto userUpdateIter = m_userUpdateListInt.begin(); userUpdateIter != m_userUpdateListInt.end(); ++userUpdateIter)
-        {
-            auto xuidAsInt = *userUpdateIter;
-            if (xuidAsInt == userRemovalStruct.xuidNum)
-            {
-                m_userUpdateListInt.erase(userUpdateIter);
-                break;
-            }
+            m_userGroupVector[position] = m_userGroupVector[lastPosition];
+            m_userIndices[position] = m_userIndices[lastPosition];
         }
+
+        m_userPositions[m_userUpdateListInt[position]] = position;
+    }
+
+    m_userUpdateListInt.pop_back();
+    m_userUpdateListString.pop_back();
+    if (isFilterGroup)
+    {
+        m_userGroupVector.pop_back();
+        m_userIndices.pop_back();
     }
 }
 
 void
-xbox_social_user_group::filter_list(
+xbox_social_user_group::rebase_users(
     _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& snapshotList,
-    _In_ const std::vector<social_event>& socialEvents
+    _In_opt_ const social_user_columns* userColumns
     )
 {
-    std::vector<xbox_user_id_container> refilterList;
-    std::vector<xbox_user_id_container> addedList;
-    std::vector<xbox_user_id_container> removeList;
-    std::vector<xbox_removal_struct> removalStructList;
-
-    for (auto& evt : socialEvents)
+    // Pointers only move when the graph swaps its buffers, which hands out a different snapshot
+    if (m_lastSnapshot == &snapshotList)
     {
-        switch (evt.event_type())
-        {
-        case social_event_type::presence_changed:
-        case social_event_type::profiles_changed:
-        case social_event_type::social_relationships_changed:
-            refilterList.insert(refilterList.end(), evt.users_affected().begin(), evt.users_affected().end());
-            break;
-        case social_event_type::users_added_to_social_graph:
-            addedList.insert(addedList.end(), evt.users_affected().begin(), evt.users_affected().end());
-            break;
-        case social_event_type::users_removed_from_social_graph:
-            removeList.insert(removeList.end(), evt.users_affected().begin(), evt.users_affected().end());
-            break;
-        }
+        return;
     }
-    for (auto& userStr : refilterList)
+    m_lastSnapshot = &snapshotList;
+
+    size_t position = 0;
+    while (position < m_userUpdateListInt.size())
     {
-        uint64_t userInt = utils::string_t_to_uint64(userStr.xbox_user_id());
-        auto userPair = snapshotList.find(userInt);
-        if (userPair == snapshotList.end())
+        uint64_t xuid = m_userUpdateListInt[position];
+        uint32_t index = m_userIndices[position];
+        if (userColumns != nullptr && userColumns->is_valid_index(index) && userColumns->xbox_user_id(index) == xuid)
         {
+            m_userGroupVector[position] = userColumns->social_user(index);
+            ++position;
             continue;
         }
 
-        auto user = userPair->second.socialUser;
-        if (user == nullptr)
+        auto userIter = snapshotList.find(xuid);
+        if (userIter == snapshotList.end() || userIter->second.socialUser == nullptr)
         {
+            remove_user_at(position);
             continue;
         }
-        if ((m_relationshipFilter == relationship_filter::favorite && user->is_favorite()) ||
-            (m_relationshipFilter == relationship_filter::friends && user->is_followed_by_caller())
-            )
-        {
-            bool userValid = get_presence_filter_result(
-                user,
-                m_presenceFilter
-            );
-
-            if (!userValid)
-            {
-                xbox_removal_struct xboxRemovalStruct;
-                xboxRemovalStruct.xuidContainer = userStr.xbox_user_id();
-                xboxRemovalStruct.xuidNum = userInt;
-
-                removalStructList.push_back(xboxRemovalStruct);
-            }
-            else
-            {
-                // check if added
-                bool wasFound = false;
-                for (auto& updateUserInt : m_userUpdateListInt)
-                {
-                    if (updateUserInt == userInt)
-                    {
-                        wasFound = true;
-                        break;
-                    }
-                }
 
-                if (!wasFound)
-                {
-                    m_userUpdateListString.push_back(userStr.xbox_user_id());
-                    m_userUpdateListInt.push_back(userInt);
-                    m_userGroupVector.push_back(user);
-                }
-            }
-        }
+        m_userGroupVector[position] = userIter->second.socialUser;
+        m_userIndices[position] = userIter->second.index;
+        ++position;
     }
-    
-    for (auto& userStr : addedList)
+}
+
+void
+xbox_social_user_group::refilter_user(
+    _In_ uint64_t xboxUserId,
+    _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& snapshotList,
+    _In_opt_ const social_user_columns* userColumns
+    )
+{
+    auto userPair = snapshotList.find(xboxUserId);
+    if (userPair == snapshotList.end() || userPair->second.socialUser == nullptr)
     {
-        uint64_t userInt = utils::string_t_to_uint64(userStr.xbox_user_id());
-        auto userPair = snapshotList.find(userInt);
-        if (userPair == snapshotList.end())
-        {
-            continue;
-        }
+        return;
+    }
 
-        auto user = userPair->second.socialUser;
-        if (user == nullptr)
-        {
-            continue;
-        }
-        if ((m_relationshipFilter == relationship_filter::favorite && user->is_favorite()) ||
-            (m_relationshipFilter == relationship_filter::friends && user->is_followed_by_caller())
-            )
+    auto positionIter = m_userPositions.find(xboxUserId);
+    bool isInGroup = positionIter != m_userPositions.end();
+    if (get_filter_result(userPair->second, userColumns))
+    {
+        if (!isInGroup)
         {
-            bool userValid = get_presence_filter_result(
-                user,
-                m_presenceFilter
-            );
-
-            if (userValid)
-            {
-                m_userUpdateListString.push_back(userStr.xbox_user_id());
-                m_userUpdateListInt.push_back(userInt);
-                m_userGroupVector.push_back(user);
-            }
+            add_group_user(xboxUserId, userPair->second);
         }
     }
-
-    for (auto& userStr : removeList)
+    else if (isInGroup)
     {
-        uint64_t userInt = utils::string_t_to_uint64(userStr.xbox_user_id());
-        xbox_removal_struct xboxRemovalStruct;
-        
-        xboxRemovalStruct.xuidContainer = userStr;
-        xboxRemovalStruct.xuidNum = userInt;
+        remove_user_at(positionIter->second);
+    }
+}
+
+void
+xbox_social_user_group::filter_list(
+    _In_ const xsapi_internal_unordered_map(uint64_t, xbox_social_user_context)& snapshotList,
+    _In_opt_ const social_user_columns* userColumns,
+    _In_ const social_user_group_delta& groupDelta
+    )
+{
+    rebase_users(snapshotList, userColumns);
 
-        removalStructList.push_back(xboxRemovalStruct);
+    for (auto xuid : groupDelta.refilterList)
+    {
+        refilter_user(xuid, snapshotList, userColumns);
     }
 
-    if (!removalStructList.empty())
+    for (auto xuid : groupDelta.addedList)
     {
-        remove_users(removalStructList);
+        refilter_user(xuid, snapshotList, userColumns);
     }
 
-    m_userGroupVector.clear();
-    for (auto& userInt : m_userUpdateListInt)
+    for (auto xuid : groupDelta.removedList)
     {
-        auto userIter = snapshotList.find(userInt);
-        if (userIter != snapshotList.end())
+        auto positionIter = m_userPositions.find(xuid);
+        if (positionIter != m_userPositions.end())
         {
-            auto& user = userIter->second.socialUser;
-            m_userGroupVector.push_back(user);
+            remove_user_at(positionIter->second);
         }
     }
 }
@@ -368,9 +367,8 @@ xbox_social_user_group::_Update_users_in_group(
     _In_ const std::vector<string_t>& userList
     )
 {
-    xsapi_internal_unordered_map(uint64_t, uint32_t) changeMap;
-    xsapi_internal_vector(uint64_t) userIdList;
-    userIdList.reserve(userList.size());
+    xsapi_internal_unordered_map(uint64_t, uint32_t) requestedUsers;
+    requestedUsers.reserve(userList.size());
 
     user_group_status_change changeGroups;
     for (auto& user : userList)
@@ -383,63 +381,28 @@ xbox_social_user_group::_Update_users_in_group(
             continue;
         }
 
-        userIdList.push_back(id);
-        bool userFound = false;
-        for (auto userInt : m_userUpdateListInt)
-        {
-            if (userInt == id)
-            {
-                userFound = true;
-                break;
-            }
-        }
-        if (userFound)
+        requestedUsers[id] = 1;
+        if (m_userPositions.find(id) != m_userPositions.end())
         {
             continue;
         }
 
         changeGroups.addGroup.push_back(user);
-        m_userUpdateListInt.push_back(id);
-
-        m_userUpdateListString.push_back(user.c_str());
+        add_tracked_user(id, user.c_str());
     }
 
-    std::vector<uint64_t> userCompareList(m_userUpdateListInt);
-    for (auto updateUser : userCompareList)
+    size_t position = 0;
+    while (position < m_userUpdateListInt.size())
     {
-        bool wasFound = false;
-        for (auto userId : userIdList)
-        {
-            if (userId == updateUser)
-            {
-                wasFound = true;
-            }
-        }
-
-        if (!wasFound)
+        auto updateUser = m_userUpdateListInt[position];
+        if (requestedUsers.find(updateUser) == requestedUsers.end())
         {
             changeGroups.removeGroup.push_back(updateUser);
-            
-            for (std::vector<uint64_t>::iterator i = m_userUpdateListInt.begin(); i != m_userUpdateListInt.end(); ++i)
-            {
-                if (*i == updateUser)
-                {
-                    m_userUpdateListInt.erase(i);
-                    break;
-                }
-            }
-
-            for (auto i = m_userUpdateListString.begin(); i != m_userUpdateListString.end(); ++i)
-            {
-                stringstream_t str;
-                str << updateUser;
-                if (utils::str_icmp(i->xbox_user_id(), str.str()) == 0)
-                {
-                    m_userUpdateListString.erase(i);
-                    break;
-                }
-            }
+            remove_user_at(position);
+            continue;
         }
+
+        ++position;
     }
 
     if (!changeGroups.addGroup.empty() || !changeGroups.removeGroup.empty())
@@ -505,6 +468,60 @@ xbox_social_user_group::get_presence_filter_result(
     }
 }
 
+bool
+xbox_social_user_group::is_relationship_match(
+    _In_ const xbox_social_user_context& userContext,
+    _In_opt_ const social_user_columns* userColumns
+    ) const
+{
+    if (userColumns != nullptr && userColumns->is_valid_index(userContext.index))
+    {
+        return (m_relationshipFilter == relationship_filter::favorite && userColumns->has_flag(userContext.index, social_user_flags::favorite)) ||
+            (m_relationshipFilter == relationship_filter::friends && userColumns->has_flag(userContext.index, social_user_flags::followed_by_caller));
+    }
+
+    auto user = userContext.socialUser;
+    return user != nullptr &&
+        ((m_relationshipFilter == relationship_filter::favorite && user->is_favorite()) ||
+        (m_relationshipFilter == relationship_filter::friends && user->is_followed_by_caller()));
+}
+
+bool
+xbox_social_user_group::get_filter_result(
+    _In_ const xbox_social_user_context& userContext,
+    _In_opt_ const social_user_columns* userColumns
+    ) const
+{
+    if (!is_relationship_match(userContext, userColumns))
+    {
+        return false;
+    }
+
+    if (userColumns == nullptr || !userColumns->is_valid_index(userContext.index))
+    {
+        return get_presence_filter_result(userContext.socialUser, m_presenceFilter);
+    }
+
+    auto index = userContext.index;
+    switch (m_presenceFilter)
+    {
+    case presence_filter::all:
+        return true;
+    case presence_filter::all_offline:
+        return userColumns->presence_state(index) == user_presence_state::offline;
+    case presence_filter::all_online:
+        return userColumns->presence_state(index) == user_presence_state::online;
+    case presence_filter::all_title:
+        return userColumns->has_flag(index, social_user_flags::has_played_title);
+    case presence_filter::title_offline:
+        return userColumns->presence_state(index) == user_presence_state::offline && userColumns->has_flag(index, social_user_flags::has_played_title);
+    case presence_filter::title_online:
+        return userColumns->is_user_playing_title(index, m_titleId);
+    default:
+        return false;
+    }
+}
+
 std::vector<xbox_social_user*>
 xbox_social_user_group::get_users_from_xbox_user_ids(
     _In_ const std::vector<xbox_user_id_container>& xboxUserIds
@@ -56,7 +56,8 @@ public:
         );
 
     xbox_live_result<std::shared_ptr<social_relationship_change_subscription>> subscribe_to_social_relationship_change(
-        _In_ const string_t& xboxUserId
+        _In_ const string_t& xboxUserId,
+        _In_ xbox::services::real_time_activity::real_time_activity_subscription_priority priority = xbox::services::real_time_activity::real_time_activity_subscription_priority::normal
         );
     
     xbox_live_result<void> unsubscribe_from_social_relationship_change(
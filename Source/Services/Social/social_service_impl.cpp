@@ -26,7 +26,8 @@ social_service_impl::social_service_impl(
 
 xbox_live_result<std::shared_ptr<social_relationship_change_subscription>>
 social_service_impl::subscribe_to_social_relationship_change(
-    _In_ const string_t& xboxUserId
+    _In_ const string_t& xboxUserId,
+    _In_ xbox::services::real_time_activity::real_time_activity_subscription_priority priority
     )
 {
     std::weak_ptr<social_service_impl> thisWeakPtr = shared_from_this();
@@ -50,6 +51,8 @@ social_service_impl::subscribe_to_social_relationship_change(
         })
         );
 
+    // Set before the subscription is queued so it is sent in priority order
+    socialRelationshipSub->set_priority(priority);
     auto subscriptionSucceed = m_realTimeActivityService->_Add_subscription(
         socialRelationshipSub
         );
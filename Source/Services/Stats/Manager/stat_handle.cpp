@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "xsapi/stats_manager.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_STAT_MANAGER_CPP_BEGIN
+
+static const uint32_t INVALID_SLOT = UINT32_MAX;
+
+stat_handle::stat_handle() :
+    m_userSlot(INVALID_SLOT),
+    m_statIndex(INVALID_SLOT)
+{
+}
+
+stat_handle::stat_handle(
+    _In_ uint32_t userSlot,
+    _In_ uint32_t statIndex
+    ) :
+    m_userSlot(userSlot),
+    m_statIndex(statIndex)
+{
+}
+
+bool
+stat_handle::is_valid() const
+{
+    return m_userSlot != INVALID_SLOT && m_statIndex != INVALID_SLOT;
+}
+
+uint32_t
+stat_handle::_User_slot() const
+{
+    return m_userSlot;
+}
+
+uint32_t
+stat_handle::_Stat_index() const
+{
+    return m_statIndex;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_STAT_MANAGER_CPP_END
\ No newline at end of file
@@ -0,0 +1,370 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include <fstream>
+#include <iomanip>
+#include "xsapi/stats_manager.h"
+#include "stats_manager_internal.h"
+
+using namespace xbox::services;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_STAT_MANAGER_CPP_BEGIN
+
+static uint32_t crc32(
+    _In_ const char* data,
+    _In_ size_t length
+    )
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; ++i)
+    {
+        crc ^= static_cast<unsigned char>(data[i]);
+        for (uint32_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
+
+stats_journal::stats_journal(
+    _In_ string_t filePath
+    ) :
+    m_filePath(std::move(filePath)),
+    m_nextSequence(1),
+    m_recordCountAfterCompaction(0),
+    m_uncommittedCount(0)
+{
+}
+
+xbox_live_result<void>
+stats_journal::open()
+{
+    m_records.clear();
+    m_uncommittedCount = 0;
+
+    std::ifstream journalFile(m_filePath, std::ios_base::in | std::ios_base::binary);
+    if (!journalFile.is_open())
+    {
+        // Nothing journaled yet
+        return xbox_live_result<void>();
+    }
+
+    bool isCorrupt = false;
+    std::string line;
+    while (std::getline(journalFile, line))
+    {
+        stats_journal_record record;
+        if (!try_parse_record(line, record))
+        {
+            isCorrupt = true;
+            break;
+        }
+
+        m_nextSequence = __max(m_nextSequence, record.sequence + 1);
+        m_records.push_back(std::move(record));
+    }
+
+    journalFile.close();
+    m_recordCountAfterCompaction = m_records.size();
+
+    if (isCorrupt)
+    {
+        // Only the last append can be torn, keep everything before it
+        LOGS_ERROR << "Stats journal " << m_filePath << " is corrupt after " << m_records.size() << " records, dropping the rest";
+        return rewrite();
+    }
+
+    return xbox_live_result<void>();
+}
+
+void
+stats_journal::record_set_stat(
+    _In_ const string_t& statName,
+    _In_ double statValue
+    )
+{
+    stats_journal_record record;
+    record.eventType = svd_event_type::stat_change;
+    record.dataType = stat_data_type::number;
+    record.name = statName;
+    record.numberValue = statValue;
+    add_record(std::move(record));
+}
+
+void
+stats_journal::record_set_stat(
+    _In_ const string_t& statName,
+    _In_ const char_t* statValue
+    )
+{
+    stats_journal_record record;
+    record.eventType = svd_event_type::stat_change;
+    record.dataType = stat_data_type::string;
+    record.name = statName;
+    record.stringValue = statValue;
+    add_record(std::move(record));
+}
+
+void
+stats_journal::record_delete_stat(
+    _In_ const string_t& statName
+    )
+{
+    stats_journal_record record;
+    record.eventType = svd_event_type::stat_delete;
+    record.name = statName;
+    add_record(std::move(record));
+}
+
+xbox_live_result<void>
+stats_journal::commit()
+{
+    if (m_uncommittedCount == 0)
+    {
+        return xbox_live_result<void>();
+    }
+
+    if (m_records.size() >= __max(COMPACTION_THRESHOLD, 2 * m_recordCountAfterCompaction) && compact())
+    {
+        return rewrite();
+    }
+
+    std::string lines;
+    for (size_t i = m_records.size() - m_uncommittedCount; i < m_records.size(); ++i)
+    {
+        lines += serialize_record(m_records[i]);
+    }
+
+    std::ofstream journalFile(m_filePath, std::ios_base::out | std::ios_base::binary | std::ios_base::app);
+    if (journalFile.is_open())
+    {
+        journalFile.write(lines.c_str(), lines.size());
+        journalFile.flush();
+    }
+
+    if (!journalFile.is_open() || !journalFile.good())
+    {
+        LOGS_ERROR << "Failed to append to stats journal " << m_filePath;
+        return xbox_live_result<void>(xbox_live_error_code::runtime_error, "Failed to write stats journal");
+    }
+
+    m_uncommittedCount = 0;
+    return xbox_live_result<void>();
+}
+
+void
+stats_journal::replay(
+    _Inout_ stats_value_document& svd
+    ) const
+{
+    for (const auto& record : m_records)
+    {
+        if (record.eventType == svd_event_type::stat_delete)
+        {
+            svd.delete_stat(record.name.c_str());
+        }
+        else if (record.dataType == stat_data_type::number)
+        {
+            svd.set_stat(record.name.c_str(), record.numberValue);
+        }
+        else
+        {
+            svd.set_stat(record.name.c_str(), record.stringValue.c_str());
+        }
+    }
+}
+
+uint64_t
+stats_journal::last_sequence() const
+{
+    return m_nextSequence - 1;
+}
+
+xbox_live_result<void>
+stats_journal::checkpoint(
+    _In_ uint64_t sequence
+    )
+{
+    size_t committedCount = m_records.size() - m_uncommittedCount;
+    auto firstKept = std::find_if(m_records.begin(), m_records.end(), [sequence](const stats_journal_record& record)
+    {
+        return record.sequence > sequence;
+    });
+
+    size_t droppedCount = firstKept - m_records.begin();
+    if (droppedCount == 0)
+    {
+        return xbox_live_result<void>();
+    }
+
+    m_records.erase(m_records.begin(), firstKept);
+    m_uncommittedCount -= droppedCount > committedCount ? droppedCount - committedCount : 0;
+    m_recordCountAfterCompaction = m_records.size();
+    return rewrite();
+}
+
+size_t
+stats_journal::record_count() const
+{
+    return m_records.size();
+}
+
+void
+stats_journal::add_record(
+    _In_ stats_journal_record record
+    )
+{
+    record.sequence = m_nextSequence++;
+    m_records.push_back(std::move(record));
+    ++m_uncommittedCount;
+}
+
+bool
+stats_journal::compact()
+{
+    // Only the last change to each stat matters on replay
+    std::unordered_map<string_t, size_t> lastRecordForStat;
+    for (size_t i = 0; i < m_records.size(); ++i)
+    {
+        lastRecordForStat[m_records[i].name] = i;
+    }
+
+    if (lastRecordForStat.size() == m_records.size())
+    {
+        m_recordCountAfterCompaction = m_records.size();
+        return false;
+    }
+
+    std::vector<stats_journal_record> records;
+    records.reserve(lastRecordForStat.size());
+    for (size_t i = 0; i < m_records.size(); ++i)
+    {
+        if (lastRecordForStat[m_records[i].name] == i)
+        {
+            records.push_back(std::move(m_records[i]));
+        }
+    }
+
+    m_records.swap(records);
+    m_recordCountAfterCompaction = m_records.size();
+    return true;
+}
+
+xbox_live_result<void>
+stats_journal::rewrite()
+{
+    // Uncommitted records are written too, the new file replaces everything on disk
+    std::string lines;
+    for (const auto& record : m_records)
+    {
+        lines += serialize_record(record);
+    }
+
+    // Write the new journal beside the old one and swap it in, so a crash part way leaves one of them whole
+    string_t tempFilePath = m_filePath + _T(".tmp");
+    std::ofstream journalFile(tempFilePath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (journalFile.is_open())
+    {
+        journalFile.write(lines.c_str(), lines.size());
+        journalFile.flush();
+    }
+
+    bool isWritten = journalFile.is_open() && journalFile.good();
+    journalFile.close();
+    if (!isWritten || !utils::replace_file(tempFilePath, m_filePath))
+    {
+        LOGS_ERROR << "Failed to rewrite stats journal " << m_filePath;
+        utils::delete_file(tempFilePath);
+        return xbox_live_result<void>(xbox_live_error_code::runtime_error, "Failed to write stats journal");
+    }
+
+    m_uncommittedCount = 0;
+    return xbox_live_result<void>();
+}
+
+std::string
+stats_journal::serialize_record(
+    _In_ const stats_journal_record& record
+    )
+{
+    web::json::value recordJson;
+    recordJson[_T("seq")] = web::json::value::number(record.sequence);
+    recordJson[_T("name")] = web::json::value::string(record.name);
+    if (record.eventType == svd_event_type::stat_delete)
+    {
+        recordJson[_T("op")] = web::json::value::string(_T("delete"));
+    }
+    else
+    {
+        recordJson[_T("op")] = web::json::value::string(_T("set"));
+        recordJson[_T("value")] = record.dataType == stat_data_type::number ?
+            web::json::value::number(record.numberValue) :
+            web::json::value::string(record.stringValue);
+    }
+
+    // <crc32 of the json> <json>
+    std::string payload = utility::conversions::to_utf8string(recordJson.serialize());
+    std::ostringstream line;
+    line << std::hex << std::setw(8) << std::setfill('0') << crc32(payload.c_str(), payload.size()) << ' ' << payload << '\n';
+    return line.str();
+}
+
+bool
+stats_journal::try_parse_record(
+    _In_ const std::string& line,
+    _Out_ stats_journal_record& record
+    )
+{
+    record = stats_journal_record();
+    if (line.size() < 10 || line[8] != ' ')
+    {
+        return false;
+    }
+
+    std::string payload = line.substr(9);
+    uint32_t checksum = 0;
+    std::istringstream checksumStream(line.substr(0, 8));
+    if (!(checksumStream >> std::hex >> checksum) || checksum != crc32(payload.c_str(), payload.size()))
+    {
+        return false;
+    }
+
+    try
+    {
+        auto recordJson = web::json::value::parse(utility::conversions::to_string_t(payload));
+        std::error_code errc = xbox_live_error_code::no_error;
+        record.sequence = utils::extract_json_uint52(recordJson, _T("seq"), errc, true);
+        record.name = utils::extract_json_string(recordJson, _T("name"), errc, true);
+        string_t op = utils::extract_json_string(recordJson, _T("op"), errc, true);
+        if (op == _T("delete"))
+        {
+            record.eventType = svd_event_type::stat_delete;
+        }
+        else
+        {
+            record.eventType = svd_event_type::stat_change;
+            auto value = utils::extract_json_field(recordJson, _T("value"), errc, true);
+            if (value.is_number())
+            {
+                record.dataType = stat_data_type::number;
+                record.numberValue = value.as_double();
+            }
+            else if (value.is_string())
+            {
+                record.dataType = stat_data_type::string;
+                record.stringValue = value.as_string();
+            }
+        }
+
+        return !errc && !record.name.empty() && (record.eventType == svd_event_type::stat_delete || record.dataType != stat_data_type::undefined);
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_STAT_MANAGER_CPP_END
@@ -56,6 +56,20 @@ stats_manager::request_flush_to_service(
         );
 }
 
+xbox_live_result<void>
+stats_manager::enable_offline_journal(
+    _In_ const string_t& journalDirectory
+    )
+{
+    return m_statsManagerImpl->enable_offline_journal(journalDirectory);
+}
+
+stats_upload_stats
+stats_manager::_Upload_stats()
+{
+    return m_statsManagerImpl->upload_stats();
+}
+
 std::vector<stat_event>
 stats_manager::do_work()
 {
@@ -140,6 +154,62 @@ stats_manager::delete_stat(
         );
 }
 
+xbox_live_result<stat_handle>
+stats_manager::get_stat_handle(
+    _In_ const xbox_live_user_t& user,
+    _In_ const string_t& statName
+    )
+{
+    return m_statsManagerImpl->get_stat_handle(
+        user,
+        statName
+        );
+}
+
+xbox_live_result<void>
+stats_manager::set_stat_as_number(
+    _In_ const stat_handle& statHandle,
+    _In_ double statValue
+    )
+{
+    return m_statsManagerImpl->set_stat(
+        statHandle,
+        statValue
+        );
+}
+
+xbox_live_result<void>
+stats_manager::set_stat_as_integer(
+    _In_ const stat_handle& statHandle,
+    _In_ int64_t statValue
+    )
+{
+    return m_statsManagerImpl->set_stat(
+        statHandle,
+        static_cast<double>(statValue)
+        );
+}
+
+xbox_live_result<void>
+stats_manager::set_stat_as_string(
+    _In_ const stat_handle& statHandle,
+    _In_ const string_t& statValue
+    )
+{
+    return m_statsManagerImpl->set_stat(
+        statHandle,
+        statValue.c_str()
+        );
+}
+
+xbox_live_result<stat_value>
+stats_manager::get_stat(
+    _In_ const stat_handle& statHandle
+    )
+{
+    return m_statsManagerImpl->get_stat(statHandle);
+}
+
 xbox_live_result<void> stats_manager::get_leaderboard(
     const xbox_live_user_t& user, 
     const string_t& statName, 
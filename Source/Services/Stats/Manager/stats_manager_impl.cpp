@@ -88,6 +88,27 @@ stats_manager_impl::run_flush_timer()
     });
 }
 
+xbox_live_result<void>
+stats_manager_impl::enable_offline_journal(
+    _In_ const string_t& journalDirectory
+    )
+{
+    if (journalDirectory.empty())
+    {
+        return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "Journal directory is empty");
+    }
+
+    if (!utils::create_directory(journalDirectory))
+    {
+        LOGS_ERROR << "Failed to create stats journal directory " << journalDirectory;
+        return xbox_live_result<void>(xbox_live_error_code::runtime_error, "Failed to create stats journal directory");
+    }
+
+    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
+    m_journalDirectory = journalDirectory;
+    return xbox_live_result<void>();
+}
+
 xbox_live_result<void>
 stats_manager_impl::add_local_user(
     _In_ const xbox_live_user_t& user
@@ -110,7 +131,20 @@ stats_manager_impl::add_local_user(
         xboxLiveContextImpl->application_config()
         );
 
-    m_users[userStr] = stats_user_context(stats_value_document(), xboxLiveContextImpl, simplifiedStatsService, user);
+    std::shared_ptr<stats_journal> journal;
+    if (!m_journalDirectory.empty())
+    {
+        journal = std::make_shared<stats_journal>(m_journalDirectory + _T("\\stats_") + userStr + _T(".journal"));
+        if (journal->open().err())
+        {
+            journal = nullptr;
+        }
+    }
+
+    auto& statsUserContext = m_users[userStr];
+    statsUserContext = stats_user_context(stats_value_document(), xboxLiveContextImpl, simplifiedStatsService, user, journal);
+    statsUserContext.slot = static_cast<uint32_t>(m_userSlots.size());
+    m_userSlots.push_back(&statsUserContext);
     std::weak_ptr<stats_manager_impl> thisWeak = shared_from_this();
     simplifiedStatsService.get_stats_value_document()
     .then([thisWeak, user, xboxLiveContextImpl, simplifiedStatsService, userStr](xbox_live_result<stats_value_document> statsValueDocResult)
@@ -143,6 +177,15 @@ stats_manager_impl::add_local_user(
                 {
                     userStatContext->second.statValueDocument.merge_stat_value_documents(svd);
                 }
+
+                // Changes left from an earlier session are applied over the loaded values by the next do_work. If
+                // the document is offline they reach the service through the merge done on the next flush.
+                auto& journal = userStatContext->second.journal;
+                if (journal != nullptr && journal->record_count() > 0)
+                {
+                    LOGS_INFO << "Replaying " << journal->record_count() << " journaled stat changes";
+                    journal->replay(userStatContext->second.statValueDocument);
+                }
             }
 
             userStatContext->second.statValueDocument.set_flush_function([thisWeak, userStr, user]()
@@ -191,11 +234,15 @@ stats_manager_impl::remove_local_user(
     auto statsUserContext = userIter->second;
     auto userSVD = statsUserContext.statValueDocument;
     userSVD.do_work();  // before removing the user apply all users
+    commit_journal(statsUserContext);
     if (userSVD.is_dirty())
     {
         std::weak_ptr<stats_manager_impl> thisWeak = shared_from_this();
-        userIter->second.simplifiedStatsService.update_stats_value_document(userSVD)
-        .then([thisWeak, userSVD, user, userStr](xbox_live_result<void> updateSVDResult)
+        auto journal = statsUserContext.journal;
+        uint64_t journalSequence = journal != nullptr ? journal->last_sequence() : 0;
+        stats_upload_info uploadInfo;
+        userIter->second.simplifiedStatsService.update_stats_value_document(userSVD, &uploadInfo)
+        .then([thisWeak, userSVD, user, userStr, journal, journalSequence, uploadInfo](xbox_live_result<void> updateSVDResult)
         {
             std::shared_ptr<stats_manager_impl> pThis(thisWeak.lock());
             if (pThis == nullptr)
@@ -210,19 +257,24 @@ stats_manager_impl::remove_local_user(
                 return;
             }
 
+            pThis->record_upload(uploadInfo);
             if(should_write_offline(updateSVDResult))
             {
                 pThis->write_offline(statsUserContextIter->second);
             }
+            else if (!updateSVDResult.err() && journal != nullptr)
+            {
+                journal->checkpoint(journalSequence);
+            }
 
             pThis->m_statEventList.push_back(stat_event(stat_event_type::local_user_removed, user, updateSVDResult));
-            pThis->m_users.erase(userStr);
+            pThis->erase_user(statsUserContextIter);
         });
     }
     else
     {
         m_statEventList.push_back(stat_event(stat_event_type::local_user_removed, user, xbox_live_result<void>()));
-        m_users.erase(userIter);
+        erase_user(userIter);
     }
 
     return xbox_live_result<void>();
@@ -316,8 +368,13 @@ stats_manager_impl::update_stats_value_document(_In_ stats_user_context& statsUs
 
     auto userStr = user_context::get_user_id(user);
 
-    statsUserContext.simplifiedStatsService.update_stats_value_document(statsUserContext.statValueDocument)
-    .then([thisWeak, user, userStr](xbox_live_result<void> updateSVDResult)
+    // Everything journaled so far is in the document being sent, so it can go once the service accepts it
+    commit_journal(statsUserContext);
+    uint64_t journalSequence = statsUserContext.journal != nullptr ? statsUserContext.journal->last_sequence() : 0;
+
+    stats_upload_info uploadInfo;
+    statsUserContext.simplifiedStatsService.update_stats_value_document(statsUserContext.statValueDocument, &uploadInfo)
+    .then([thisWeak, user, userStr, journalSequence, uploadInfo](xbox_live_result<void> updateSVDResult)
     {
         std::shared_ptr<stats_manager_impl> pThis(thisWeak.lock());
         if (pThis == nullptr)
@@ -333,6 +390,7 @@ stats_manager_impl::update_stats_value_document(_In_ stats_user_context& statsUs
         }
 
         auto& statsUserContext = statsUserContextIter->second;
+        pThis->record_upload(uploadInfo);
         if (updateSVDResult.err())
         {
             if (should_write_offline(updateSVDResult))
@@ -349,11 +407,32 @@ stats_manager_impl::update_stats_value_document(_In_ stats_user_context& statsUs
                 LOG_ERROR("Stats manager could not write stats value document");
             }
         }
+        else if (statsUserContext.journal != nullptr)
+        {
+            statsUserContext.journal->checkpoint(journalSequence);
+        }
 
         pThis->m_statEventList.push_back(stat_event(stat_event_type::stat_update_complete, user, updateSVDResult));
     });
 }
 
+void
+stats_manager_impl::record_upload(
+    _In_ const stats_upload_info& uploadInfo
+    )
+{
+    ++m_uploadStats.uploadCount;
+    m_uploadStats.lastUploadSizeInBytes = uploadInfo.sizeInBytes;
+    m_uploadStats.totalUploadSizeInBytes += uploadInfo.sizeInBytes;
+}
+
+stats_upload_stats
+stats_manager_impl::upload_stats()
+{
+    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
+    return m_uploadStats;
+}
+
 void
 stats_manager_impl::request_flush_to_service_callback(
     _In_ const string_t& userXuid
@@ -364,6 +443,7 @@ stats_manager_impl::request_flush_to_service_callback(
     if (userIter != m_users.end())
     {
         userIter->second.statValueDocument.do_work();
+        commit_journal(userIter->second);
         flush_to_service(
             userIter->second
             );
@@ -378,6 +458,7 @@ stats_manager_impl::do_work()
     for (auto& statUserContext : m_users)
     {
         statUserContext.second.statValueDocument.do_work();
+        commit_journal(statUserContext.second);
     }
     m_statEventList.clear();
 
@@ -398,7 +479,15 @@ stats_manager_impl::set_stat(
     {
         return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User not found in local map");
     }
-    auto result = userIter->second.statValueDocument.set_stat(name.c_str(), value);
+    auto& statsUserContext = userIter->second;
+    auto result = statsUserContext.statValueDocument.set_stat(name.c_str(), value);
+
+    // Changes made before the document loads are dropped by its do_work, so they are not journaled either
+    if (!result.err() && statsUserContext.journal != nullptr && statsUserContext.statValueDocument.state() != svd_state::not_loaded)
+    {
+        statsUserContext.journal->record_set_stat(name, value);
+    }
+
     return result;
 }
 
@@ -417,7 +506,15 @@ stats_manager_impl::set_stat(
         return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User not found in local map");
     }
 
-    auto result = userIter->second.statValueDocument.set_stat(name.c_str(), value);
+    auto& statsUserContext = userIter->second;
+    auto result = statsUserContext.statValueDocument.set_stat(name.c_str(), value);
+
+    // Changes made before the document loads are dropped by its do_work, so they are not journaled either
+    if (!result.err() && statsUserContext.journal != nullptr && statsUserContext.statValueDocument.state() != svd_state::not_loaded)
+    {
+        statsUserContext.journal->record_set_stat(name, value);
+    }
+
     return result;
 }
 
@@ -471,25 +568,138 @@ stats_manager_impl::delete_stat(
         return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User not found in local map");
     }
 
-    return userIter->second.statValueDocument.delete_stat(name.c_str());
+    auto& statsUserContext = userIter->second;
+    auto result = statsUserContext.statValueDocument.delete_stat(name.c_str());
+    if (!result.err() && statsUserContext.journal != nullptr && statsUserContext.statValueDocument.state() != svd_state::not_loaded)
+    {
+        statsUserContext.journal->record_delete_stat(name);
+    }
+
+    return result;
+}
+
+xbox_live_result<stat_handle>
+stats_manager_impl::get_stat_handle(
+    _In_ const xbox_live_user_t& user,
+    _In_ const string_t& name
+    )
+{
+    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
+    string_t userStr = user_context::get_user_id(user);
+    auto userIter = m_users.find(userStr);
+    if (userIter == m_users.end())
+    {
+        return xbox_live_result<stat_handle>(xbox_live_error_code::invalid_argument, "User not found in local map");
+    }
+
+    auto& statsUserContext = userIter->second;
+    return stat_handle(statsUserContext.slot, statsUserContext.statValueDocument.intern_stat(name.c_str()));
+}
+
+xbox_live_result<void>
+stats_manager_impl::set_stat(
+    _In_ const stat_handle& statHandle,
+    _In_ double value
+    )
+{
+    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
+    auto statsUserContext = find_user(statHandle);
+    if (statsUserContext == nullptr)
+    {
+        return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User not found in local map");
+    }
+
+    auto& svd = statsUserContext->statValueDocument;
+    auto result = svd.set_stat(statHandle._Stat_index(), value);
+    if (!result.err() && statsUserContext->journal != nullptr && svd.state() != svd_state::not_loaded)
+    {
+        statsUserContext->journal->record_set_stat(svd.stat_name(statHandle._Stat_index()), value);
+    }
+
+    return result;
+}
+
+xbox_live_result<void>
+stats_manager_impl::set_stat(
+    _In_ const stat_handle& statHandle,
+    _In_ const char_t* value
+    )
+{
+    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
+    auto statsUserContext = find_user(statHandle);
+    if (statsUserContext == nullptr)
+    {
+        return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "User not found in local map");
+    }
+
+    auto& svd = statsUserContext->statValueDocument;
+    auto result = svd.set_stat(statHandle._Stat_index(), value);
+    if (!result.err() && statsUserContext->journal != nullptr && svd.state() != svd_state::not_loaded)
+    {
+        statsUserContext->journal->record_set_stat(svd.stat_name(statHandle._Stat_index()), value);
+    }
+
+    return result;
+}
+
+xbox_live_result<stat_value>
+stats_manager_impl::get_stat(
+    _In_ const stat_handle& statHandle
+    )
+{
+    std::lock_guard<std::mutex> guard(m_statsServiceMutex);
+    auto statsUserContext = find_user(statHandle);
+    if (statsUserContext == nullptr)
+    {
+        return xbox_live_result<stat_value>(xbox_live_error_code::invalid_argument, "User not found in local map");
+    }
+
+    return statsUserContext->statValueDocument.get_stat(statHandle._Stat_index());
+}
+
+stats_user_context*
+stats_manager_impl::find_user(
+    _In_ const stat_handle& statHandle
+    )
+{
+    return statHandle._User_slot() < m_userSlots.size() ? m_userSlots[statHandle._User_slot()] : nullptr;
 }
 
-#if TV_API
 void
-stats_manager_impl::write_offline(
-    _In_ stats_user_context& userContext
+stats_manager_impl::erase_user(
+    _In_ std::unordered_map<string_t, stats_user_context>::iterator userIter
     )
 {
-    UNREFERENCED_PARAMETER(userContext);
-    // TODO: implement
+    m_userSlots[userIter->second.slot] = nullptr;
+    m_users.erase(userIter);
+}
+
+void
+stats_manager_impl::commit_journal(
+    _In_ stats_user_context& statsUserContext
+    )
+{
+    if (statsUserContext.journal != nullptr && statsUserContext.journal->commit().err())
+    {
+        LOG_ERROR("Stats manager could not write the offline journal");
+    }
 }
 
-#elif !UNIT_TEST_SERVICES
 void
 stats_manager_impl::write_offline(
     _In_ stats_user_context& userContext
     )
 {
+    if (userContext.journal != nullptr)
+    {
+        // The journal already holds every change the service hasn't accepted, they are replayed when the user is next added
+        commit_journal(userContext);
+        return;
+    }
+
+#if TV_API
+    // TODO: implement
+#elif !UNIT_TEST_SERVICES
     web::json::value evtJson;
     evtJson[_T("svd")] = userContext.statValueDocument.serialize();
     auto result = userContext.xboxLiveContextImpl->events_service().write_in_game_event(_T("StatEvent"), evtJson, web::json::value());
@@ -497,16 +707,8 @@ stats_manager_impl::write_offline(
     {
         LOG_ERROR("Offline write for stats failed");
     }
-}
-#else
-void
-stats_manager_impl::write_offline(
-    _In_ stats_user_context& userContext
-)
-{
-    UNREFERENCED_PARAMETER(userContext);
-}
 #endif
+}
 
 xbox_live_result<void> stats_manager_impl::get_leaderboard(const xbox_live_user_t& user, const string_t& statName, leaderboard::leaderboard_query query)
 {
@@ -32,13 +32,14 @@ enum class svd_state
 struct stat_pending_state
 {
     stat_pending_state() :
-        statDataType(stat_data_type::undefined)
+        statDataType(stat_data_type::undefined),
+        statIndex(0)
     {
-        initialize_char_arr(statPendingName);
     }
 
     stat_data_type statDataType;
-    char_t statPendingName[STAT_PRESENCE_CHARS_NUM];
+    // Index of the stat in the document's stat table, see stats_value_document::intern_stat
+    uint32_t statIndex;
     stat_data statPendingData;
 };
 
@@ -57,7 +58,9 @@ private:
 };
 
 /// internal class
-/// The stat value document holds all of the stat information in an unordered map
+/// The stat value document holds all of the stat information in a table indexed by stat handle.
+/// A stat name is hashed once, when it is first seen, to give it a slot in the table. The slot is never reused
+/// for another name, so handles stay valid across deletes and merges for the lifetime of the document.
 class stats_value_document
 {
 public:
@@ -79,6 +82,31 @@ public:
         _In_ const char_t* statValue
         );
 
+    /// <summary>
+    /// Returns the index of the stat's slot in the table, adding an empty slot if the name is new
+    /// </summary>
+    uint32_t intern_stat(
+        _In_ const char_t* statName
+        );
+
+    xbox_live_result<stat_value> get_stat(
+        _In_ uint32_t statIndex
+        ) const;
+
+    xbox_live_result<void> set_stat(
+        _In_ uint32_t statIndex,
+        _In_ double statValue
+        );
+
+    xbox_live_result<void> set_stat(
+        _In_ uint32_t statIndex,
+        _In_ const char_t* statValue
+        );
+
+    const char_t* stat_name(
+        _In_ uint32_t statIndex
+        ) const;
+
     void get_stat_names(
         _Inout_ std::vector<string_t>& statNameList
         ) const;
@@ -118,7 +146,33 @@ private:
     std::function<void()> m_fRequestFlush;
     xsapi_internal_string m_clientId;
     xsapi_internal_vector(svd_event) m_svdEventList;
-    xsapi_internal_unordered_map(string_t, stat_value) m_statisticDocument;
+    // Slots for deleted or not yet loaded stats keep their name but have an undefined data type
+    xsapi_internal_vector(stat_value) m_stats;
+    xsapi_internal_unordered_map(string_t, uint32_t) m_statIndices;
+};
+
+struct stats_upload_info
+{
+    stats_upload_info() :
+        sizeInBytes(0)
+    {
+    }
+
+    uint64_t sizeInBytes;
+};
+
+struct stats_upload_stats
+{
+    stats_upload_stats() :
+        uploadCount(0),
+        lastUploadSizeInBytes(0),
+        totalUploadSizeInBytes(0)
+    {
+    }
+
+    uint64_t uploadCount;
+    uint64_t lastUploadSizeInBytes;
+    uint64_t totalUploadSizeInBytes;
 };
 
 /// internal class
@@ -134,8 +188,12 @@ public:
         _In_ std::shared_ptr<xbox::services::xbox_live_app_config> appConfig
         );
 
+    /// <summary>
+    /// Posts the whole document, the service deletes any stat missing from it
+    /// </summary>
     pplx::task<xbox_live_result<void>> update_stats_value_document(
-        _In_ stats_value_document& statValuePostDocument
+        _In_ stats_value_document& statValuePostDocument,
+        _Out_opt_ stats_upload_info* uploadInfo = nullptr
         );
 
     pplx::task<xbox_live_result<stats_value_document>> get_stats_value_document();
@@ -152,19 +210,112 @@ private:
     std::shared_ptr<xbox::services::xbox_live_app_config> m_appConfig;
 };
 
+struct stats_journal_record
+{
+    stats_journal_record() :
+        sequence(0),
+        eventType(svd_event_type::unknown),
+        dataType(stat_data_type::undefined),
+        numberValue(0)
+    {
+    }
+
+    uint64_t sequence;
+    svd_event_type eventType;
+    stat_data_type dataType;
+    string_t name;
+    double numberValue;
+    string_t stringValue;
+};
+
+/// internal class
+/// Append-only journal on disk of the stat changes a user made since the service last accepted a flush.
+/// Changes are recorded as the title makes them and written out in one append per do_work, and are dropped once
+/// a flush that includes them succeeds. Whatever is left when the user is next added is replayed into their stats
+/// value document, so stats written offline or before a crash reach the service with the next flush. Every line
+/// carries a CRC32 of its record and loading stops at the first line that fails it, which drops a torn last write.
+/// Not thread safe, stats_manager_impl guards it with its own lock.
+class stats_journal
+{
+public:
+    // Superseded records are only compacted away once the journal holds at least this many
+    static const size_t COMPACTION_THRESHOLD = 256;
+
+    stats_journal(_In_ string_t filePath);
+
+    /// <summary>
+    /// Loads the records left from earlier sessions
+    /// </summary>
+    xbox_live_result<void> open();
+
+    void record_set_stat(
+        _In_ const string_t& statName,
+        _In_ double statValue
+        );
+
+    void record_set_stat(
+        _In_ const string_t& statName,
+        _In_ const char_t* statValue
+        );
+
+    void record_delete_stat(
+        _In_ const string_t& statName
+        );
+
+    /// <summary>
+    /// Appends every record made since the last commit to the file
+    /// </summary>
+    xbox_live_result<void> commit();
+
+    /// <summary>
+    /// Queues every journaled change on the document, to be applied by its next do_work
+    /// </summary>
+    void replay(_Inout_ stats_value_document& svd) const;
+
+    uint64_t last_sequence() const;
+
+    /// <summary>
+    /// Drops every record up to and including sequence, once the service has accepted them
+    /// </summary>
+    xbox_live_result<void> checkpoint(_In_ uint64_t sequence);
+
+    size_t record_count() const;
+
+private:
+    void add_record(_In_ stats_journal_record record);
+    bool compact();
+    xbox_live_result<void> rewrite();
+
+    static std::string serialize_record(_In_ const stats_journal_record& record);
+    static bool try_parse_record(
+        _In_ const std::string& line,
+        _Out_ stats_journal_record& record
+        );
+
+    string_t m_filePath;
+    uint64_t m_nextSequence;
+    size_t m_recordCountAfterCompaction;
+    // Oldest first; the last m_uncommittedCount records have not been written to the file yet
+    std::vector<stats_journal_record> m_records;
+    size_t m_uncommittedCount;
+};
+
 struct stats_user_context
 {
-    stats_user_context() {}
+    stats_user_context() : slot(0) {}
     stats_user_context(
         _In_ stats_value_document _statValueDoc,
         _In_ std::shared_ptr<xbox_live_context_impl> _xboxLiveContextImpl,
         _In_ simplified_stats_service _simplifiedStatsService,
-        _In_ xbox_live_user_t  _xboxLiveUser
+        _In_ xbox_live_user_t  _xboxLiveUser,
+        _In_ std::shared_ptr<stats_journal> _journal = nullptr
     ) :
         statValueDocument(std::move(_statValueDoc)),
         xboxLiveContextImpl(std::move(_xboxLiveContextImpl)),
         simplifiedStatsService(std::move(_simplifiedStatsService)),
-        xboxLiveUser(std::move(_xboxLiveUser))
+        xboxLiveUser(std::move(_xboxLiveUser)),
+        journal(std::move(_journal)),
+        slot(0)
     {
     }
 
@@ -172,6 +323,10 @@ struct stats_user_context
     std::shared_ptr<xbox_live_context_impl> xboxLiveContextImpl;
     xbox_live_user_t xboxLiveUser;
     simplified_stats_service simplifiedStatsService;
+    // Null unless the title enabled the offline journal before adding the user
+    std::shared_ptr<stats_journal> journal;
+    // Index in stats_manager_impl::m_userSlots, which stat handles refer to the user by
+    uint32_t slot;
 };
 
 class stats_manager_impl : public std::enable_shared_from_this<stats_manager_impl>
@@ -221,8 +376,33 @@ public:
         _In_ const string_t& name
         );
 
+    xbox_live_result<stat_handle> get_stat_handle(
+        _In_ const xbox_live_user_t& user,
+        _In_ const string_t& name
+        );
+
+    xbox_live_result<void> set_stat(
+        _In_ const stat_handle& statHandle,
+        _In_ double value
+        );
+
+    xbox_live_result<void> set_stat(
+        _In_ const stat_handle& statHandle,
+        _In_ const char_t* value
+        );
+
+    xbox_live_result<stat_value> get_stat(
+        _In_ const stat_handle& statHandle
+        );
+
     void initialize();
 
+    xbox_live_result<void> enable_offline_journal(
+        _In_ const string_t& journalDirectory
+        );
+
+    stats_upload_stats upload_stats();
+
     xbox_live_result<void> get_leaderboard(
         _In_ const xbox_live_user_t& user,
         _In_ const string_t& statName,
@@ -263,14 +443,27 @@ private:
 
     void run_flush_timer();
 
+    void commit_journal(_In_ stats_user_context& statsUserContext);
+
+    void record_upload(_In_ const stats_upload_info& uploadInfo);
+
+    stats_user_context* find_user(_In_ const stat_handle& statHandle);
+
+    void erase_user(_In_ std::unordered_map<string_t, stats_user_context>::iterator userIter);
+
     static const std::chrono::seconds TIME_PER_CALL_SEC;
     static const std::chrono::milliseconds STATS_POLL_TIME_MS;
 
     std::vector<stat_event> m_statEventList;
     std::vector<xbox::services::xbox_live_result<leaderboard::leaderboard_result>> m_leaderboardResults;
     std::unordered_map<string_t, stats_user_context> m_users;
+    // Users by the slot handed out when they were added, null once removed. Slots are never reused so stale
+    // handles can't reach a different user. Elements of m_users don't move, so the pointers stay valid.
+    std::vector<stats_user_context*> m_userSlots;
     std::shared_ptr<xbox::services::call_buffer_timer> m_statTimer;
     std::shared_ptr<xbox::services::call_buffer_timer> m_statPriorityTimer;
+    string_t m_journalDirectory;
+    stats_upload_stats m_uploadStats;
     // TODO: change back to xsapi_internal_string
     std::mutex m_statsServiceMutex;
 };
@@ -10,6 +10,37 @@
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_STAT_MANAGER_CPP_BEGIN
 
+// Size of the body once the http layer encodes it as UTF-8, without making the copy
+static uint64_t utf8_size(
+    _In_ const string_t& value
+    )
+{
+#ifndef _UTF16_STRINGS
+    return value.size();
+#else
+    uint64_t size = 0;
+    for (auto c : value)
+    {
+        uint32_t codeUnit = static_cast<uint32_t>(c);
+        if (codeUnit < 0x80)
+        {
+            size += 1;
+        }
+        else if (codeUnit < 0x800 || (codeUnit >= 0xD800 && codeUnit <= 0xDFFF))
+        {
+            // Each half of a surrogate pair accounts for 2 of the pair's 4 bytes
+            size += 2;
+        }
+        else
+        {
+            size += 3;
+        }
+    }
+
+    return size;
+#endif
+}
+
 simplified_stats_service::simplified_stats_service()
 {
 }
@@ -27,11 +58,18 @@ simplified_stats_service::simplified_stats_service(
 
 pplx::task<xbox_live_result<void>>
 simplified_stats_service::update_stats_value_document(
-    _In_ stats_value_document& statValuePostDocument
+    _In_ stats_value_document& statValuePostDocument,
+    _Out_opt_ stats_upload_info* uploadInfo
     )
 {
     statValuePostDocument.increment_revision();
 
+    string_t requestBody = statValuePostDocument.serialize().serialize();
+    if (uploadInfo != nullptr)
+    {
+        uploadInfo->sizeInBytes = utf8_size(requestBody);
+    }
+
     string_t pathAndQuery = pathandquery_simplified_stats_subpath(
         m_userContext->xbox_user_id(),
         m_appConfig->scid(),
@@ -46,7 +84,7 @@ simplified_stats_service::update_stats_value_document(
         xbox_live_api::update_stats_value_document
         );
 
-    httpCall->set_request_body(statValuePostDocument.serialize());
+    httpCall->set_request_body(requestBody);
 
     auto task = httpCall->get_response_with_auth(m_userContext, http_call_response_body_type::json_body)
     .then([](std::shared_ptr<http_call_response> response)
@@ -15,7 +15,34 @@ stats_value_document::stats_value_document() :
     m_state(svd_state::not_loaded)
 {
     m_svdEventList.reserve(100);
-    m_statisticDocument.reserve(20);
+    m_stats.reserve(20);
+    m_statIndices.reserve(20);
+}
+
+uint32_t
+stats_value_document::intern_stat(
+    _In_ const char_t* statName
+    )
+{
+    auto statIndexIter = m_statIndices.find(statName);
+    if (statIndexIter != m_statIndices.end())
+    {
+        return statIndexIter->second;
+    }
+
+    uint32_t statIndex = static_cast<uint32_t>(m_stats.size());
+    m_stats.push_back(stat_value());
+    m_stats.back().set_name(statName);
+    m_statIndices[statName] = statIndex;
+    return statIndex;
+}
+
+const char_t*
+stats_value_document::stat_name(
+    _In_ uint32_t statIndex
+    ) const
+{
+    return statIndex < m_stats.size() ? m_stats[statIndex].m_name : nullptr;
 }
 
 xbox_live_result<stat_value>
@@ -23,13 +50,26 @@ stats_value_document::get_stat(
     _In_ const char_t* statName
     ) const
 {
-    auto statLocIter = m_statisticDocument.find(statName);
-    if (statLocIter == m_statisticDocument.end())
+    auto statIndexIter = m_statIndices.find(statName);
+    if (statIndexIter == m_statIndices.end())
+    {
+        return xbox_live_result<stat_value>(xbox_live_error_code::invalid_argument, "Stat not found in document");
+    }
+
+    return get_stat(statIndexIter->second);
+}
+
+xbox_live_result<stat_value>
+stats_value_document::get_stat(
+    _In_ uint32_t statIndex
+    ) const
+{
+    if (statIndex >= m_stats.size() || m_stats[statIndex].data_type() == stat_data_type::undefined)
     {
         return xbox_live_result<stat_value>(xbox_live_error_code::invalid_argument, "Stat not found in document");
     }
 
-    return statLocIter->second;
+    return m_stats[statIndex];
 }
 
 xbox_live_result<void>
@@ -38,8 +78,31 @@ stats_value_document::set_stat(
     _In_ double statValue
     )
 {
+    return set_stat(intern_stat(statName), statValue);
+}
+
+xbox_live_result<void>
+stats_value_document::set_stat(
+    _In_ const char_t* statName,
+    _In_ const char_t* statValue
+    )
+{
+    return set_stat(intern_stat(statName), statValue);
+}
+
+xbox_live_result<void>
+stats_value_document::set_stat(
+    _In_ uint32_t statIndex,
+    _In_ double statValue
+    )
+{
+    if (statIndex >= m_stats.size())
+    {
+        return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "Invalid stat handle");
+    }
+
     stat_pending_state statPendingState;
-    utils::char_t_copy(statPendingState.statPendingName, ARRAYSIZE(statPendingState.statPendingName), statName);
+    statPendingState.statIndex = statIndex;
     statPendingState.statDataType = stat_data_type::number;
     statPendingState.statPendingData.numberType = statValue;
 
@@ -49,12 +112,17 @@ stats_value_document::set_stat(
 
 xbox_live_result<void>
 stats_value_document::set_stat(
-    _In_ const char_t* statName,
+    _In_ uint32_t statIndex,
     _In_ const char_t* statValue
     )
 {
+    if (statIndex >= m_stats.size())
+    {
+        return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "Invalid stat handle");
+    }
+
     stat_pending_state statPendingState;
-    utils::char_t_copy(statPendingState.statPendingName, ARRAYSIZE(statPendingState.statPendingName), statName);
+    statPendingState.statIndex = statIndex;
     statPendingState.statDataType = stat_data_type::string;
     utils::char_t_copy(statPendingState.statPendingData.stringType, ARRAYSIZE(statPendingState.statPendingData.stringType), statValue);
     m_svdEventList.push_back(svd_event(statPendingState));
@@ -67,9 +135,12 @@ stats_value_document::get_stat_names(
     ) const
 {
     statNameList.clear();
-    for (auto& stat : m_statisticDocument)
+    for (auto& stat : m_stats)
     {
-        statNameList.push_back(stat.first.c_str());
+        if (stat.data_type() != stat_data_type::undefined)
+        {
+            statNameList.push_back(stat.m_name);
+        }
     }
 }
 
@@ -79,7 +150,7 @@ stats_value_document::delete_stat(
     )
 {
     stat_pending_state statPendingState;
-    utils::char_t_copy(statPendingState.statPendingName, ARRAYSIZE(statPendingState.statPendingName), statName);
+    statPendingState.statIndex = intern_stat(statName);
     m_svdEventList.push_back(svd_event(statPendingState, svd_event_type::stat_delete));
     return xbox_live_result<void>();
 }
@@ -114,22 +185,21 @@ stats_value_document::do_work()
         for (auto& svdEvent : m_svdEventList)
         {
             auto& pendingStat = svdEvent.stat_info();
+            auto& stat = m_stats[pendingStat.statIndex];
             switch (svdEvent.event_type())
             {
                 case svd_event_type::stat_change:
                 {
-                    auto statIter = m_statisticDocument.find(pendingStat.statPendingName);
-
                     switch (pendingStat.statDataType)
                     {
                         case stat_data_type::number:
-                            m_statisticDocument[pendingStat.statPendingName].set_stat(
+                            stat.set_stat(
                                 pendingStat.statPendingData.numberType
                                 );
                             break;
 
                         case stat_data_type::string:
-                            m_statisticDocument[pendingStat.statPendingName].set_stat(pendingStat.statPendingData.stringType);
+                            stat.set_stat(pendingStat.statPendingData.stringType);
                             break;
                     }
 
@@ -137,7 +207,7 @@ stats_value_document::do_work()
                     break;
                 }
                 case svd_event_type::stat_delete:
-                    m_statisticDocument.erase(pendingStat.statPendingName);
+                    stat.m_dataType = stat_data_type::undefined;
                     break;
             }
         }
@@ -174,23 +244,40 @@ stats_value_document::merge_stat_value_documents(
     _In_ const stats_value_document& mergeSVD
     )
 {
+    // Stats are matched up by name since the two documents interned them in different orders
     switch (m_state)
     {
         case svd_state::not_loaded:
             m_revision = mergeSVD.m_revision;
-            m_statisticDocument = mergeSVD.m_statisticDocument;
+            for (auto& stat : m_stats)
+            {
+                stat.m_dataType = stat_data_type::undefined;
+            }
+
+            for (auto& stat : mergeSVD.m_stats)
+            {
+                if (stat.data_type() != stat_data_type::undefined)
+                {
+                    m_stats[intern_stat(stat.m_name)] = stat;
+                }
+            }
             break;
 
         // for offline the stat values local override any service values
         // only add any undefined stats into our list
         case svd_state::offline_not_loaded:
         case svd_state::offline_loaded:
-            for (auto& stat : mergeSVD.m_statisticDocument)
+            for (auto& stat : mergeSVD.m_stats)
             {
-                auto statIter = m_statisticDocument.find(stat.first);
-                if (statIter == m_statisticDocument.end())
+                if (stat.data_type() == stat_data_type::undefined)
                 {
-                    m_statisticDocument[stat.first] = stat.second;
+                    continue;
+                }
+
+                auto& localStat = m_stats[intern_stat(stat.m_name)];
+                if (localStat.data_type() == stat_data_type::undefined)
+                {
+                    localStat = stat;
                 }
             }
             break;
@@ -224,9 +311,12 @@ stats_value_document::serialize()
 
     auto& titleField = statsField[_T("title")];
     titleField = web::json::value::object();
-    for (auto& stat : m_statisticDocument)
+    for (auto& stat : m_stats)
     {
-        titleField[stat.first.c_str()] = stat.second.serialize();
+        if (stat.data_type() != stat_data_type::undefined)
+        {
+            titleField[stat.m_name] = stat.serialize();
+        }
     }
 
     return requestJSON;
@@ -250,8 +340,9 @@ stats_value_document::_Deserialize(
     auto statsArray = titleField.as_object();
     for (auto& stat : statsArray)
     {
-        returnObject.m_statisticDocument[stat.first.c_str()] = stat_value::_Deserialize(stat.second).payload();
-        returnObject.m_statisticDocument[stat.first.c_str()].set_name(stat.first);
+        auto& statValue = returnObject.m_stats[returnObject.intern_stat(stat.first.c_str())];
+        statValue = stat_value::_Deserialize(stat.second).payload();
+        statValue.set_name(stat.first);
     }
 
     return returnObject;
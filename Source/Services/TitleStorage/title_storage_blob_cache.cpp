@@ -0,0 +1,391 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include <fstream>
+#include "title_storage_internal.h"
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_BEGIN
+
+static const string_t BLOB_CACHE_INDEX_FILE_NAME = _T("blobcache.json");
+static const std::chrono::seconds BLOB_CACHE_INDEX_SAVE_INTERVAL(30);
+
+title_storage_blob_cache_stats::title_storage_blob_cache_stats() :
+    m_hitCount(0),
+    m_missCount(0),
+    m_sizeInBytes(0),
+    m_blobCount(0)
+{
+}
+
+title_storage_blob_cache_stats::title_storage_blob_cache_stats(
+    _In_ uint64_t hitCount,
+    _In_ uint64_t missCount,
+    _In_ uint64_t sizeInBytes,
+    _In_ uint32_t blobCount
+    ) :
+    m_hitCount(hitCount),
+    m_missCount(missCount),
+    m_sizeInBytes(sizeInBytes),
+    m_blobCount(blobCount)
+{
+}
+
+uint64_t
+title_storage_blob_cache_stats::hit_count() const
+{
+    return m_hitCount;
+}
+
+uint64_t
+title_storage_blob_cache_stats::miss_count() const
+{
+    return m_missCount;
+}
+
+uint64_t
+title_storage_blob_cache_stats::size_in_bytes() const
+{
+    return m_sizeInBytes;
+}
+
+uint32_t
+title_storage_blob_cache_stats::blob_count() const
+{
+    return m_blobCount;
+}
+
+title_storage_blob_cache::title_storage_blob_cache(
+    _In_ string_t cacheDirectory,
+    _In_ uint64_t maxSizeInBytes
+    ) :
+    m_cacheDirectory(std::move(cacheDirectory)),
+    m_maxSizeInBytes(maxSizeInBytes),
+    m_sizeInBytes(0),
+    m_hitCount(0),
+    m_missCount(0),
+    m_nextFileId(0),
+    m_indexDirty(false),
+    m_lastIndexSaveTime(std::chrono::steady_clock::now())
+{
+}
+
+title_storage_blob_cache::~title_storage_blob_cache()
+{
+    if (m_indexDirty)
+    {
+        save_index();
+    }
+}
+
+xbox_live_result<void>
+title_storage_blob_cache::initialize()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    if (!utils::create_directory(m_cacheDirectory))
+    {
+        LOGS_ERROR << "Failed to create title storage blob cache directory " << m_cacheDirectory;
+        return xbox_live_result<void>(xbox_live_error_code::runtime_error, "Failed to create blob cache directory");
+    }
+
+    std::ifstream indexFile(file_path(BLOB_CACHE_INDEX_FILE_NAME), std::ios_base::in | std::ios_base::binary);
+    if (!indexFile.is_open())
+    {
+        // Nothing cached yet
+        return xbox_live_result<void>();
+    }
+
+    std::string indexUtf8((std::istreambuf_iterator<char>(indexFile)), std::istreambuf_iterator<char>());
+    indexFile.close();
+
+    std::error_code errc = xbox_live_error_code::no_error;
+    web::json::value indexJson;
+    try
+    {
+        indexJson = web::json::value::parse(utility::conversions::to_string_t(indexUtf8));
+    }
+    catch (...)
+    {
+        LOG_ERROR("Title storage blob cache index is corrupt, starting with an empty cache");
+        return xbox_live_result<void>();
+    }
+
+    m_nextFileId = utils::extract_json_uint52(indexJson, _T("nextFileId"), errc);
+
+    // The index lists blobs most recently used first
+    auto blobsJson = utils::extract_json_field(indexJson, _T("blobs"), errc, false);
+    if (blobsJson.is_array())
+    {
+        for (const auto& blobJson : blobsJson.as_array())
+        {
+            string_t key = utils::extract_json_string(blobJson, _T("key"), errc);
+            if (key.empty() || m_entries.find(key) != m_entries.end())
+            {
+                continue;
+            }
+
+            cache_entry entry;
+            entry.eTag = utils::extract_json_string(blobJson, _T("eTag"), errc);
+            entry.fileName = utils::extract_json_string(blobJson, _T("file"), errc);
+            entry.size = utils::extract_json_uint52(blobJson, _T("size"), errc);
+            entry.lruPosition = m_lruKeys.insert(m_lruKeys.end(), key);
+            m_sizeInBytes += entry.size;
+            m_entries[key] = std::move(entry);
+        }
+    }
+
+    // The cap may have shrunk since the index was written
+    if (evict(0))
+    {
+        save_index();
+    }
+    return xbox_live_result<void>();
+}
+
+string_t
+title_storage_blob_cache::cached_e_tag(
+    _In_ const string_t& key
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    auto entry = m_entries.find(key);
+    return entry == m_entries.end() ? string_t() : entry->second.eTag;
+}
+
+bool
+title_storage_blob_cache::read_cached_blob(
+    _In_ const string_t& key,
+    _In_ const string_t& eTag,
+    _Inout_ std::vector<unsigned char>& blob
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    auto entry = m_entries.find(key);
+    if (entry == m_entries.end() || entry->second.eTag != eTag)
+    {
+        return false;
+    }
+
+    std::ifstream blobFile(file_path(entry->second.fileName), std::ios_base::in | std::ios_base::binary);
+    if (blobFile.is_open())
+    {
+        blob.resize(static_cast<size_t>(entry->second.size));
+        if (!blob.empty())
+        {
+            blobFile.read(reinterpret_cast<char*>(&blob[0]), blob.size());
+        }
+    }
+
+    if (!blobFile.is_open() || static_cast<uint64_t>(blobFile.gcount()) != entry->second.size)
+    {
+        LOGS_ERROR << "Title storage blob cache file is missing or truncated for " << key;
+        blobFile.close();
+        blob.clear();
+        remove_entry(entry);
+        mark_index_dirty();
+        return false;
+    }
+
+    m_lruKeys.splice(m_lruKeys.begin(), m_lruKeys, entry->second.lruPosition);
+    ++m_hitCount;
+    mark_index_dirty();
+    return true;
+}
+
+void
+title_storage_blob_cache::store_blob(
+    _In_ const string_t& key,
+    _In_ const string_t& eTag,
+    _In_ const std::vector<unsigned char>& blob
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    ++m_missCount;
+
+    auto existingEntry = m_entries.find(key);
+    bool replacedEntry = existingEntry != m_entries.end();
+    if (replacedEntry)
+    {
+        remove_entry(existingEntry);
+    }
+
+    // Without an ETag the blob could never be revalidated, and a blob over the cap would only evict everything else
+    if (eTag.empty() || blob.size() > m_maxSizeInBytes)
+    {
+        if (replacedEntry)
+        {
+            mark_index_dirty();
+        }
+        return;
+    }
+
+    // Evicted blob files are already deleted, so the index is written now rather than left listing them
+    bool evicted = evict(blob.size());
+
+    stringstream_t fileName;
+    fileName << _T("blob") << m_nextFileId++ << _T(".bin");
+
+    cache_entry entry;
+    entry.eTag = eTag;
+    entry.fileName = fileName.str();
+    entry.size = blob.size();
+
+    std::ofstream blobFile(file_path(entry.fileName), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (blobFile.is_open() && !blob.empty())
+    {
+        blobFile.write(reinterpret_cast<const char*>(&blob[0]), blob.size());
+    }
+
+    if (!blobFile.is_open() || !blobFile.good())
+    {
+        LOGS_ERROR << "Failed to write title storage blob cache file for " << key;
+        blobFile.close();
+        utils::delete_file(file_path(entry.fileName));
+        if (evicted)
+        {
+            save_index();
+        }
+        else
+        {
+            mark_index_dirty();
+        }
+        return;
+    }
+
+    blobFile.close();
+    entry.lruPosition = m_lruKeys.insert(m_lruKeys.begin(), key);
+    m_sizeInBytes += entry.size;
+    m_entries[key] = std::move(entry);
+    if (evicted)
+    {
+        save_index();
+    }
+    else
+    {
+        mark_index_dirty();
+    }
+}
+
+void
+title_storage_blob_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    while (!m_entries.empty())
+    {
+        remove_entry(m_entries.begin());
+    }
+
+    save_index();
+}
+
+void
+title_storage_blob_cache::flush_index()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    if (m_indexDirty)
+    {
+        save_index();
+    }
+}
+
+title_storage_blob_cache_stats
+title_storage_blob_cache::stats()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    return title_storage_blob_cache_stats(
+        m_hitCount,
+        m_missCount,
+        m_sizeInBytes,
+        static_cast<uint32_t>(m_entries.size())
+        );
+}
+
+void
+title_storage_blob_cache::remove_entry(
+    _In_ std::unordered_map<string_t, cache_entry>::iterator entry
+    )
+{
+    utils::delete_file(file_path(entry->second.fileName));
+    m_sizeInBytes -= entry->second.size;
+    m_lruKeys.erase(entry->second.lruPosition);
+    m_entries.erase(entry);
+}
+
+bool
+title_storage_blob_cache::evict(
+    _In_ uint64_t bytesNeeded
+    )
+{
+    bool evicted = false;
+    while (!m_lruKeys.empty() && m_sizeInBytes + bytesNeeded > m_maxSizeInBytes)
+    {
+        remove_entry(m_entries.find(m_lruKeys.back()));
+        evicted = true;
+    }
+
+    return evicted;
+}
+
+void
+title_storage_blob_cache::mark_index_dirty()
+{
+    // Hits and stores only change the LRU order or add entries, so they are written at most once per interval.
+    // An index that misses them after a crash only loses recency or leaves an unreferenced blob file behind.
+    m_indexDirty = true;
+    if (std::chrono::steady_clock::now() - m_lastIndexSaveTime >= BLOB_CACHE_INDEX_SAVE_INTERVAL)
+    {
+        save_index();
+    }
+}
+
+void
+title_storage_blob_cache::save_index()
+{
+    m_indexDirty = false;
+    m_lastIndexSaveTime = std::chrono::steady_clock::now();
+
+    web::json::value blobsJson = web::json::value::array();
+    uint32_t i = 0;
+    for (const auto& key : m_lruKeys)
+    {
+        const auto& entry = m_entries[key];
+
+        web::json::value blobJson;
+        blobJson[_T("key")] = web::json::value::string(key);
+        blobJson[_T("eTag")] = web::json::value::string(entry.eTag);
+        blobJson[_T("file")] = web::json::value::string(entry.fileName);
+        blobJson[_T("size")] = web::json::value::number(entry.size);
+        blobsJson[i++] = blobJson;
+    }
+
+    web::json::value indexJson;
+    indexJson[_T("nextFileId")] = web::json::value::number(m_nextFileId);
+    indexJson[_T("blobs")] = blobsJson;
+
+    std::ofstream indexFile(file_path(BLOB_CACHE_INDEX_FILE_NAME), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (!indexFile.is_open())
+    {
+        LOGS_ERROR << "Failed to write title storage blob cache index in " << m_cacheDirectory;
+        return;
+    }
+
+    indexFile << utility::conversions::to_utf8string(indexJson.serialize());
+}
+
+string_t
+title_storage_blob_cache::file_path(
+    _In_ const string_t& fileName
+    ) const
+{
+    return m_cacheDirectory + _T("\\") + fileName;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_END
@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "xsapi/title_storage.h"
+#include <list>
+#include <unordered_map>
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_BEGIN
+
+/// <summary>
+/// On-disk cache of downloaded blobs, keyed by download path and revalidated by ETag.
+/// Blobs live in one file each next to an index that records their ETags in least recently used order.
+/// </summary>
+class title_storage_blob_cache
+{
+public:
+    title_storage_blob_cache(
+        _In_ string_t cacheDirectory,
+        _In_ uint64_t maxSizeInBytes
+        );
+
+    ~title_storage_blob_cache();
+
+    /// <summary>
+    /// Creates the cache directory if needed and loads the index left by an earlier session
+    /// </summary>
+    xbox_live_result<void> initialize();
+
+    /// <summary>
+    /// The ETag of the cached copy of a blob, or an empty string if it is not cached
+    /// </summary>
+    string_t cached_e_tag(_In_ const string_t& key);
+
+    /// <summary>
+    /// Reads the cached copy of a blob after the service has confirmed it is current, counting a hit.
+    /// Returns false and forgets the entry if it is missing or can no longer be read.
+    /// </summary>
+    bool read_cached_blob(
+        _In_ const string_t& key,
+        _In_ const string_t& eTag,
+        _Inout_ std::vector<unsigned char>& blob
+        );
+
+    /// <summary>
+    /// Stores a blob the service had to send in full, counting a miss, and evicts old blobs to stay under the size cap
+    /// </summary>
+    void store_blob(
+        _In_ const string_t& key,
+        _In_ const string_t& eTag,
+        _In_ const std::vector<unsigned char>& blob
+        );
+
+    /// <summary>
+    /// Deletes every cached blob
+    /// </summary>
+    void clear();
+
+    /// <summary>
+    /// Writes the index if it has changed since it was last written
+    /// </summary>
+    void flush_index();
+
+    title_storage_blob_cache_stats stats();
+
+private:
+    struct cache_entry
+    {
+        string_t eTag;
+        string_t fileName;
+        uint64_t size;
+        std::list<string_t>::iterator lruPosition;
+    };
+
+    void remove_entry(_In_ std::unordered_map<string_t, cache_entry>::iterator entry);
+    bool evict(_In_ uint64_t bytesNeeded);
+    void mark_index_dirty();
+    void save_index();
+    string_t file_path(_In_ const string_t& fileName) const;
+
+    std::mutex m_lock;
+    string_t m_cacheDirectory;
+    uint64_t m_maxSizeInBytes;
+    uint64_t m_sizeInBytes;
+    uint64_t m_hitCount;
+    uint64_t m_missCount;
+    uint64_t m_nextFileId;
+    bool m_indexDirty;
+    std::chrono::steady_clock::time_point m_lastIndexSaveTime;
+    std::list<string_t> m_lruKeys;
+    std::unordered_map<string_t, cache_entry> m_entries;
+};
+
+/// <summary>
+/// State of a download_blob call. Each block is requested from the continuation of the one before it.
+/// </summary>
+struct title_storage_blob_download
+{
+    title_storage_blob_download() :
+        etagMatchCondition(title_storage_e_tag_match_condition::not_used),
+        startByte(0),
+        preferredDownloadBlockSize(0),
+        maxConcurrentDownloads(1),
+        isBinaryData(false),
+        useBlobCache(false)
+    {
+    }
+
+    std::shared_ptr<xbox::services::xbox_live_context_settings> xboxLiveContextSettings;
+    std::shared_ptr<xbox::services::user_context> userContext;
+    std::shared_ptr<xbox::services::xbox_live_app_config> appConfig;
+    std::shared_ptr<title_storage_blob_cache> blobCache;
+    std::shared_ptr<std::vector<unsigned char>> blobBuffer;
+    title_storage_blob_metadata blobMetadata;
+    title_storage_blob_metadata resultBlobMetadata;
+    title_storage_e_tag_match_condition etagMatchCondition;
+    string_t subpathAndQuery;
+    string_t cachedETag;
+    uint32_t startByte;
+    uint32_t preferredDownloadBlockSize;
+    uint32_t maxConcurrentDownloads;
+    bool isBinaryData;
+    bool useBlobCache;
+};
+
+/// <summary>
+/// State of a download_blob_to_sink call. Each block is requested once the sink has taken the one before it.
+/// </summary>
+struct title_storage_blob_sink_download
+{
+    title_storage_blob_sink_download() :
+        etagMatchCondition(title_storage_e_tag_match_condition::not_used),
+        startByte(0),
+        preferredDownloadBlockSize(0),
+        isBinaryData(false)
+    {
+    }
+
+    std::shared_ptr<xbox::services::xbox_live_context_settings> xboxLiveContextSettings;
+    std::shared_ptr<xbox::services::user_context> userContext;
+    std::shared_ptr<xbox::services::xbox_live_app_config> appConfig;
+    std::function<bool(const unsigned char* data, size_t length)> blobSink;
+    title_storage_blob_metadata blobMetadata;
+    title_storage_blob_metadata resultBlobMetadata;
+    title_storage_e_tag_match_condition etagMatchCondition;
+    string_t subpathAndQuery;
+    // The version the first block came from, every later block has to match it
+    string_t blobETag;
+    uint32_t startByte;
+    uint32_t preferredDownloadBlockSize;
+    bool isBinaryData;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_END
@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "xsapi/title_storage.h"
+#include "title_storage_internal.h"
 #include "user_context.h"
 #include "xbox_system_factory.h"
 #include "utils.h"
@@ -24,6 +25,106 @@ const uint32_t title_storage_service::MAX_UPLOAD_BLOCK_SIZE = 4 * 1024 * 1024;
 const uint32_t title_storage_service::DEFAULT_UPLOAD_BLOCK_SIZE = 256 * 1024;
 const uint32_t title_storage_service::MIN_DOWNLOAD_BLOCK_SIZE = 1024;
 const uint32_t title_storage_service::DEFAULT_DOWNLOAD_BLOCK_SIZE = 1024 * 1024;
+const uint32_t title_storage_service::DEFAULT_DOWNLOAD_CONCURRENCY = 4;
+const uint32_t title_storage_service::MAX_DOWNLOAD_CONCURRENCY = 16;
+const uint64_t title_storage_service::DEFAULT_BLOB_CACHE_SIZE = 16 * 1024 * 1024;
+static const uint32_t MAX_BLOCK_DOWNLOAD_ATTEMPTS = 3;
+
+static bool is_block_download_retryable(
+    _In_ const std::error_code& errc
+    )
+{
+    auto errorValue = errc.value();
+    return errorValue == static_cast<int>(xbox_live_error_code::http_status_408_request_timeout) ||
+        errorValue == static_cast<int>(xbox_live_error_code::http_status_429_too_many_requests) ||
+        (errorValue >= static_cast<int>(xbox_live_error_code::http_status_500_internal_server_error) &&
+         errorValue <= static_cast<int>(xbox_live_error_code::http_status_511_network_authentication_required));
+}
+
+struct title_storage_block_request
+{
+    uint32_t startByte;
+    uint32_t length;
+    uint32_t attempts;
+};
+
+/// <summary>
+/// Keeps up to maxInFlightCount block requests going. Each completion starts the next pending block,
+/// so one slow block does not hold up the others.
+/// </summary>
+struct title_storage_block_download
+{
+    title_storage_block_download() :
+        maxInFlightCount(1),
+        inFlightCount(0),
+        isComplete(false)
+    {
+    }
+
+    std::mutex lock;
+    std::deque<title_storage_block_request> pendingBlocks;
+    uint32_t maxInFlightCount;
+    uint32_t inFlightCount;
+    bool isComplete;
+    std::error_code errc;
+    std::function<pplx::task<std::error_code>(const title_storage_block_request&)> downloadBlock;
+    pplx::task_completion_event<std::error_code> completionEvent;
+};
+
+static void start_block_downloads(
+    _In_ const std::shared_ptr<title_storage_block_download>& download
+    )
+{
+    std::vector<title_storage_block_request> blocksToStart;
+    bool isComplete = false;
+    {
+        std::lock_guard<std::mutex> lock(download->lock);
+
+        // After a failure nothing new goes out, but the blocks already in flight are waited for since they write into the buffer
+        while (!download->errc && !download->pendingBlocks.empty() && download->inFlightCount < download->maxInFlightCount)
+        {
+            blocksToStart.push_back(download->pendingBlocks.front());
+            download->pendingBlocks.pop_front();
+            ++download->inFlightCount;
+        }
+
+        if (download->inFlightCount == 0 && !download->isComplete)
+        {
+            download->isComplete = true;
+            isComplete = true;
+        }
+    }
+
+    if (isComplete)
+    {
+        download->completionEvent.set(download->errc);
+        return;
+    }
+
+    for (auto& block : blocksToStart)
+    {
+        download->downloadBlock(block).then([download, block](std::error_code errc) mutable
+        {
+            {
+                std::lock_guard<std::mutex> lock(download->lock);
+                --download->inFlightCount;
+                if (errc && !download->errc)
+                {
+                    if (++block.attempts < MAX_BLOCK_DOWNLOAD_ATTEMPTS && is_block_download_retryable(errc))
+                    {
+                        download->pendingBlocks.push_back(block);
+                    }
+                    else
+                    {
+                        download->errc = errc;
+                    }
+                }
+            }
+
+            start_block_downloads(download);
+        });
+    }
+}
 
 title_storage_service::title_storage_service(
     _In_ std::shared_ptr<user_context> userContext,
@@ -36,6 +137,59 @@ title_storage_service::title_storage_service(
 {
 }
 
+xbox_live_result<void>
+title_storage_service::enable_blob_cache(
+    _In_ const string_t& cacheDirectory,
+    _In_ uint64_t maxSizeInBytes
+    )
+{
+    if (cacheDirectory.empty())
+    {
+        return xbox_live_result<void>(xbox_live_error_code::invalid_argument, "Cache directory is empty");
+    }
+
+    auto blobCache = std::make_shared<title_storage_blob_cache>(cacheDirectory, maxSizeInBytes);
+    auto result = blobCache->initialize();
+    if (!result.err())
+    {
+        // Downloads in flight keep their own reference to the cache they started with
+        auto previousBlobCache = std::atomic_exchange(&m_blobCache, blobCache);
+        if (previousBlobCache != nullptr)
+        {
+            previousBlobCache->flush_index();
+        }
+    }
+
+    return result;
+}
+
+void
+title_storage_service::disable_blob_cache()
+{
+    auto previousBlobCache = std::atomic_exchange(&m_blobCache, std::shared_ptr<title_storage_blob_cache>());
+    if (previousBlobCache != nullptr)
+    {
+        previousBlobCache->flush_index();
+    }
+}
+
+void
+title_storage_service::clear_blob_cache()
+{
+    auto blobCache = std::atomic_load(&m_blobCache);
+    if (blobCache != nullptr)
+    {
+        blobCache->clear();
+    }
+}
+
+title_storage_blob_cache_stats
+title_storage_service::blob_cache_stats() const
+{
+    auto blobCache = std::atomic_load(&m_blobCache);
+    return blobCache == nullptr ? title_storage_blob_cache_stats() : blobCache->stats();
+}
+
 pplx::task<xbox_live_result<title_storage_quota>>
 title_storage_service::get_quota(
     _In_ string_t serviceConfigurationId,
@@ -362,109 +516,316 @@ title_storage_service::download_blob(
     _In_ string_t selectQuery,
     _In_ uint32_t preferredDownloadBlockSize
     )
+{
+    return download_blob(
+        std::move(blobMetadata),
+        blobBuffer,
+        etagMatchCondition,
+        std::move(selectQuery),
+        preferredDownloadBlockSize,
+        DEFAULT_DOWNLOAD_CONCURRENCY
+        );
+}
+
+pplx::task<xbox_live_result<title_storage_blob_result>>
+title_storage_service::download_blob(
+    _In_ title_storage_blob_metadata blobMetadata,
+    _In_ std::shared_ptr<std::vector<unsigned char>> blobBuffer,
+    _In_ title_storage_e_tag_match_condition etagMatchCondition,
+    _In_ string_t selectQuery,
+    _In_ uint32_t preferredDownloadBlockSize,
+    _In_ uint32_t maxConcurrentDownloads
+    )
 {
     if(blobBuffer == nullptr)
     {
-        return pplx::task_from_result(xbox_live_result<title_storage_blob_result>(xbox_live_error_code::invalid_argument, "Null blobBuffer Argument")); 
+        return pplx::task_from_result(xbox_live_result<title_storage_blob_result>(xbox_live_error_code::invalid_argument, "Null blobBuffer Argument"));
     }
     preferredDownloadBlockSize = preferredDownloadBlockSize < MIN_DOWNLOAD_BLOCK_SIZE ? MIN_DOWNLOAD_BLOCK_SIZE : preferredDownloadBlockSize;
+    maxConcurrentDownloads = maxConcurrentDownloads < 1 ? 1 : maxConcurrentDownloads;
+    maxConcurrentDownloads = maxConcurrentDownloads > MAX_DOWNLOAD_CONCURRENCY ? MAX_DOWNLOAD_CONCURRENCY : maxConcurrentDownloads;
+
+    auto download = std::make_shared<title_storage_blob_download>();
+    download->xboxLiveContextSettings = m_xboxLiveContextSettings;
+    download->userContext = m_userContext;
+    download->appConfig = m_appConfig;
+    download->blobCache = std::atomic_load(&m_blobCache);
+    download->blobBuffer = blobBuffer;
+    download->blobMetadata = blobMetadata;
+    download->resultBlobMetadata = blobMetadata;
+    download->etagMatchCondition = etagMatchCondition;
+    download->preferredDownloadBlockSize = preferredDownloadBlockSize;
+    download->maxConcurrentDownloads = maxConcurrentDownloads;
+    download->isBinaryData = (blobMetadata.blob_type() == title_storage_blob_type::binary);
+
+    auto task = pplx::create_task([download, selectQuery]() -> pplx::task<xbox_live_result<title_storage_blob_result>>
+    {
+        xbox_live_result<string_t> subpathAndQueryResult = title_storage_download_blob_subpath(
+            download->blobMetadata,
+            selectQuery
+            );
 
-    auto sharedXboxLiveContextSettings = m_xboxLiveContextSettings;
-    auto sharedUserContext = m_userContext;
-    auto sharedAppConfig = m_appConfig;
-    auto task = pplx::create_task([sharedXboxLiveContextSettings, sharedUserContext, sharedAppConfig, blobMetadata, blobBuffer, etagMatchCondition, selectQuery, preferredDownloadBlockSize]()
+        if(subpathAndQueryResult.err()) return pplx::task_from_result(xbox_live_result<title_storage_blob_result>(subpathAndQueryResult.err(), subpathAndQueryResult.err_message()));
+
+        download->subpathAndQuery = subpathAndQueryResult.payload();
+
+        // Json and Config blobs come back in a single response, so the whole blob can be cached under its download path
+        download->useBlobCache = download->blobCache != nullptr && !download->isBinaryData && download->etagMatchCondition == title_storage_e_tag_match_condition::not_used;
+        if (download->useBlobCache)
+        {
+            download->cachedETag = download->blobCache->cached_e_tag(download->subpathAndQuery);
+        }
+
+        download->blobBuffer->clear();
+        return download_next_blob_block(download);
+    });
+
+    return utils::create_exception_free_task<title_storage_blob_result>(
+        task
+        );
+}
+
+pplx::task<xbox_live_result<title_storage_blob_result>>
+title_storage_service::download_next_blob_block(
+    _In_ std::shared_ptr<title_storage_blob_download> download
+    )
+{
+    std::shared_ptr<http_call> httpCall = xbox_system_factory::get_factory()->create_http_call(
+        download->xboxLiveContextSettings,
+        _T("GET"),
+        utils::create_xboxlive_endpoint(_T("titlestorage"), download->appConfig),
+        download->subpathAndQuery,
+        xbox_live_api::download_blob
+        );
+
+    httpCall->set_content_type_header_value(CONTENT_TYPE_HEADER_VALUE);
+    httpCall->set_long_http_call(true);
+
+    if (download->cachedETag.empty())
     {
-        title_storage_blob_metadata resultBlobMetadata(
-            blobMetadata
+        set_e_tag_header(
+            httpCall,
+            download->blobMetadata.e_tag(),
+            download->etagMatchCondition
+            );
+    }
+    else
+    {
+        set_e_tag_header(
+            httpCall,
+            download->cachedETag,
+            title_storage_e_tag_match_condition::if_not_match
             );
+    }
 
-        bool isBinaryData = (blobMetadata.blob_type() == title_storage_blob_type::binary);
-        bool isDownloading = true;
-        uint32_t startByte = 0;
-        
-        xbox_live_result<string_t> subpathAndQueryResult = title_storage_download_blob_subpath(
-            blobMetadata,
-            selectQuery
+    if (download->isBinaryData)
+    {
+        set_range_header(
+            httpCall,
+            download->startByte,
+            download->startByte + download->preferredDownloadBlockSize - 1
             );
+    }
+
+    // The next request goes out from this continuation, so no thread waits on a block
+    return httpCall->get_response_with_auth(download->userContext, http_call_response_body_type::vector_body)
+    .then([download](std::shared_ptr<http_call_response> response) -> pplx::task<xbox_live_result<title_storage_blob_result>>
+    {
+        std::error_code errc = response->err_code();
+        if (errc == xbox_live_error_code::http_status_304_not_modified && !download->cachedETag.empty())
+        {
+            if (download->blobCache->read_cached_blob(download->subpathAndQuery, download->cachedETag, *download->blobBuffer))
+            {
+                download->resultBlobMetadata._Set_e_tag_and_length(
+                    download->cachedETag,
+                    download->blobBuffer->size()
+                    );
+
+                return pplx::task_from_result(xbox_live_result<title_storage_blob_result>(
+                    title_storage_blob_result(
+                        download->blobBuffer,
+                        download->resultBlobMetadata
+                        ),
+                        xbox_live_error_code::no_error
+                        ));
+            }
 
-        if(subpathAndQueryResult.err()) return xbox_live_result<title_storage_blob_result>(subpathAndQueryResult.err(), subpathAndQueryResult.err_message());
+            // The cached copy is gone, so ask again for the full blob
+            download->cachedETag.clear();
+            return download_next_blob_block(download);
+        }
 
-        string_t subpathAndQuery = subpathAndQueryResult.payload();
-        blobBuffer->clear();
-        while (isDownloading)
+        if (errc)
         {
-            std::shared_ptr<http_call> httpCall = xbox_system_factory::get_factory()->create_http_call(
-                sharedXboxLiveContextSettings,
-                _T("GET"),
-                utils::create_xboxlive_endpoint(_T("titlestorage"), sharedAppConfig),
-                subpathAndQuery,
-                xbox_live_api::download_blob
-                );
+            return pplx::task_from_result(xbox_live_result<title_storage_blob_result>(errc, "Download failed"));
+        }
 
-            httpCall->set_content_type_header_value(CONTENT_TYPE_HEADER_VALUE);
-            httpCall->set_long_http_call(true);
+        const auto& responseVector = response->response_body_vector();
+        size_t responseByteLength = responseVector.size();
+        download->blobBuffer->resize(download->startByte + responseByteLength);
+        if (responseByteLength > 0)
+        {
+            memcpy(&(download->blobBuffer->at(download->startByte)), &responseVector[0], responseByteLength);
+        }
 
-            set_e_tag_header(
-                httpCall,
-                blobMetadata.e_tag(),
-                etagMatchCondition
+        download->startByte += static_cast<uint32_t>(responseByteLength);
+        string_t responseETag = response->e_tag();
+
+        bool isDownloading = download->isBinaryData && responseByteLength >= download->preferredDownloadBlockSize;
+        if (!isDownloading)
+        {
+            download->resultBlobMetadata._Set_e_tag_and_length(
+                responseETag,
+                download->startByte
                 );
+        }
+
+        if (download->useBlobCache)
+        {
+            download->blobCache->store_blob(download->subpathAndQuery, responseETag, *download->blobBuffer);
+        }
 
-            if (isBinaryData)
+        if (!isDownloading)
+        {
+            return pplx::task_from_result(xbox_live_result<title_storage_blob_result>(
+                title_storage_blob_result(
+                    download->blobBuffer,
+                    download->resultBlobMetadata
+                    ),
+                    xbox_live_error_code::no_error
+                    ));
+        }
+
+        // Once a block has confirmed that the metadata describes the blob being served, the remaining length is
+        // known and the rest of the blocks can be fetched concurrently straight into their place in the buffer
+        if (download->maxConcurrentDownloads > 1 &&
+            download->blobMetadata.length() > download->startByte &&
+            !responseETag.empty() &&
+            responseETag == download->blobMetadata.e_tag())
+        {
+            download->blobBuffer->resize(static_cast<size_t>(download->blobMetadata.length()));
+            return download_blob_blocks(
+                download->xboxLiveContextSettings,
+                download->userContext,
+                download->appConfig,
+                download->subpathAndQuery,
+                responseETag,
+                download->blobBuffer,
+                download->startByte,
+                download->preferredDownloadBlockSize,
+                download->maxConcurrentDownloads
+                )
+            .then([download, responseETag](std::error_code errc)
             {
-                set_range_header(
-                    httpCall,
-                    startByte,
-                    startByte + preferredDownloadBlockSize - 1
+                if (errc)
+                {
+                    return xbox_live_result<title_storage_blob_result>(errc, "Download failed");
+                }
+
+                download->resultBlobMetadata._Set_e_tag_and_length(
+                    responseETag,
+                    download->blobBuffer->size()
                     );
-            }
 
+                return xbox_live_result<title_storage_blob_result>(
+                    title_storage_blob_result(
+                        download->blobBuffer,
+                        download->resultBlobMetadata
+                        ),
+                        xbox_live_error_code::no_error
+                        );
+            });
+        }
+
+        return download_next_blob_block(download);
+    });
+}
+
+pplx::task<std::error_code>
+title_storage_service::download_blob_blocks(
+    _In_ const std::shared_ptr<xbox_live_context_settings>& xboxLiveContextSettings,
+    _In_ const std::shared_ptr<user_context>& userContext,
+    _In_ const std::shared_ptr<xbox_live_app_config>& appConfig,
+    _In_ const string_t& subpathAndQuery,
+    _In_ const string_t& eTag,
+    _In_ std::shared_ptr<std::vector<unsigned char>> blobBuffer,
+    _In_ uint32_t startByte,
+    _In_ uint32_t blockSize,
+    _In_ uint32_t maxConcurrentDownloads
+    )
+{
+    auto download = std::make_shared<title_storage_block_download>();
+    download->maxInFlightCount = maxConcurrentDownloads;
+
+    auto blobLength = static_cast<uint32_t>(blobBuffer->size());
+    for (uint32_t blockStart = startByte; blockStart < blobLength; blockStart += blockSize)
+    {
+        title_storage_block_request block = { blockStart, __min(blockSize, blobLength - blockStart), 0 };
+        download->pendingBlocks.push_back(block);
+    }
+
+    // Every response only writes its own range of the presized buffer, so the completions need no locking around it
+    download->downloadBlock = [xboxLiveContextSettings, userContext, appConfig, subpathAndQuery, eTag, blobBuffer](const title_storage_block_request& block)
+    {
+        std::shared_ptr<http_call> httpCall = xbox_system_factory::get_factory()->create_http_call(
+            xboxLiveContextSettings,
+            _T("GET"),
+            utils::create_xboxlive_endpoint(_T("titlestorage"), appConfig),
+            subpathAndQuery,
+            xbox_live_api::download_blob
+            );
+
+        httpCall->set_content_type_header_value(CONTENT_TYPE_HEADER_VALUE);
+        httpCall->set_long_http_call(true);
+
+        // Pin every block to the blob version the first block came from
+        set_e_tag_header(
+            httpCall,
+            eTag,
+            title_storage_e_tag_match_condition::if_match
+            );
+
+        set_range_header(
+            httpCall,
+            block.startByte,
+            block.startByte + block.length - 1
+            );
+
+        unsigned char* destination = &(*blobBuffer)[block.startByte];
+        uint32_t expectedLength = block.length;
+        return httpCall->get_response_with_auth(userContext, http_call_response_body_type::vector_body)
+        .then([blobBuffer, destination, expectedLength](pplx::task<std::shared_ptr<http_call_response>> responseTask)
+        {
             std::error_code errc = xbox_live_error_code::no_error;
-            httpCall->get_response_with_auth(sharedUserContext, http_call_response_body_type::vector_body)
-            .then([&errc, blobBuffer, &startByte, isBinaryData, preferredDownloadBlockSize, &isDownloading, &resultBlobMetadata](std::shared_ptr<http_call_response> response)
+            try
             {
+                auto response = responseTask.get();
                 errc = response->err_code();
-                if (!response->err_code())
+                if (!errc)
                 {
-                    auto responseVector = response->response_body_vector();
-                    size_t responseByteLength = responseVector.size();
-                    blobBuffer->resize(blobBuffer->size() + responseByteLength);
-                    if (responseByteLength > 0)
+                    const auto& responseVector = response->response_body_vector();
+                    if (responseVector.size() != expectedLength)
                     {
-                        memcpy(&(blobBuffer->at(startByte)), &responseVector[0], responseByteLength);
+                        LOG_ERROR("Title storage block length does not match the requested range");
+                        errc = xbox_live_error_code::runtime_error;
                     }
-
-                    startByte += static_cast<uint32_t>(responseByteLength);
-
-                    if (!isBinaryData || responseByteLength < preferredDownloadBlockSize)
+                    else
                     {
-                        isDownloading = false;
-                        resultBlobMetadata._Set_e_tag_and_length(
-                            response->e_tag(),
-                            responseByteLength
-                            );
+                        memcpy(destination, &responseVector[0], expectedLength);
                     }
                 }
-            }).wait();
-
-            if (errc)
+            }
+            catch (...)
             {
-                return xbox_live_result<title_storage_blob_result>(errc, "Download failed");
+                errc = xbox_live_error_code::runtime_error;
             }
-        }
 
-        return xbox_live_result<title_storage_blob_result>(
-            title_storage_blob_result(
-                blobBuffer,
-                resultBlobMetadata
-                ),
-                xbox_live_error_code::no_error
-                );
-    });
+            return errc;
+        });
+    };
 
-    return utils::create_exception_free_task<title_storage_blob_result>(
-        task
-        );
+    start_block_downloads(download);
+    return pplx::create_task(download->completionEvent);
 }
 
 pplx::task<xbox_live_result<title_storage_blob_metadata>>
@@ -492,97 +853,243 @@ title_storage_service::upload_blob(
             );
 
         bool isBinaryData = resultBlobMetadata.blob_type() == title_storage_blob_type::binary;
-        bool isFinalBlock = false;
-
-        std::vector<uint8_t> dataChunk(0);
-        auto blobBufferSize = static_cast<uint32_t>(blobBuffer->size());
-        if (!isBinaryData)
-        {
-            dataChunk.resize(blobBufferSize);
-        }
-
+        size_t blobBufferSize = blobBuffer->size();
         size_t start = 0;
-        size_t count = 0;
         string_t continuationToken;
 
+        // Blocks are appended in the order they arrive and each needs the continuation token of the one before it,
+        // so they have to go out one at a time
         while (start < blobBufferSize)
         {
-            if (isBinaryData)
+            size_t count = blobBufferSize - start;
+            if (isBinaryData && count > preferredUploadBlockSize)
             {
-                count = blobBufferSize - start;
+                count = preferredUploadBlockSize;
+            }
 
-                if (count > preferredUploadBlockSize)
-                {
-                    count = preferredUploadBlockSize;
-                }
-                dataChunk.resize(count);
+            std::error_code errc = upload_blob_block(
+                sharedXboxLiveContextSettings,
+                sharedUserContext,
+                appConfig,
+                blobBuffer,
+                start,
+                count,
+                start + count == blobBufferSize,
+                blobBufferSize,
+                etagMatchCondition,
+                continuationToken,
+                resultBlobMetadata
+                );
 
-                memcpy(&dataChunk[0], &(blobBuffer->at(start)), count);
-                
-                start += count;
-                isFinalBlock = start == blobBufferSize;
-            }
-            else
+            if (errc)
             {
-                dataChunk = *blobBuffer;
-                count = static_cast<uint32_t>(dataChunk.size());
-                start = static_cast<uint32_t>(dataChunk.size());
-                isFinalBlock = true;
+                return xbox_live_result<title_storage_blob_metadata>(errc, "Upload failed");
             }
 
-            xbox_live_result<string_t> subpathAndQueryResult = title_storage_upload_blob_subpath(
-                resultBlobMetadata,
-                continuationToken,
-                isFinalBlock
-                );
+            start += count;
+        }
 
-            if (subpathAndQueryResult.err()) return xbox_live_result<title_storage_blob_metadata>(subpathAndQueryResult.err(), subpathAndQueryResult.err_message());
-            string_t subpathAndQuery = subpathAndQueryResult.payload();
+        return xbox_live_result<title_storage_blob_metadata>(resultBlobMetadata, xbox_live_error_code::no_error, "");
+    });
 
-            std::shared_ptr<http_call> httpCall = xbox_system_factory::get_factory()->create_http_call(
-                sharedXboxLiveContextSettings,
-                _T("PUT"),
-                utils::create_xboxlive_endpoint(_T("titlestorage"), appConfig),
-                subpathAndQuery,
-                xbox_live_api::upload_blob
-                );
+    return utils::create_exception_free_task<title_storage_blob_metadata>(
+        task
+        );
+}
+
+pplx::task<xbox_live_result<title_storage_blob_metadata>>
+title_storage_service::download_blob_to_sink(
+    _In_ title_storage_blob_metadata blobMetadata,
+    _In_ std::function<bool(const unsigned char* data, size_t length)> blobSink,
+    _In_ title_storage_e_tag_match_condition etagMatchCondition,
+    _In_ string_t selectQuery,
+    _In_ uint32_t preferredDownloadBlockSize
+    )
+{
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF(blobSink == nullptr, title_storage_blob_metadata, "Blob sink is null");
+    preferredDownloadBlockSize = preferredDownloadBlockSize < MIN_DOWNLOAD_BLOCK_SIZE ? MIN_DOWNLOAD_BLOCK_SIZE : preferredDownloadBlockSize;
+
+    auto download = std::make_shared<title_storage_blob_sink_download>();
+    download->xboxLiveContextSettings = m_xboxLiveContextSettings;
+    download->userContext = m_userContext;
+    download->appConfig = m_appConfig;
+    download->blobSink = std::move(blobSink);
+    download->blobMetadata = blobMetadata;
+    download->resultBlobMetadata = blobMetadata;
+    download->etagMatchCondition = etagMatchCondition;
+    download->preferredDownloadBlockSize = preferredDownloadBlockSize;
+    download->isBinaryData = (blobMetadata.blob_type() == title_storage_blob_type::binary);
+
+    auto task = pplx::create_task([download, selectQuery]() -> pplx::task<xbox_live_result<title_storage_blob_metadata>>
+    {
+        xbox_live_result<string_t> subpathAndQueryResult = title_storage_download_blob_subpath(
+            download->blobMetadata,
+            selectQuery
+            );
 
-            httpCall->set_content_type_header_value(CONTENT_TYPE_HEADER_VALUE);
-            httpCall->set_long_http_call(true);
+        if (subpathAndQueryResult.err()) return pplx::task_from_result(xbox_live_result<title_storage_blob_metadata>(subpathAndQueryResult.err(), subpathAndQueryResult.err_message()));
 
-            set_e_tag_header(
-                httpCall,
-                resultBlobMetadata.e_tag(),
-                etagMatchCondition
+        download->subpathAndQuery = subpathAndQueryResult.payload();
+        return download_next_sink_block(download);
+    });
+
+    return utils::create_exception_free_task<title_storage_blob_metadata>(
+        task
+        );
+}
+
+pplx::task<xbox_live_result<title_storage_blob_metadata>>
+title_storage_service::download_next_sink_block(
+    _In_ std::shared_ptr<title_storage_blob_sink_download> download
+    )
+{
+    std::shared_ptr<http_call> httpCall = xbox_system_factory::get_factory()->create_http_call(
+        download->xboxLiveContextSettings,
+        _T("GET"),
+        utils::create_xboxlive_endpoint(_T("titlestorage"), download->appConfig),
+        download->subpathAndQuery,
+        xbox_live_api::download_blob
+        );
+
+    httpCall->set_content_type_header_value(CONTENT_TYPE_HEADER_VALUE);
+    httpCall->set_long_http_call(true);
+
+    // Earlier blocks have already been handed to the sink, so the rest must come from the same version of the blob
+    if (download->blobETag.empty())
+    {
+        set_e_tag_header(
+            httpCall,
+            download->blobMetadata.e_tag(),
+            download->etagMatchCondition
+            );
+    }
+    else
+    {
+        set_e_tag_header(
+            httpCall,
+            download->blobETag,
+            title_storage_e_tag_match_condition::if_match
+            );
+    }
+
+    if (download->isBinaryData)
+    {
+        set_range_header(
+            httpCall,
+            download->startByte,
+            download->startByte + download->preferredDownloadBlockSize - 1
+            );
+    }
+
+    // The next block is only requested from this continuation, once the sink has taken the one before it
+    return httpCall->get_response_with_auth(download->userContext, http_call_response_body_type::vector_body)
+    .then([download](std::shared_ptr<http_call_response> response) -> pplx::task<xbox_live_result<title_storage_blob_metadata>>
+    {
+        if (response->err_code())
+        {
+            return pplx::task_from_result(xbox_live_result<title_storage_blob_metadata>(response->err_code(), "Download failed"));
+        }
+
+        const auto& responseVector = response->response_body_vector();
+        size_t responseByteLength = responseVector.size();
+        if (responseByteLength > 0 && !download->blobSink(&responseVector[0], responseByteLength))
+        {
+            return pplx::task_from_result(xbox_live_result<title_storage_blob_metadata>(xbox_live_error_code::runtime_error, "Download stopped by blob sink"));
+        }
+
+        download->startByte += static_cast<uint32_t>(responseByteLength);
+        if (download->blobETag.empty())
+        {
+            download->blobETag = response->e_tag();
+        }
+
+        if (!download->isBinaryData || responseByteLength < download->preferredDownloadBlockSize)
+        {
+            download->resultBlobMetadata._Set_e_tag_and_length(
+                response->e_tag(),
+                download->startByte
                 );
 
-            httpCall->set_request_body(dataChunk);
+            return pplx::task_from_result(xbox_live_result<title_storage_blob_metadata>(download->resultBlobMetadata, xbox_live_error_code::no_error, ""));
+        }
 
-            std::error_code errc = xbox_live_error_code::no_error;
-            httpCall->get_response_with_auth(sharedUserContext)
-            .then([&errc, isFinalBlock, &continuationToken, &resultBlobMetadata, blobBufferSize](std::shared_ptr<http_call_response> response)
+        return download_next_sink_block(download);
+    });
+}
+
+pplx::task<xbox_live_result<title_storage_blob_metadata>>
+title_storage_service::upload_blob_from_source(
+    _In_ title_storage_blob_metadata blobMetadata,
+    _In_ std::function<size_t(unsigned char* buffer, size_t bufferLength)> blobSource,
+    _In_ title_storage_e_tag_match_condition etagMatchCondition,
+    _In_ uint32_t preferredUploadBlockSize
+    )
+{
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF(blobSource == nullptr, title_storage_blob_metadata, "Blob source is null");
+
+    preferredUploadBlockSize = preferredUploadBlockSize < MIN_UPLOAD_BLOCK_SIZE ? MIN_UPLOAD_BLOCK_SIZE : preferredUploadBlockSize;
+    preferredUploadBlockSize = preferredUploadBlockSize > MAX_UPLOAD_BLOCK_SIZE ? MAX_UPLOAD_BLOCK_SIZE : preferredUploadBlockSize;
+
+    auto sharedXboxLiveContextSettings = m_xboxLiveContextSettings;
+    auto sharedUserContext = m_userContext;
+    auto appConfig = m_appConfig;
+
+    auto task = pplx::create_task([sharedXboxLiveContextSettings, sharedUserContext, appConfig, blobMetadata, blobSource, preferredUploadBlockSize, etagMatchCondition]()
+    {
+        title_storage_blob_metadata resultBlobMetadata(
+            blobMetadata
+            );
+
+        bool isBinaryData = resultBlobMetadata.blob_type() == title_storage_blob_type::binary;
+        uint64_t blobLength = 0;
+        string_t continuationToken;
+
+        std::vector<unsigned char> block;
+        if (isBinaryData)
+        {
+            read_blob_source(blobSource, block, preferredUploadBlockSize);
+        }
+        else
+        {
+            while (read_blob_source(blobSource, block, preferredUploadBlockSize) == preferredUploadBlockSize) {}
+        }
+
+        if (block.empty())
+        {
+            return xbox_live_result<title_storage_blob_metadata>(xbox_live_error_code::invalid_argument, "Blob source is empty");
+        }
+
+        // The final block has to be flagged when it is sent, so a full block is only sent once the next one has been read
+        while (!block.empty())
+        {
+            std::vector<unsigned char> nextBlock;
+            if (isBinaryData && block.size() == preferredUploadBlockSize)
             {
-                errc = response->err_code();
-                auto responseJson = response->response_body_json();
-                continuationToken = _T("");
-                if (!errc && !responseJson.is_null())
-                {
-                    continuationToken = utils::extract_json_string(responseJson, _T("continuationToken"));
-                }
+                read_blob_source(blobSource, nextBlock, preferredUploadBlockSize);
+            }
 
-                if (!errc && isFinalBlock)
-                {
-                    resultBlobMetadata._Set_e_tag_and_length(
-                        response->e_tag(),
-                        blobBufferSize
-                        );
-                }
-            }).wait();
+            blobLength += block.size();
+            auto blockBuffer = std::make_shared<std::vector<unsigned char>>(std::move(block));
+            std::error_code errc = upload_blob_block(
+                sharedXboxLiveContextSettings,
+                sharedUserContext,
+                appConfig,
+                blockBuffer,
+                0,
+                blockBuffer->size(),
+                nextBlock.empty(),
+                blobLength,
+                etagMatchCondition,
+                continuationToken,
+                resultBlobMetadata
+                );
 
             if (errc)
             {
                 return xbox_live_result<title_storage_blob_metadata>(errc, "Upload failed");
             }
+
+            block = std::move(nextBlock);
         }
 
         return xbox_live_result<title_storage_blob_metadata>(resultBlobMetadata, xbox_live_error_code::no_error, "");
@@ -593,6 +1100,107 @@ title_storage_service::upload_blob(
         );
 }
 
+std::error_code
+title_storage_service::upload_blob_block(
+    _In_ const std::shared_ptr<xbox_live_context_settings>& xboxLiveContextSettings,
+    _In_ const std::shared_ptr<user_context>& userContext,
+    _In_ const std::shared_ptr<xbox_live_app_config>& appConfig,
+    _In_ const std::shared_ptr<std::vector<unsigned char>>& blobBuffer,
+    _In_ size_t blockStart,
+    _In_ size_t blockLength,
+    _In_ bool isFinalBlock,
+    _In_ uint64_t blobLength,
+    _In_ title_storage_e_tag_match_condition etagMatchCondition,
+    _Inout_ string_t& continuationToken,
+    _Inout_ title_storage_blob_metadata& blobMetadata
+    )
+{
+    xbox_live_result<string_t> subpathAndQueryResult = title_storage_upload_blob_subpath(
+        blobMetadata,
+        continuationToken,
+        isFinalBlock
+        );
+
+    if (subpathAndQueryResult.err()) return subpathAndQueryResult.err();
+
+    std::shared_ptr<http_call> httpCall = xbox_system_factory::get_factory()->create_http_call(
+        xboxLiveContextSettings,
+        _T("PUT"),
+        utils::create_xboxlive_endpoint(_T("titlestorage"), appConfig),
+        subpathAndQueryResult.payload(),
+        xbox_live_api::upload_blob
+        );
+
+    httpCall->set_content_type_header_value(CONTENT_TYPE_HEADER_VALUE);
+    httpCall->set_long_http_call(true);
+
+    set_e_tag_header(
+        httpCall,
+        blobMetadata.e_tag(),
+        etagMatchCondition
+        );
+
+    // The internal call streams the block out of the caller's buffer, any other call gets a copy of it
+    auto internalHttpCall = std::dynamic_pointer_cast<http_call_internal>(httpCall);
+    if (internalHttpCall != nullptr)
+    {
+        internalHttpCall->set_request_body(blobBuffer, blockStart, blockLength);
+    }
+    else
+    {
+        httpCall->set_request_body(std::vector<unsigned char>(blobBuffer->begin() + blockStart, blobBuffer->begin() + blockStart + blockLength));
+    }
+
+    std::error_code errc = xbox_live_error_code::no_error;
+    httpCall->get_response_with_auth(userContext)
+    .then([&errc, isFinalBlock, &continuationToken, &blobMetadata, blobLength](std::shared_ptr<http_call_response> response)
+    {
+        errc = response->err_code();
+        auto responseJson = response->response_body_json();
+        continuationToken = _T("");
+        if (!errc && !responseJson.is_null())
+        {
+            continuationToken = utils::extract_json_string(responseJson, _T("continuationToken"));
+        }
+
+        if (!errc && isFinalBlock)
+        {
+            blobMetadata._Set_e_tag_and_length(
+                response->e_tag(),
+                blobLength
+                );
+        }
+    }).wait();
+
+    return errc;
+}
+
+size_t
+title_storage_service::read_blob_source(
+    _In_ const std::function<size_t(unsigned char* buffer, size_t bufferLength)>& blobSource,
+    _Inout_ std::vector<unsigned char>& block,
+    _In_ size_t blockSize
+    )
+{
+    // Sources may return short reads before the end of the blob, so keep asking until the block is full or the source runs dry
+    size_t blockStart = block.size();
+    size_t bytesRead = 0;
+    block.resize(blockStart + blockSize);
+    while (bytesRead < blockSize)
+    {
+        size_t count = blobSource(&block[blockStart + bytesRead], blockSize - bytesRead);
+        if (count == 0)
+        {
+            break;
+        }
+
+        bytesRead += __min(count, blockSize - bytesRead);
+    }
+
+    block.resize(blockStart + bytesRead);
+    return bytesRead;
+}
+
 void
 title_storage_service::set_e_tag_header(
     _In_ std::shared_ptr<http_call> httpCall,
@@ -12,6 +12,8 @@ public:
     custom_output() : log_output(log_output_level_setting::use_logger_setting, log_level::off) {}
 
     void add_log(_In_ const log_entry& entry) override;
+
+    bool writes_on_calling_thread() const override { return true; }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -8,37 +8,211 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
 std::shared_ptr<logger> logger::s_logger = nullptr;
 
+log_record_queue::log_record_queue(
+    _In_ size_t capacity
+    ) :
+    m_cells(new cell[capacity]),
+    m_mask(capacity - 1),
+    m_enqueuePosition(0),
+    m_dequeuePosition(0)
+{
+    // Positions wrap onto cells with the mask
+    XSAPI_ASSERT(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool log_record_queue::try_push(_Inout_ log_record& record)
+{
+    // A cell is free for position p when its sequence is p, and holds a record for p when its sequence is p + 1
+    cell* target = nullptr;
+    size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        target = &m_cells[position & m_mask];
+        size_t sequence = target->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0)
+        {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Full
+            return false;
+        }
+        else
+        {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    target->record = std::move(record);
+    target->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool log_record_queue::try_pop(_Out_ log_record& record)
+{
+    cell* target = nullptr;
+    size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        target = &m_cells[position & m_mask];
+        size_t sequence = target->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+        if (difference == 0)
+        {
+            if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Empty, or the next record is still being written
+            return false;
+        }
+        else
+        {
+            position = m_dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    record = std::move(target->record);
+    target->sequence.store(position + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+bool log_record_queue::empty() const
+{
+    return m_enqueuePosition.load(std::memory_order_acquire) == m_dequeuePosition.load(std::memory_order_acquire);
+}
+
+logger::logger() :
+    m_log_outputs(std::make_shared<const log_output_list>()),
+    m_logLevel(log_level::warn),
+    m_maxEnabledLevel(static_cast<int>(log_level::off)),
+    m_isDrainScheduled(false),
+    m_droppedCount(0)
+{
+}
+
+logger::~logger()
+{
+    // Anything still queued is written out here rather than lost
+    flush();
+}
+
+void logger::create_logger()
+{
+    auto newLogger = std::make_shared<logger>();
+#if !UNIT_TEST_SERVICES
+    // XSAPI is called from game threads, so keep formatting and log I/O off them
+    newLogger->enable_async_logging();
+#endif
+    s_logger = newLogger;
+}
+
 void logger::add_log_output(std::shared_ptr<log_output> output)
 {
-    m_log_outputs.emplace_back(output); 
+    std::lock_guard<std::mutex> lock(m_outputsLock);
     if (output->level_setting() == log_output_level_setting::use_logger_setting)
     {
         output->set_log_level(m_logLevel);
     }
+
+    auto outputs = std::make_shared<log_output_list>(*m_log_outputs);
+    outputs->emplace_back(output);
+    std::atomic_store(&m_log_outputs, std::shared_ptr<const log_output_list>(outputs));
+
+    update_max_enabled_level(*outputs);
 };
 
 void logger::set_log_level(log_level level)
 {
+    std::lock_guard<std::mutex> lock(m_outputsLock);
     m_logLevel = level;
 
-    for (const auto& output : m_log_outputs)
+    for (const auto& output : *m_log_outputs)
     {
         if (output->level_setting() == log_output_level_setting::use_logger_setting)
         {
             output->set_log_level(level);
         }
     }
+
+    update_max_enabled_level(*m_log_outputs);
+}
+
+void logger::update_max_enabled_level(const log_output_list& outputs)
+{
+    log_level maxLevel = log_level::off;
+    for (const auto& output : outputs)
+    {
+        if (output->get_log_level() > maxLevel)
+        {
+            maxLevel = output->get_log_level();
+        }
+    }
+
+    m_maxEnabledLevel = static_cast<int>(maxLevel);
 }
 
 void logger::add_log(const log_entry& logEntry)
 {
-    for(const auto& output : m_log_outputs)
+    if (m_asyncQueue == nullptr)
     {
-        if (output->log_level_enabled(logEntry.get_log_level()))
+        write_to_outputs(logEntry, true);
+        return;
+    }
+
+    // The title's trace callback keeps running on the thread that logged, only the other outputs move to the drain
+    bool isQueueNeeded = false;
+    auto outputs = std::atomic_load(&m_log_outputs);
+    for (const auto& output : *outputs)
+    {
+        if (!output->log_level_enabled(logEntry.get_log_level()))
+        {
+            continue;
+        }
+
+        if (output->writes_on_calling_thread())
         {
             output->add_log(logEntry);
         }
+        else
+        {
+            isQueueNeeded = true;
+        }
+    }
+
+    if (!isQueueNeeded)
+    {
+        return;
+    }
+
+    log_record record;
+    record.level = logEntry.get_log_level();
+    record.category = logEntry.category();
+    record.message = logEntry.msg_stream().str();
+    record.time = logEntry.time();
+    record.threadId = logEntry.thread_id();
+
+    // Never block the logging thread, a full queue means the drain is far behind and the entry is dropped
+    if (!m_asyncQueue->try_push(record))
+    {
+        ++m_droppedCount;
+        return;
     }
+
+    schedule_drain();
 }
 
 void logger::operator+=(const log_entry& logEntry)
@@ -46,4 +220,77 @@ void logger::operator+=(const log_entry& logEntry)
     add_log(logEntry);
 }
 
+void logger::enable_async_logging()
+{
+    if (m_asyncQueue == nullptr)
+    {
+        m_asyncQueue.reset(new log_record_queue(ASYNC_QUEUE_CAPACITY));
+    }
+}
+
+void logger::flush()
+{
+    if (m_asyncQueue == nullptr)
+    {
+        return;
+    }
+
+    // Waits out a drain that is already writing, then writes whatever it left behind
+    std::lock_guard<std::mutex> lock(m_drainLock);
+    log_record record;
+    while (m_asyncQueue->try_pop(record))
+    {
+        write_to_outputs(log_entry(record.level, std::move(record.category), std::move(record.message), record.time, record.threadId), false);
+    }
+}
+
+void logger::schedule_drain()
+{
+    bool expected = false;
+    if (!m_isDrainScheduled.compare_exchange_strong(expected, true))
+    {
+        return;
+    }
+
+    std::shared_ptr<logger> pThis = shared_from_this();
+    pplx::create_task([pThis]()
+    {
+        pThis->drain();
+    });
+}
+
+void logger::drain()
+{
+    for (;;)
+    {
+        flush();
+        m_isDrainScheduled = false;
+
+        // A record queued after the last pop but before the flag was cleared found a drain already scheduled,
+        // so pick it up here instead of leaving it until the next entry is logged
+        bool expected = false;
+        if (m_asyncQueue->empty() || !m_isDrainScheduled.compare_exchange_strong(expected, true))
+        {
+            return;
+        }
+    }
+}
+
+void logger::write_to_outputs(const log_entry& logEntry, bool includeCallingThreadOutputs)
+{
+    auto outputs = std::atomic_load(&m_log_outputs);
+    for(const auto& output : *outputs)
+    {
+        if (!includeCallingThreadOutputs && output->writes_on_calling_thread())
+        {
+            continue;
+        }
+
+        if (output->log_level_enabled(logEntry.get_log_level()))
+        {
+            output->add_log(logEntry);
+        }
+    }
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
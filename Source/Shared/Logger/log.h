@@ -8,8 +8,11 @@
 #define DEFAULT_LOGGER XBOX_LIVE_NAMESPACE::logger::get_logger()
 #define IF_LOGGER_ENABLED(logger) if(logger != nullptr)
 
-#define LOG(logger, level, category, msg) IF_LOGGER_ENABLED(logger) logger->add_log(XBOX_LIVE_NAMESPACE::log_entry(level, category, msg))
-#define LOGS(logger, level, category) IF_LOGGER_ENABLED(logger) *logger += XBOX_LIVE_NAMESPACE::log_entry(level, category)
+// Checked before the entry and its message are built, so disabled levels cost a load and a compare
+#define IF_LOG_LEVEL_ENABLED(logger, level) if(logger != nullptr && logger->is_log_level_enabled(level))
+
+#define LOG(logger, level, category, msg) IF_LOG_LEVEL_ENABLED(logger, level) logger->add_log(XBOX_LIVE_NAMESPACE::log_entry(level, category, msg))
+#define LOGS(logger, level, category) IF_LOG_LEVEL_ENABLED(logger, level) *logger += XBOX_LIVE_NAMESPACE::log_entry(level, category)
 
 // default logging macro
 const char defaultCategory[] = "";
@@ -55,12 +58,17 @@ public:
 
     log_entry(log_level level, std::string category, std::string msg);
 
+    // Rebuilds an entry queued by another thread, keeping the time and thread it was logged on
+    log_entry(log_level level, std::string category, std::string msg, std::time_t time, std::thread::id threadId);
+
     std::string level_to_string() const;
 
     const std::stringstream& msg_stream() const { return m_message; }
 
     const std::string& category() const { return m_category; }
     log_level get_log_level() const { return m_logLevel;  }
+    std::time_t time() const { return m_time; }
+    std::thread::id thread_id() const { return m_threadId; }
 
     log_entry& operator<<(const char* data)
     {
@@ -99,6 +107,8 @@ private:
     log_level m_logLevel;
     std::string m_category;
     std::stringstream m_message;
+    std::time_t m_time;
+    std::thread::id m_threadId;
 };
 
 enum log_output_level_setting
@@ -117,10 +127,15 @@ public:
 
     log_output_level_setting level_setting() const { return m_levelSetting; }
 
-    bool log_level_enabled(log_level level) const { return level <= m_logLevel; }
+    bool log_level_enabled(log_level level) const { return level <= m_logLevel.load(); }
+
+    log_level get_log_level() const { return m_logLevel; }
 
     void set_log_level(log_level level) { m_logLevel = level; }
 
+    // Outputs that hand entries back to the title are written on the logging thread even when logging is async
+    virtual bool writes_on_calling_thread() const { return false; }
+
 protected:
     // This function is to write the string to the final output, don't need to be thread safe.
     virtual void write(_In_ const std::string& msg);
@@ -129,32 +144,99 @@ protected:
 
 private:
     log_output_level_setting m_levelSetting;
-    log_level m_logLevel;
+    std::atomic<log_level> m_logLevel;
     mutable std::mutex m_mutex;
 };
 
-class logger
+// A log entry as it waits in the async queue. The message is already formatted by the logging thread, everything
+// else about writing it out happens on the drain.
+struct log_record
+{
+    log_level level;
+    std::string category;
+    std::string message;
+    std::time_t time;
+    std::thread::id threadId;
+};
+
+// Bounded multi-producer queue of log records. Producers claim a cell with a compare-exchange and never take a
+// lock or wait, and a full queue rejects the record instead of blocking. Only the logger's drain pops.
+class log_record_queue
 {
 public:
-    logger() : m_logLevel(log_level::warn) {}
+    explicit log_record_queue(_In_ size_t capacity);
+
+    bool try_push(_Inout_ log_record& record);
+
+    bool try_pop(_Out_ log_record& record);
 
-    static void create_logger() { s_logger = std::make_shared<logger>();  }
+    bool empty() const;
+
+private:
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        log_record record;
+    };
+
+    std::unique_ptr<cell[]> m_cells;
+    size_t m_mask;
+    std::atomic<size_t> m_enqueuePosition;
+    std::atomic<size_t> m_dequeuePosition;
+};
+
+class logger : public std::enable_shared_from_this<logger>
+{
+public:
+    static const size_t ASYNC_QUEUE_CAPACITY = 4096;
+
+    logger();
+    ~logger();
+
+    static void create_logger();
     static void release_logger() { s_logger = nullptr; }
     static const std::shared_ptr<logger>& get_logger() { return s_logger; }
 
     void set_log_level(log_level level);
 
+    // Whether any output would take an entry of this level. Outputs on their own setting count too.
+    bool is_log_level_enabled(log_level level) const { return static_cast<int>(level) <= m_maxEnabledLevel; }
+
     void add_log_output(std::shared_ptr<log_output> output);
 
     void add_log(const log_entry& entry);
     void operator+=(const log_entry& record);
 
+    // Queues entries for a drain on the thread pool instead of formatting and writing them on the calling thread.
+    // The logger has to be owned by a shared_ptr.
+    void enable_async_logging();
+
+    // Waits until everything queued so far has been written out
+    void flush();
+
+    // Entries thrown away because the async queue was full
+    uint64_t dropped_count() const { return m_droppedCount; }
 
 private:
+    typedef std::vector<std::shared_ptr<log_output>> log_output_list;
+
+    void write_to_outputs(const log_entry& entry, bool includeCallingThreadOutputs);
+    void update_max_enabled_level(const log_output_list& outputs);
+    void schedule_drain();
+    void drain();
+
     static std::shared_ptr<logger> s_logger;
 
-    std::vector<std::shared_ptr<log_output>> m_log_outputs;
+    // Replaced rather than changed so the drain can walk it while outputs are added. Writers hold m_outputsLock.
+    std::shared_ptr<const log_output_list> m_log_outputs;
+    std::mutex m_outputsLock;
     log_level m_logLevel;
+    std::atomic<int> m_maxEnabledLevel;
+
+    std::unique_ptr<log_record_queue> m_asyncQueue;
+    std::atomic<bool> m_isDrainScheduled;
+    std::atomic<uint64_t> m_droppedCount;
+    std::mutex m_drainLock;
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -8,14 +8,27 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
 log_entry::log_entry(log_level level, std::string category) :
     m_logLevel(level),
-    m_category(std::move(category))
+    m_category(std::move(category)),
+    m_time(std::time(nullptr)),
+    m_threadId(std::this_thread::get_id())
 {
 
 }
 
 log_entry::log_entry(log_level level, std::string category, std::string msg) :
     m_logLevel(level),
-    m_category(std::move(category))
+    m_category(std::move(category)),
+    m_time(std::time(nullptr)),
+    m_threadId(std::this_thread::get_id())
+{
+    m_message << msg;
+}
+
+log_entry::log_entry(log_level level, std::string category, std::string msg, std::time_t time, std::thread::id threadId) :
+    m_logLevel(level),
+    m_category(std::move(category)),
+    m_time(time),
+    m_threadId(threadId)
 {
     m_message << msg;
 }
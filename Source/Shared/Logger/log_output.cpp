@@ -31,7 +31,7 @@ std::string
 log_output::format_log(_In_ const log_entry& entry)
 {
     std::stringstream stream;
-    std::time_t t = std::time(nullptr);
+    std::time_t t = entry.time();
     std::tm tm_snapshot;
 #if (defined(WIN32) || defined(_WIN32) || defined(__WIN32__))
     localtime_s(&tm_snapshot, &t);
@@ -41,7 +41,7 @@ log_output::format_log(_In_ const log_entry& entry)
 
     // format : "<time> [<thread id>] <level> <category> - <msg>"
 #if !XSAPI_A // TODO: Why put_time isn't found
-    stream << std::put_time(&tm_snapshot, "%c") << " [" << std::this_thread::get_id() << "] ";
+    stream << std::put_time(&tm_snapshot, "%c") << " [" << entry.thread_id() << "] ";
 #endif
     stream << entry.level_to_string() << " " << entry.category() << " - ";
     stream << entry.msg_stream().str() << std::endl;
@@ -151,6 +151,12 @@ public:
     /// </summary>
     DEFINE_PTR_PROP_GETSET_OBJ(UseCoreDispatcherForEventRouting, use_core_dispatcher_for_event_routing, bool);
 
+    /// <summary>
+    /// Controls whether achievement and leaderboard results decode their items on first access
+    /// instead of when the response arrives. Default is false.
+    /// </summary>
+    DEFINE_PTR_PROP_GETSET_OBJ(LazyResultDeserialization, lazy_result_deserialization, bool);
+
     /// <summary>
     /// Disables asserts for Xbox Live throttling in dev sandboxes.
     /// The asserts will not fire in RETAIL sandbox, and this setting has has no affect in RETAIL sandboxes.
@@ -8,9 +8,7 @@
 #include "xbox_system_factory.h"
 #include "build_version.h"
 #include "xsapi/system.h"
-#if TV_API
-#include "System/ppltasks_extra.h"
-#elif XSAPI_SERVER || UNIT_TEST_SYSTEM || XSAPI_U
+#if XSAPI_SERVER || UNIT_TEST_SYSTEM || XSAPI_U
 #include "request_signer.h"
 #if XSAPI_SERVER || UNIT_TEST_SYSTEM
 #include <Winhttp.h>
@@ -21,6 +19,11 @@
 #elif XSAPI_I
 #include "user_impl_ios.h"
 #endif
+#if !XSAPI_U
+#include "ppltasks_extra.h"
+#else
+#include "ppltasks_extra_unix.h"
+#endif
 
 using namespace web;                        // Common features like URIs.
 using namespace web::http;                  // Common HTTP functionality
@@ -28,12 +31,15 @@ using namespace web::http::client;          // HTTP client features
 
 using namespace XBOX_LIVE_NAMESPACE;
 using namespace XBOX_LIVE_NAMESPACE::system;
+using namespace Concurrency::extras;
 
 const int MIN_DELAY_FOR_HTTP_INTERNAL_ERROR_IN_SEC = 10;
 const double MAX_DELAY_TIME_IN_SEC = 60.0;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
+static std::atomic<uint32_t> g_parkedCallCount(0);
+
 std::shared_ptr<http_call> create_xbox_live_http_call(
     _In_ const std::shared_ptr<xbox_live_context_settings>& xboxLiveContextSettings,
     _In_ const string_t& httpMethod,
@@ -86,7 +92,11 @@ http_call_impl::get_response(
     if (proofKey->pub_key().x.size() != 0 || proofKey->pub_key().y.size() != 0)
     {
         std::vector<unsigned char> bodyData;
-        if (m_httpCallData->requestBody.get_http_request_message_type() == http_request_message_type::vector_message)
+        if (m_httpCallData->requestBodyBuffer != nullptr)
+        {
+            bodyData = request_body_range(m_httpCallData);
+        }
+        else if (m_httpCallData->requestBody.get_http_request_message_type() == http_request_message_type::vector_message)
         {
             bodyData = m_httpCallData->requestBody.request_message_vector();
         }
@@ -208,37 +218,75 @@ http_call_impl::_Internal_get_response_with_auth(
     _In_ bool allUsersAuthRequired
     )
 {
-    pplx::task<xbox_live_result<user_context_auth_result>> asyncOp;
-
     m_httpCallData->userContext = userContext;
     m_httpCallData->httpCallResponseBodyType = httpCallResponseBodyType;
     m_httpCallData->request = get_default_request();
 
-    string_t fullUrl = m_httpCallData->serverName + m_httpCallData->request.request_uri().to_string();
+    auto httpCallData = m_httpCallData;
+    auto coalescer = http_request_coalescer::get_http_request_coalescer_singleton();
+    if (utils::str_icmp(httpCallData->httpMethod, _T("GET")) != 0 || !coalescer->is_api_coalescing_enabled(httpCallData->xboxLiveApi))
+    {
+        return get_response_with_auth_result(httpCallData, allUsersAuthRequired);
+    }
 
-    if (m_httpCallData->requestBody.get_http_request_message_type() == http_request_message_type::vector_message)
+    // Calls only share a response when everything that shapes the request, how long it may take and how its response is read matches
+    const auto& settings = httpCallData->xboxLiveContextSettings;
+    stringstream_t key;
+    key << httpCallData->userContext->xbox_user_id() << _T("\n")
+        << allUsersAuthRequired << static_cast<int>(httpCallData->httpCallResponseBodyType) << _T("\n")
+        << httpCallData->longHttpCall << _T(" ") << httpCallData->httpTimeout.count() << _T(" ")
+        << settings->http_timeout().count() << _T(" ") << settings->long_http_timeout().count() << _T(" ")
+        << settings->http_retry_delay().count() << _T(" ") << settings->http_timeout_window().count() << _T("\n")
+        << httpCallData->serverName << httpCallData->request.request_uri().to_string() << _T("\n")
+        << utils::headers_to_string(httpCallData->request.headers());
+
+    return coalescer->get_response(key.str(), [httpCallData, allUsersAuthRequired]()
     {
-        asyncOp = m_httpCallData->userContext->get_auth_result(
-            m_httpCallData->httpMethod,
+        return get_response_with_auth_result(httpCallData, allUsersAuthRequired);
+    });
+}
+
+pplx::task<std::shared_ptr<http_call_response>>
+http_call_impl::get_response_with_auth_result(
+    _In_ const std::shared_ptr<http_call_data>& httpCallData,
+    _In_ bool allUsersAuthRequired
+    )
+{
+    pplx::task<xbox_live_result<user_context_auth_result>> asyncOp;
+
+    string_t fullUrl = httpCallData->serverName + httpCallData->request.request_uri().to_string();
+
+    if (httpCallData->requestBodyBuffer != nullptr)
+    {
+        asyncOp = httpCallData->userContext->get_auth_result(
+            httpCallData->httpMethod,
             fullUrl,
-            utils::headers_to_string(m_httpCallData->request.headers()),
-            m_httpCallData->requestBody.request_message_vector(),
+            utils::headers_to_string(httpCallData->request.headers()),
+            request_body_range(httpCallData),
+            allUsersAuthRequired
+            );
+    }
+    else if (httpCallData->requestBody.get_http_request_message_type() == http_request_message_type::vector_message)
+    {
+        asyncOp = httpCallData->userContext->get_auth_result(
+            httpCallData->httpMethod,
+            fullUrl,
+            utils::headers_to_string(httpCallData->request.headers()),
+            httpCallData->requestBody.request_message_vector(),
             allUsersAuthRequired
             );
     }
     else
     {
-        asyncOp = m_httpCallData->userContext->get_auth_result(
-            m_httpCallData->httpMethod,
+        asyncOp = httpCallData->userContext->get_auth_result(
+            httpCallData->httpMethod,
             fullUrl,
-            utils::headers_to_string(m_httpCallData->request.headers()),
-            m_httpCallData->requestBody.request_message_string(),
+            utils::headers_to_string(httpCallData->request.headers()),
+            httpCallData->requestBody.request_message_string(),
             allUsersAuthRequired
             );
     }
 
-    auto httpCallData = m_httpCallData;
-
     return asyncOp.then([httpCallData](xbox_live_result<user_context_auth_result> xblResult)
     {
         if (xblResult.err())
@@ -285,30 +333,59 @@ http_call_impl::internal_get_response(
         {
             return handle_fast_fail(apiState, httpCallData);
         }
-        else
+        else if (waitTimeInMilliseconds > 0)
         {
-            if (waitTimeInMilliseconds > 0)
-            {
-                // only allow a single call per endpoint to wait for the 429 to expire, and fast fail the rest
-                if (!apiState.isCallWaiting)
-                {
-                    apiState.isCallWaiting = true;
-                    retryAfterManager->set_state(httpCallData->xboxLiveApi, apiState);
-                    utils::sleep(waitTimeInMilliseconds);
-                    retryAfterManager->clear_state(httpCallData->xboxLiveApi);
-                }
-                else
-                {
-                    return handle_fast_fail(apiState, httpCallData);
-                }
-            }
-            else
+            // The Retry-After expires inside the timeout window, so send the call once it does
+            return park_call(std::chrono::milliseconds(waitTimeInMilliseconds), [httpCallData]()
             {
-                retryAfterManager->clear_state(httpCallData->xboxLiveApi);
-            }
+                http_retry_after_manager::get_http_retry_after_manager_singleton()->clear_state(httpCallData->xboxLiveApi);
+                return send_request(httpCallData, chrono_clock_t::now());
+            });
+        }
+        else
+        {
+            retryAfterManager->clear_state(httpCallData->xboxLiveApi);
         }
     }
 
+    return send_request(httpCallData, requestStartTime);
+}
+
+pplx::task<std::shared_ptr<http_call_response>>
+http_call_impl::send_request(
+    _In_ const std::shared_ptr<http_call_data>& httpCallData,
+    _In_ const chrono_clock_t::time_point& requestStartTime
+    )
+{
+    // A call takes one token for its first attempt. Retries are already spaced out by the retry delay
+    // and the Retry-After handling, so charging them again would only push fresh calls further back.
+    if (httpCallData->iterationNumber > 1)
+    {
+        return send_admitted_request(httpCallData, requestStartTime);
+    }
+
+    auto throttleTask = http_retry_after_manager::get_http_retry_after_manager_singleton()->wait_for_throttle(
+        httpCallData->xboxLiveApi,
+        httpCallData->serverName
+        );
+
+    if (!throttleTask.is_done())
+    {
+        return throttleTask.then([httpCallData]()
+        {
+            return send_admitted_request(httpCallData, chrono_clock_t::now());
+        });
+    }
+
+    return send_admitted_request(httpCallData, requestStartTime);
+}
+
+pplx::task<std::shared_ptr<http_call_response>>
+http_call_impl::send_admitted_request(
+    _In_ const std::shared_ptr<http_call_data>& httpCallData,
+    _In_ const chrono_clock_t::time_point& requestStartTime
+    )
+{
     set_http_timeout(httpCallData, requestStartTime);
     http_client_config config = get_config(httpCallData);
     set_user_agent(httpCallData);
@@ -316,8 +393,15 @@ http_call_impl::internal_get_response(
     auto factory = xbox_system_factory::get_factory();
     std::shared_ptr<xbox_http_client> client = factory->create_http_client(httpCallData->serverName, config);
 
-    return client->get_request(httpCallData->request)
-    .then([httpCallData, requestStartTime](pplx::task<http_response> t)
+    // Pooled clients are shared by calls with different timeouts, so each request enforces its own
+    pplx::cancellation_token_source timeoutSource;
+    create_delayed_task(httpCallData->httpTimeout, [timeoutSource]()
+    {
+        timeoutSource.cancel();
+    });
+
+    return client->get_request(httpCallData->request, timeoutSource.get_token())
+    .then([httpCallData, requestStartTime, timeoutSource](pplx::task<http_response> t)
     {
         chrono_clock_t::time_point responseReceivedTime = chrono_clock_t::now();
         http_response httpResponse;
@@ -330,8 +414,16 @@ http_call_impl::internal_get_response(
         }
         catch (const std::exception& ex)
         {
-            networkError = utils::convert_exception_to_xbox_live_error_code();
-            errMessage = ex.what();
+            if (timeoutSource.get_token().is_canceled())
+            {
+                networkError = static_cast<xbox_live_error_code>(static_cast<int>(std::errc::timed_out));
+                errMessage = "Request timed out";
+            }
+            else
+            {
+                networkError = utils::convert_exception_to_xbox_live_error_code();
+                errMessage = ex.what();
+            }
         }
 
         auto httpCallResponse = get_http_call_response(httpCallData, httpResponse);
@@ -342,8 +434,10 @@ http_call_impl::internal_get_response(
         if (shouldRetry)
         {
             httpCallResponse->_Route_service_call();
-            utils::sleep(static_cast<uint32_t>(httpCallData->delayBeforeRetry.count()));
-            return internal_get_response(httpCallData);
+            return park_call(httpCallData->delayBeforeRetry, [httpCallData]()
+            {
+                return internal_get_response(httpCallData);
+            });
         }
         else if (networkError == xbox_live_error_code::no_error)
         {
@@ -393,6 +487,21 @@ http_call_impl::get_default_request()
         request.headers().add(customHeader.first, customHeader.second);
     }
 
+    if (m_httpCallData->requestBodyBuffer != nullptr)
+    {
+        // Read straight out of the caller's buffer. The stream is seekable, so a retry can rewind it
+        request.set_body(
+            concurrency::streams::rawptr_stream<uint8_t>::open_istream(
+                m_httpCallData->requestBodyBuffer->data() + m_httpCallData->requestBodyOffset,
+                m_httpCallData->requestBodyLength
+                ),
+            m_httpCallData->requestBodyLength,
+            m_httpCallData->contentTypeHeaderValue
+            );
+
+        return request;
+    }
+
     switch (m_httpCallData->requestBody.get_http_request_message_type())
     {
         case http_request_message_type::string_message:
@@ -465,6 +574,7 @@ void http_call_impl::set_request_body(
     _In_ const string_t& value
     )
 {
+    m_httpCallData->requestBodyBuffer = nullptr;
     m_httpCallData->requestBody = http_call_request_message(value);
 }
 
@@ -472,13 +582,35 @@ void http_call_impl::set_request_body(
     _In_ const std::vector<uint8_t>& value
     )
 {
+    m_httpCallData->requestBodyBuffer = nullptr;
     m_httpCallData->requestBody = http_call_request_message(value);
 }
 
+void http_call_impl::set_request_body(
+    _In_ std::vector<uint8_t>&& value
+    )
+{
+    m_httpCallData->requestBodyBuffer = nullptr;
+    m_httpCallData->requestBody = http_call_request_message(std::move(value));
+}
+
+void http_call_impl::set_request_body(
+    _In_ std::shared_ptr<std::vector<uint8_t>> buffer,
+    _In_ size_t offset,
+    _In_ size_t length
+    )
+{
+    m_httpCallData->requestBody = http_call_request_message();
+    m_httpCallData->requestBodyBuffer = std::move(buffer);
+    m_httpCallData->requestBodyOffset = offset;
+    m_httpCallData->requestBodyLength = length;
+}
+
 void http_call_impl::set_request_body(
     _In_ const web::json::value& value
     )
 {
+    m_httpCallData->requestBodyBuffer = nullptr;
     m_httpCallData->requestBody = http_call_request_message(value.serialize());
 }
 
@@ -766,12 +898,19 @@ http_call_impl::handle_vector_body_response(
     _In_ std::shared_ptr<http_call_response> httpCallResponse
     )
 {
-    return httpResponse.extract_vector()
-    .then([httpResponse, httpCallResponse](pplx::task<std::vector<unsigned char>> vecTask)
+    // Read the body into a buffer we own and move it into the response. extract_vector() would hand
+    // it back through a task result, and task::get() returns a copy.
+    auto bodyBuffer = std::make_shared<concurrency::streams::container_buffer<std::vector<unsigned char>>>();
+    auto bodyStream = httpResponse.body();
+    auto bodyReadTask = bodyStream.is_valid() ? bodyStream.read_to_end(*bodyBuffer) : pplx::task_from_result<size_t>(0);
+
+    return bodyReadTask
+    .then([httpResponse, httpCallResponse, bodyBuffer](pplx::task<size_t> readTask)
     {
         try
         {
-            httpCallResponse->_Set_response_body(vecTask.get());
+            readTask.get();
+            httpCallResponse->_Set_response_body(std::move(bodyBuffer->collection()));
         }
         catch (const std::exception& ex)
         {
@@ -880,8 +1019,7 @@ bool http_call_impl::should_fast_fail(
     // If the Retry-After will happen first, just wait till Retry-After is done, and don't fast fail
     if (apiState.retryAfterTime < timeoutTime)
     {
-        auto retryAfterCount = static_cast<uint32_t>(remainingTimeBeforeRetryAfter.count());
-        utils::sleep(retryAfterCount);
+        waitTimeInMilliseconds = static_cast<uint32_t>(remainingTimeBeforeRetryAfter.count());
         return false;
     }
     else
@@ -903,6 +1041,29 @@ http_call_impl::handle_fast_fail(
     return pplx::task_from_result<std::shared_ptr<http_call_response>>(httpCallResponse);
 }
 
+pplx::task<std::shared_ptr<http_call_response>>
+http_call_impl::park_call(
+    _In_ std::chrono::milliseconds delay,
+    _In_ const std::function<pplx::task<std::shared_ptr<http_call_response>>()>& resume
+    )
+{
+    // The call is resumed from a timer callback rather than sleeping on a worker thread, so waiting out
+    // a backoff does not take a thread away from every other call sharing the pool
+    ++g_parkedCallCount;
+    return create_delayed_task(delay, []() {})
+    .then([resume](pplx::task<void> t)
+    {
+        --g_parkedCallCount;
+        t.wait();
+        return resume();
+    });
+}
+
+uint32_t http_call_impl::parked_call_count()
+{
+    return g_parkedCallCount;
+}
+
 void http_call_impl::set_http_timeout(
     _In_ const std::shared_ptr<http_call_data>& httpCallData,
     _In_ const chrono_clock_t::time_point& currentTime
@@ -925,6 +1086,269 @@ void http_call_impl::set_http_timeout(
     }
 }
 
+std::vector<unsigned char> http_call_impl::request_body_range(
+    _In_ const std::shared_ptr<http_call_data>& httpCallData
+    )
+{
+    auto rangeStart = httpCallData->requestBodyBuffer->begin() + httpCallData->requestBodyOffset;
+    return std::vector<unsigned char>(rangeStart, rangeStart + httpCallData->requestBodyLength);
+}
+
+http_token_bucket::http_token_bucket(
+    _In_ const http_throttle_settings& settings
+    ) :
+    m_settings(settings),
+    m_lastRefillTime(chrono_clock_t::now()),
+    m_isDrainScheduled(false),
+    m_admittedCount(0),
+    m_queuedCount(0)
+{
+    m_settings.maxTokens = __max(1, m_settings.maxTokens);
+    m_tokens = m_settings.maxTokens;
+}
+
+pplx::task<void>
+http_token_bucket::acquire(
+    _In_ http_call_priority priority
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    refill();
+    if (queue_length() == 0 && m_tokens >= 1)
+    {
+        m_tokens -= 1;
+        ++m_admittedCount;
+        return pplx::task_from_result();
+    }
+
+    pplx::task_completion_event<void> tce;
+    m_queues[static_cast<size_t>(priority)].push_back(tce);
+    ++m_queuedCount;
+    schedule_drain();
+    return pplx::create_task(tce);
+}
+
+void
+http_token_bucket::release_all()
+{
+    std::vector<pplx::task_completion_event<void>> released;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (auto& queue : m_queues)
+        {
+            released.insert(released.end(), queue.begin(), queue.end());
+            queue.clear();
+        }
+        m_admittedCount += released.size();
+    }
+
+    for (auto& tce : released)
+    {
+        tce.set();
+    }
+}
+
+http_throttle_stats
+http_token_bucket::stats()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    refill();
+    http_throttle_stats stats;
+    stats.admittedCount = m_admittedCount;
+    stats.queuedCount = m_queuedCount;
+    stats.queueLength = queue_length();
+    stats.availableTokens = m_tokens;
+    return stats;
+}
+
+void
+http_token_bucket::refill()
+{
+    auto now = chrono_clock_t::now();
+    std::chrono::duration<double> elapsed = now - m_lastRefillTime;
+    m_lastRefillTime = now;
+    m_tokens = __min(static_cast<double>(m_settings.maxTokens), m_tokens + elapsed.count() * m_settings.tokensPerSecond);
+}
+
+void
+http_token_bucket::drain()
+{
+    std::vector<pplx::task_completion_event<void>> admitted;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        m_isDrainScheduled = false;
+        refill();
+
+        // Queues are indexed by priority, so walk them from the back to let higher priority calls out first
+        size_t queueIndex = ARRAYSIZE(m_queues);
+        while (queueIndex > 0 && m_tokens >= 1)
+        {
+            auto& queue = m_queues[queueIndex - 1];
+            if (queue.empty())
+            {
+                --queueIndex;
+                continue;
+            }
+
+            admitted.push_back(queue.front());
+            queue.pop_front();
+            m_tokens -= 1;
+            ++m_admittedCount;
+        }
+
+        schedule_drain();
+    }
+
+    for (auto& tce : admitted)
+    {
+        tce.set();
+    }
+}
+
+void
+http_token_bucket::schedule_drain()
+{
+    if (m_isDrainScheduled || queue_length() == 0)
+    {
+        return;
+    }
+
+    // Wake up when the next token is due rather than polling
+    auto delayInMilliseconds = static_cast<int64_t>(std::ceil((1 - m_tokens) * 1000 / m_settings.tokensPerSecond));
+    m_isDrainScheduled = true;
+
+    std::weak_ptr<http_token_bucket> thisWeakPtr = shared_from_this();
+    create_delayed_task(std::chrono::milliseconds(__max(1, delayInMilliseconds)), [thisWeakPtr]()
+    {
+        std::shared_ptr<http_token_bucket> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            pThis->drain();
+        }
+    });
+}
+
+const http_throttle_settings&
+http_token_bucket::settings() const
+{
+    return m_settings;
+}
+
+uint32_t
+http_token_bucket::queue_length() const
+{
+    size_t length = 0;
+    for (const auto& queue : m_queues)
+    {
+        length += queue.size();
+    }
+
+    return static_cast<uint32_t>(length);
+}
+
+static std::mutex g_httpRequestCoalescerSingletonLock;
+static std::shared_ptr<http_request_coalescer> g_httpRequestCoalescerSingleton;
+
+std::shared_ptr<http_request_coalescer>
+http_request_coalescer::get_http_request_coalescer_singleton()
+{
+    std::lock_guard<std::mutex> guard(g_httpRequestCoalescerSingletonLock);
+    if (g_httpRequestCoalescerSingleton == nullptr)
+    {
+        g_httpRequestCoalescerSingleton = std::make_shared<http_request_coalescer>();
+
+        // Read-only GETs that social manager and presence polling send for the same user from several contexts
+        g_httpRequestCoalescerSingleton->set_api_coalescing_enabled(xbox_live_api::get_presence, true);
+        g_httpRequestCoalescerSingleton->set_api_coalescing_enabled(xbox_live_api::get_presence_for_social_group, true);
+        g_httpRequestCoalescerSingleton->set_api_coalescing_enabled(xbox_live_api::get_user_profiles_for_social_group, true);
+        g_httpRequestCoalescerSingleton->set_api_coalescing_enabled(xbox_live_api::get_social_relationships, true);
+    }
+
+    return g_httpRequestCoalescerSingleton;
+}
+
+http_request_coalescer::http_request_coalescer() :
+    m_coalescedCount(0),
+    m_sentCount(0)
+{
+}
+
+void http_request_coalescer::set_api_coalescing_enabled(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ bool enabled
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_apiEnabledMap[static_cast<uint32_t>(xboxLiveApi)] = enabled;
+}
+
+bool http_request_coalescer::is_api_coalescing_enabled(
+    _In_ xbox_live_api xboxLiveApi
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto it = m_apiEnabledMap.find(static_cast<uint32_t>(xboxLiveApi));
+    return it != m_apiEnabledMap.end() && it->second;
+}
+
+pplx::task<std::shared_ptr<http_call_response>>
+http_request_coalescer::get_response(
+    _In_ const string_t& key,
+    _In_ const std::function<pplx::task<std::shared_ptr<http_call_response>>()>& sendRequest
+    )
+{
+    pplx::task_completion_event<std::shared_ptr<http_call_response>> tce;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto it = m_inFlightRequests.find(key);
+        if (it != m_inFlightRequests.end())
+        {
+            ++m_coalescedCount;
+            return it->second;
+        }
+
+        ++m_sentCount;
+        m_inFlightRequests[key] = pplx::create_task(tce);
+    }
+
+    std::weak_ptr<http_request_coalescer> thisWeakPtr = shared_from_this();
+    sendRequest().then([thisWeakPtr, key, tce](pplx::task<std::shared_ptr<http_call_response>> t)
+    {
+        // Forget the call before completing it, so calls that start from a continuation get a fresh response
+        std::shared_ptr<http_request_coalescer> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(pThis->m_lock);
+            pThis->m_inFlightRequests.erase(key);
+        }
+
+        try
+        {
+            tce.set(t.get());
+        }
+        catch (...)
+        {
+            tce.set_exception(std::current_exception());
+        }
+    });
+
+    return pplx::create_task(tce);
+}
+
+http_coalescing_stats http_request_coalescer::stats()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    http_coalescing_stats stats;
+    stats.coalescedCount = m_coalescedCount;
+    stats.sentCount = m_sentCount;
+    stats.inFlightCount = static_cast<uint32_t>(m_inFlightRequests.size());
+    return stats;
+}
+
 static std::mutex g_httpRetryPolicyManagerSingletonLock;
 static std::shared_ptr<http_retry_after_manager> g_httpRetryPolicyManagerSingleton;
 
@@ -970,4 +1394,213 @@ http_retry_after_api_state http_retry_after_manager::get_state(
     return http_retry_after_api_state();
 }
 
+void http_retry_after_manager::set_api_throttle(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ const http_throttle_settings& settings
+    )
+{
+    std::shared_ptr<http_token_bucket> oldBucket;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        auto it = m_apiThrottleMap.find(static_cast<uint32_t>(xboxLiveApi));
+        if (it != m_apiThrottleMap.end())
+        {
+            oldBucket = it->second;
+            m_apiThrottleMap.erase(it);
+        }
+
+        if (settings.tokensPerSecond > 0)
+        {
+            m_apiThrottleMap[static_cast<uint32_t>(xboxLiveApi)] = std::make_shared<http_token_bucket>(settings);
+        }
+    }
+
+    if (oldBucket != nullptr)
+    {
+        oldBucket->release_all();
+    }
+}
+
+void http_retry_after_manager::set_host_throttle(
+    _In_ const string_t& host,
+    _In_ const http_throttle_settings& settings
+    )
+{
+    std::shared_ptr<http_token_bucket> oldBucket;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        auto it = m_hostThrottleMap.find(host);
+        if (it != m_hostThrottleMap.end())
+        {
+            oldBucket = it->second;
+            m_hostThrottleMap.erase(it);
+        }
+
+        if (settings.tokensPerSecond > 0)
+        {
+            m_hostThrottleMap[host] = std::make_shared<http_token_bucket>(settings);
+        }
+    }
+
+    if (oldBucket != nullptr)
+    {
+        oldBucket->release_all();
+    }
+}
+
+void http_retry_after_manager::set_api_priority(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ http_call_priority priority
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    m_apiPriorityMap[static_cast<uint32_t>(xboxLiveApi)] = priority;
+}
+
+pplx::task<void> http_retry_after_manager::wait_for_throttle(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ const string_t& serverName
+    )
+{
+    std::shared_ptr<http_token_bucket> apiBucket;
+    std::shared_ptr<http_token_bucket> hostBucket;
+    http_call_priority priority = http_call_priority::normal;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        if (m_apiThrottleMap.empty() && m_hostThrottleMap.empty() && m_defaultApiThrottle.tokensPerSecond <= 0)
+        {
+            return pplx::task_from_result();
+        }
+
+        auto apiIt = m_apiThrottleMap.find(static_cast<uint32_t>(xboxLiveApi));
+        if (apiIt != m_apiThrottleMap.end())
+        {
+            apiBucket = apiIt->second;
+        }
+        else if (m_defaultApiThrottle.tokensPerSecond > 0)
+        {
+            // Each API gets its own bucket the first time it is called
+            auto& defaultBucket = m_defaultApiThrottleMap[static_cast<uint32_t>(xboxLiveApi)];
+            if (defaultBucket == nullptr)
+            {
+                defaultBucket = std::make_shared<http_token_bucket>(m_defaultApiThrottle);
+            }
+            apiBucket = defaultBucket;
+        }
+
+        if (!m_hostThrottleMap.empty())
+        {
+            auto hostIt = m_hostThrottleMap.find(web::uri(serverName).host());
+            if (hostIt != m_hostThrottleMap.end())
+            {
+                hostBucket = hostIt->second;
+            }
+        }
+
+        auto priorityIt = m_apiPriorityMap.find(static_cast<uint32_t>(xboxLiveApi));
+        if (priorityIt != m_apiPriorityMap.end())
+        {
+            priority = priorityIt->second;
+        }
+    }
+
+    if (apiBucket == nullptr && hostBucket == nullptr)
+    {
+        return pplx::task_from_result();
+    }
+    else if (hostBucket == nullptr)
+    {
+        return apiBucket->acquire(priority);
+    }
+    else if (apiBucket == nullptr)
+    {
+        return hostBucket->acquire(priority);
+    }
+
+    auto apiTask = apiBucket->acquire(priority);
+    if (apiTask.is_done())
+    {
+        return hostBucket->acquire(priority);
+    }
+
+    return apiTask.then([hostBucket, priority]()
+    {
+        return hostBucket->acquire(priority);
+    });
+}
+
+http_throttle_stats http_retry_after_manager::get_api_throttle_stats(
+    _In_ xbox_live_api xboxLiveApi
+    )
+{
+    std::shared_ptr<http_token_bucket> bucket;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        auto it = m_apiThrottleMap.find(static_cast<uint32_t>(xboxLiveApi));
+        if (it != m_apiThrottleMap.end())
+        {
+            bucket = it->second;
+        }
+        else
+        {
+            auto defaultIt = m_defaultApiThrottleMap.find(static_cast<uint32_t>(xboxLiveApi));
+            if (defaultIt != m_defaultApiThrottleMap.end())
+            {
+                bucket = defaultIt->second;
+            }
+        }
+    }
+
+    return bucket != nullptr ? bucket->stats() : http_throttle_stats();
+}
+
+http_throttle_stats http_retry_after_manager::get_host_throttle_stats(
+    _In_ const string_t& host
+    )
+{
+    std::shared_ptr<http_token_bucket> bucket;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        auto it = m_hostThrottleMap.find(host);
+        if (it != m_hostThrottleMap.end())
+        {
+            bucket = it->second;
+        }
+    }
+
+    return bucket != nullptr ? bucket->stats() : http_throttle_stats();
+}
+
+void http_retry_after_manager::set_default_api_throttle(
+    _In_ const http_throttle_settings& settings
+    )
+{
+    std::unordered_map<uint32_t, std::shared_ptr<http_token_bucket>> oldBuckets;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        m_defaultApiThrottle = settings;
+        oldBuckets.swap(m_defaultApiThrottleMap);
+    }
+
+    for (auto& bucket : oldBuckets)
+    {
+        bucket.second->release_all();
+    }
+}
+
+http_throttle_settings http_retry_after_manager::default_api_throttle()
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    return m_defaultApiThrottle;
+}
+
+http_throttle_settings http_retry_after_manager::host_throttle(
+    _In_ const string_t& host
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    auto it = m_hostThrottleMap.find(host);
+    return it != m_hostThrottleMap.end() ? it->second->settings() : http_throttle_settings();
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -6,6 +6,7 @@
 #include "http_call_response.h"
 #include "http_client.h"
 #include "system_internal.h"
+#include <deque>
 
 #if XSAPI_SERVER || UNIT_TEST_SYSTEM || XSAPI_U
 #include "signature_policy.h"
@@ -114,6 +115,8 @@ struct http_call_data
         httpTimeout(std::chrono::seconds(DEFAULT_HTTP_TIMEOUT_SECONDS)),
         contentTypeHeaderValue(_T("application/json; charset=utf-8")),
         xboxContractVersionHeaderValue(_T("1")),
+        requestBodyOffset(0),
+        requestBodyLength(0),
         addDefaultHeaders(true)
     {
         delayBeforeRetry = xboxLiveContextSettings->http_retry_delay();
@@ -141,6 +144,10 @@ struct http_call_data
     web::http::http_request request;
     http_call_response_body_type httpCallResponseBodyType;
     http_call_request_message requestBody;
+    // Set instead of requestBody when the body is a range of a caller's buffer
+    std::shared_ptr<std::vector<uint8_t>> requestBodyBuffer;
+    size_t requestBodyOffset;
+    size_t requestBodyLength;
     bool addDefaultHeaders;
 };
 
@@ -158,15 +165,13 @@ struct http_retry_after_api_state
         ) :
         retryAfterTime(_retryAfterTime),
         errCode(_errCode),
-        errMessage(_errMessage),
-        isCallWaiting(false)
+        errMessage(_errMessage)
     {
     }
 
     chrono_clock_t::time_point retryAfterTime;
     std::error_code errCode;
     std::string errMessage;
-    bool isCallWaiting;
 };
 
 class http_call_internal : public http_call
@@ -185,6 +190,23 @@ public:
 
     virtual const http_call_request_message& request_body() const = 0;
 
+    using http_call::set_request_body;
+
+    /// <summary>
+    /// Sets the request body using a byte array value, taking ownership of the array
+    /// </summary>
+    virtual void set_request_body(_In_ std::vector<uint8_t>&& value) = 0;
+
+    /// <summary>
+    /// Sets the request body to length bytes of buffer starting at offset. The bytes are streamed from the buffer
+    /// without a copy, so it must not change until the call completes
+    /// </summary>
+    virtual void set_request_body(
+        _In_ std::shared_ptr<std::vector<uint8_t>> buffer,
+        _In_ size_t offset,
+        _In_ size_t length
+        ) = 0;
+
 #if XSAPI_SERVER || UNIT_TEST_SYSTEM || XSAPI_U
     /// <summary>
     /// Sign the request and get the response. Used for auth services.
@@ -197,6 +219,96 @@ public:
 #endif
 };
 
+enum class http_call_priority
+{
+    low,
+    normal,
+    high
+};
+
+/// <summary>
+/// Token bucket settings for client side throttling. A rate of 0 turns throttling off.
+/// </summary>
+struct http_throttle_settings
+{
+    http_throttle_settings() :
+        tokensPerSecond(0),
+        maxTokens(0)
+    {
+    }
+
+    http_throttle_settings(
+        _In_ double _tokensPerSecond,
+        _In_ uint32_t _maxTokens
+        ) :
+        tokensPerSecond(_tokensPerSecond),
+        maxTokens(_maxTokens)
+    {
+    }
+
+    double tokensPerSecond;
+    uint32_t maxTokens;
+};
+
+struct http_throttle_stats
+{
+    http_throttle_stats() :
+        admittedCount(0),
+        queuedCount(0),
+        queueLength(0),
+        availableTokens(0)
+    {
+    }
+
+    uint64_t admittedCount;
+    uint64_t queuedCount;
+    uint32_t queueLength;
+    double availableTokens;
+};
+
+/// <summary>
+/// Admits calls at a steady rate with room for short bursts. Calls that find the bucket empty wait
+/// in a queue per priority and are released from a timer as tokens come back.
+/// </summary>
+class http_token_bucket : public std::enable_shared_from_this<http_token_bucket>
+{
+public:
+    http_token_bucket(
+        _In_ const http_throttle_settings& settings
+        );
+
+    /// <summary>
+    /// Takes a token, returning a task that completes once the call is allowed to go out
+    /// </summary>
+    pplx::task<void> acquire(
+        _In_ http_call_priority priority
+        );
+
+    /// <summary>
+    /// Lets every queued call go, used when the bucket is reconfigured or removed
+    /// </summary>
+    void release_all();
+
+    http_throttle_stats stats();
+
+    const http_throttle_settings& settings() const;
+
+private:
+    void refill();
+    void drain();
+    void schedule_drain();
+    uint32_t queue_length() const;
+
+    std::mutex m_lock;
+    http_throttle_settings m_settings;
+    double m_tokens;
+    chrono_clock_t::time_point m_lastRefillTime;
+    std::deque<pplx::task_completion_event<void>> m_queues[static_cast<size_t>(http_call_priority::high) + 1];
+    bool m_isDrainScheduled;
+    uint64_t m_admittedCount;
+    uint64_t m_queuedCount;
+};
+
 class http_retry_after_manager
 {
 public:
@@ -215,9 +327,124 @@ public:
         _In_ xbox_live_api xboxLiveApi
         );
 
+    /// <summary>
+    /// Rate limits calls to an API before they are sent, so bursts are smoothed out instead of drawing a 429
+    /// </summary>
+    void set_api_throttle(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ const http_throttle_settings& settings
+        );
+
+    /// <summary>
+    /// Rate limits calls to every API served by a host, such as "presence.xboxlive.com"
+    /// </summary>
+    void set_host_throttle(
+        _In_ const string_t& host,
+        _In_ const http_throttle_settings& settings
+        );
+
+    /// <summary>
+    /// The order in which calls to an API leave a throttle queue relative to other queued calls
+    /// </summary>
+    void set_api_priority(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ http_call_priority priority
+        );
+
+    /// <summary>
+    /// Returns a task that completes once the API and host throttles both admit the call
+    /// </summary>
+    pplx::task<void> wait_for_throttle(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ const string_t& serverName
+        );
+
+    http_throttle_stats get_api_throttle_stats(
+        _In_ xbox_live_api xboxLiveApi
+        );
+
+    http_throttle_stats get_host_throttle_stats(
+        _In_ const string_t& host
+        );
+
+    /// <summary>
+    /// Gives every API without a throttle of its own a separate bucket with these settings, created on its first call
+    /// </summary>
+    void set_default_api_throttle(
+        _In_ const http_throttle_settings& settings
+        );
+
+    http_throttle_settings default_api_throttle();
+
+    http_throttle_settings host_throttle(
+        _In_ const string_t& host
+        );
+
 private:
 	XBOX_LIVE_NAMESPACE::system::xbox_live_mutex m_lock;
     std::unordered_map<uint32_t, http_retry_after_api_state> m_apiStateMap;
+    std::unordered_map<uint32_t, std::shared_ptr<http_token_bucket>> m_apiThrottleMap;
+    http_throttle_settings m_defaultApiThrottle;
+    std::unordered_map<uint32_t, std::shared_ptr<http_token_bucket>> m_defaultApiThrottleMap;
+    std::unordered_map<string_t, std::shared_ptr<http_token_bucket>> m_hostThrottleMap;
+    std::unordered_map<uint32_t, http_call_priority> m_apiPriorityMap;
+};
+
+struct http_coalescing_stats
+{
+    http_coalescing_stats() :
+        coalescedCount(0),
+        sentCount(0),
+        inFlightCount(0)
+    {
+    }
+
+    uint64_t coalescedCount;
+    uint64_t sentCount;
+    uint32_t inFlightCount;
+};
+
+/// <summary>
+/// Lets identical GETs that are in flight at the same time share one request. The first call for a key
+/// goes out and every call that arrives before it completes gets the same response object, so its body is
+/// never copied. Nothing in a response is specific to one caller, since the key covers the user, the request
+/// and how the response is read, and a coalesced response must be treated as read only.
+/// </summary>
+class http_request_coalescer : public std::enable_shared_from_this<http_request_coalescer>
+{
+public:
+    static std::shared_ptr<http_request_coalescer> get_http_request_coalescer_singleton();
+
+    http_request_coalescer();
+
+    /// <summary>
+    /// Coalescing is off for every API unless it has been turned on here
+    /// </summary>
+    void set_api_coalescing_enabled(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ bool enabled
+        );
+
+    bool is_api_coalescing_enabled(
+        _In_ xbox_live_api xboxLiveApi
+        );
+
+    /// <summary>
+    /// Joins the call in flight for the key if there is one, or starts a new one with sendRequest
+    /// </summary>
+    pplx::task<std::shared_ptr<http_call_response>> get_response(
+        _In_ const string_t& key,
+        _In_ const std::function<pplx::task<std::shared_ptr<http_call_response>>()>& sendRequest
+        );
+
+    http_coalescing_stats stats();
+
+private:
+    std::mutex m_lock;
+    std::unordered_map<string_t, pplx::task<std::shared_ptr<http_call_response>>> m_inFlightRequests;
+    std::unordered_map<uint32_t, bool> m_apiEnabledMap;
+    uint64_t m_coalescedCount;
+    uint64_t m_sentCount;
 };
 
 class http_call_impl : public http_call_internal, public std::enable_shared_from_this<http_call_impl>
@@ -283,6 +510,8 @@ public:
     void set_request_body(_In_ const string_t& value) override;
     void set_request_body(_In_ const web::json::value& value) override;
     void set_request_body(_In_ const std::vector<uint8_t>& value) override;
+    void set_request_body(_In_ std::vector<uint8_t>&& value) override;
+    void set_request_body(_In_ std::shared_ptr<std::vector<uint8_t>> buffer, _In_ size_t offset, _In_ size_t length) override;
     const http_call_request_message& request_body() const override;
 
     void set_content_type_header_value(_In_ const string_t& value) override;
@@ -298,6 +527,11 @@ public:
 
     web::http::http_request get_default_request() override;
 
+    /// <summary>
+    /// The number of calls currently waiting out a retry delay or Retry-After period
+    /// </summary>
+    static uint32_t parked_call_count();
+
 private:
     NO_COPY_AND_ASSIGN(http_call_impl);
 
@@ -317,6 +551,26 @@ private:
         _In_ const std::shared_ptr<http_call_data>& httpCallData
         );
 
+    static pplx::task<std::shared_ptr<http_call_response>> get_response_with_auth_result(
+        _In_ const std::shared_ptr<http_call_data>& httpCallData,
+        _In_ bool allUsersAuthRequired
+        );
+
+    static pplx::task<std::shared_ptr<http_call_response>> send_request(
+        _In_ const std::shared_ptr<http_call_data>& httpCallData,
+        _In_ const chrono_clock_t::time_point& requestStartTime
+        );
+
+    static pplx::task<std::shared_ptr<http_call_response>> send_admitted_request(
+        _In_ const std::shared_ptr<http_call_data>& httpCallData,
+        _In_ const chrono_clock_t::time_point& requestStartTime
+        );
+
+    static pplx::task<std::shared_ptr<http_call_response>> park_call(
+        _In_ std::chrono::milliseconds delay,
+        _In_ const std::function<pplx::task<std::shared_ptr<http_call_response>>()>& resume
+        );
+
     static void set_user_agent(
         _In_ const std::shared_ptr<http_call_data>& httpCallData
         );
@@ -372,6 +626,13 @@ private:
         _In_ const std::shared_ptr<http_call_data>& httpCallData,
         _In_ const chrono_clock_t::time_point& currentTime
         );
+
+    /// <summary>
+    /// Copies a ranged request body for the signer, which only takes a vector
+    /// </summary>
+    static std::vector<unsigned char> request_body_range(
+        _In_ const std::shared_ptr<http_call_data>& httpCallData
+        );
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
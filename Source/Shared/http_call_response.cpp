@@ -130,7 +130,24 @@ void http_call_response::_Set_response_body(_In_ const std::vector<unsigned char
 
 void http_call_response::_Set_response_body(_In_ const web::json::value& responseBodyJson)
 {
-    m_responseBodyJson = responseBodyJson;
+    _Set_response_body(web::json::value(responseBodyJson));
+}
+
+void http_call_response::_Set_response_body(_In_ string_t&& responseBodyString)
+{
+    m_responseBodyString = std::move(responseBodyString);
+    m_httpCallResponseBodyType = http_call_response_body_type::string_body;
+}
+
+void http_call_response::_Set_response_body(_In_ std::vector<unsigned char>&& responseBodyVector)
+{
+    m_responseBodyVector = std::move(responseBodyVector);
+    m_httpCallResponseBodyType = http_call_response_body_type::vector_body;
+}
+
+void http_call_response::_Set_response_body(_In_ web::json::value&& responseBodyJson)
+{
+    m_responseBodyJson = std::move(responseBodyJson);
     m_httpCallResponseBodyType = http_call_response_body_type::json_body;
 
     if (http_status() == static_cast<int>(xbox_live_error_code::http_status_429_too_many_requests))
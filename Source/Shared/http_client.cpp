@@ -4,13 +4,23 @@
 #include "pch.h"
 #include "http_client.h"
 #include "utils.h"
+#if !XSAPI_U
+#include "ppltasks_extra.h"
+#else
+#include "ppltasks_extra_unix.h"
+#endif
 
 using namespace web;                        // Common features like URIs.
 using namespace web::http;                  // Common HTTP functionality
 using namespace web::http::client;          // HTTP client features
+using namespace Concurrency::extras;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
+// Pooled clients are shared by calls with different timeouts, so the transport timeout only has to outlast
+// the longest of them. Each call enforces its own timeout by cancelling its request.
+static const std::chrono::seconds POOLED_CLIENT_TIMEOUT = std::chrono::hours(24);
+
 xbox_http_client_impl::xbox_http_client_impl(
     _In_ web::http::uri base_uri,
     _In_ web::http::client::http_client_config client_config
@@ -28,4 +38,235 @@ xbox_http_client_impl::get_request(
     return m_client->request(std::move(request), std::move(token));
 }
 
+pooled_http_client::pooled_http_client(
+    _In_ web::http::uri base_uri,
+    _In_ web::http::client::http_client_config client_config,
+    _In_ std::weak_ptr<http_client_pool> pool
+    ) :
+    m_pool(std::move(pool)),
+    m_inFlightCount(0),
+    m_requestCount(0),
+    m_lastUsedTime(chrono_clock_t::now())
+{
+    m_client = std::make_shared<http_client>(std::move(base_uri), std::move(client_config));
+}
+
+pplx::task<web::http::http_response>
+pooled_http_client::get_request(
+    _In_ web::http::http_request request,
+    _In_ pplx::cancellation_token token
+    )
+{
+    std::shared_ptr<http_client_pool> pool = m_pool.lock();
+    bool isFirstRequest = pool != nullptr && pool->on_request_started(*this);
+    auto requestStartTime = chrono_clock_t::now();
+
+    std::weak_ptr<http_client_pool> weakPool = m_pool;
+    std::shared_ptr<pooled_http_client> pThis = shared_from_this();
+    return m_client->request(std::move(request), std::move(token))
+    .then([pThis, weakPool, isFirstRequest, requestStartTime](pplx::task<http_response> t)
+    {
+        std::shared_ptr<http_client_pool> pool = weakPool.lock();
+        if (pool != nullptr)
+        {
+            auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(chrono_clock_t::now() - requestStartTime);
+            pool->on_request_completed(*pThis, isFirstRequest, latency);
+        }
+
+        return t;
+    });
+}
+
+static std::mutex g_httpClientPoolSingletonLock;
+static std::shared_ptr<http_client_pool> g_httpClientPoolSingleton;
+
+std::shared_ptr<http_client_pool>
+http_client_pool::get_http_client_pool_singleton()
+{
+    std::lock_guard<std::mutex> guard(g_httpClientPoolSingletonLock);
+    if (g_httpClientPoolSingleton == nullptr)
+    {
+        g_httpClientPoolSingleton = std::make_shared<http_client_pool>();
+    }
+
+    return g_httpClientPoolSingleton;
+}
+
+http_client_pool::http_client_pool() :
+    m_isEvictionScheduled(false)
+{
+}
+
+std::shared_ptr<xbox_http_client>
+http_client_pool::get_client(
+    _In_ const web::http::uri& baseUri,
+    _In_ const web::http::client::http_client_config& clientConfig
+    )
+{
+    string_t key = get_pool_key(baseUri, clientConfig);
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    evict_idle_clients(chrono_clock_t::now());
+
+    auto& clients = m_clients[key];
+    std::shared_ptr<pooled_http_client> leastBusyClient;
+    for (const auto& client : clients)
+    {
+        if (leastBusyClient == nullptr || client->m_inFlightCount < leastBusyClient->m_inFlightCount)
+        {
+            leastBusyClient = client;
+        }
+    }
+
+    if (leastBusyClient != nullptr && (leastBusyClient->m_inFlightCount == 0 || clients.size() >= m_settings.maxClientsPerHost))
+    {
+        ++m_stats.poolHitCount;
+        return leastBusyClient;
+    }
+
+    http_client_config pooledClientConfig = clientConfig;
+    pooledClientConfig.set_timeout(POOLED_CLIENT_TIMEOUT);
+    auto client = std::make_shared<pooled_http_client>(baseUri, pooledClientConfig, shared_from_this());
+    clients.push_back(client);
+    ++m_stats.newConnectionCount;
+    schedule_idle_eviction();
+    return client;
+}
+
+void
+http_client_pool::set_settings(
+    _In_ const http_client_pool_settings& settings
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_settings = settings;
+    m_settings.maxClientsPerHost = __max(1u, m_settings.maxClientsPerHost);
+}
+
+void
+http_client_pool::clear()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_clients.clear();
+}
+
+http_client_pool_stats
+http_client_pool::stats()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    http_client_pool_stats stats = m_stats;
+    stats.pooledClientCount = 0;
+    for (const auto& clients : m_clients)
+    {
+        stats.pooledClientCount += static_cast<uint32_t>(clients.second.size());
+    }
+
+    return stats;
+}
+
+bool
+http_client_pool::on_request_started(
+    _In_ pooled_http_client& client
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    ++client.m_inFlightCount;
+    client.m_lastUsedTime = chrono_clock_t::now();
+    return client.m_requestCount++ == 0;
+}
+
+void
+http_client_pool::on_request_completed(
+    _In_ pooled_http_client& client,
+    _In_ bool isFirstRequest,
+    _In_ std::chrono::milliseconds latency
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (client.m_inFlightCount > 0)
+    {
+        --client.m_inFlightCount;
+    }
+    client.m_lastUsedTime = chrono_clock_t::now();
+
+    if (isFirstRequest)
+    {
+        ++m_stats.firstRequestCount;
+        m_stats.totalFirstRequestTime += latency;
+    }
+    else
+    {
+        ++m_stats.reusedRequestCount;
+        m_stats.totalReusedRequestTime += latency;
+    }
+}
+
+void
+http_client_pool::evict_idle_clients(
+    _In_ const chrono_clock_t::time_point& now
+    )
+{
+    for (auto iter = m_clients.begin(); iter != m_clients.end();)
+    {
+        auto& clients = iter->second;
+        size_t countBefore = clients.size();
+        clients.erase(std::remove_if(clients.begin(), clients.end(), [this, &now](const std::shared_ptr<pooled_http_client>& client)
+        {
+            return client->m_inFlightCount == 0 && now - client->m_lastUsedTime >= m_settings.idleTimeout;
+        }), clients.end());
+        m_stats.evictedCount += countBefore - clients.size();
+
+        if (clients.empty())
+        {
+            iter = m_clients.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+void
+http_client_pool::schedule_idle_eviction()
+{
+    if (m_isEvictionScheduled || m_clients.empty())
+    {
+        return;
+    }
+
+    // Sweep on a timer as well, so idle connections close even when no more calls come in
+    m_isEvictionScheduled = true;
+    std::weak_ptr<http_client_pool> thisWeakPtr = shared_from_this();
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(m_settings.idleTimeout);
+    create_delayed_task(std::chrono::milliseconds(__max(1, delay.count())), [thisWeakPtr]()
+    {
+        std::shared_ptr<http_client_pool> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(pThis->m_lock);
+            pThis->m_isEvictionScheduled = false;
+            pThis->evict_idle_clients(chrono_clock_t::now());
+            pThis->schedule_idle_eviction();
+        }
+    });
+}
+
+string_t
+http_client_pool::get_pool_key(
+    _In_ const web::http::uri& baseUri,
+    _In_ const web::http::client::http_client_config& clientConfig
+    )
+{
+    // A client's proxy is fixed when it is created, so it is part of what the client can be shared for
+    stringstream_t key;
+    key << baseUri.scheme() << _T("://") << baseUri.host() << _T(":") << baseUri.port() << _T("\n");
+    if (clientConfig.proxy().is_specified())
+    {
+        key << clientConfig.proxy().address().to_string();
+    }
+
+    return key.str();
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
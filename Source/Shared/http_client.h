@@ -32,4 +32,142 @@ private:
     std::shared_ptr<web::http::client::http_client> m_client;
 };
 
+struct http_client_pool_settings
+{
+    http_client_pool_settings() :
+        maxClientsPerHost(4),
+        idleTimeout(60)
+    {
+    }
+
+    // Calls past this many clients per host share the least busy one instead of opening another connection
+    uint32_t maxClientsPerHost;
+    // Clients with nothing in flight for this long are dropped, closing their connections
+    std::chrono::seconds idleTimeout;
+};
+
+struct http_client_pool_stats
+{
+    http_client_pool_stats() :
+        poolHitCount(0),
+        newConnectionCount(0),
+        evictedCount(0),
+        pooledClientCount(0),
+        firstRequestCount(0),
+        totalFirstRequestTime(0),
+        reusedRequestCount(0),
+        totalReusedRequestTime(0)
+    {
+    }
+
+    uint64_t poolHitCount;
+    uint64_t newConnectionCount;
+    uint64_t evictedCount;
+    uint32_t pooledClientCount;
+
+    // The first request on a new client pays for the TCP and TLS handshakes, later ones do not,
+    // so the gap between the two averages is the handshake time saved by each pool hit
+    uint64_t firstRequestCount;
+    std::chrono::milliseconds totalFirstRequestTime;
+    uint64_t reusedRequestCount;
+    std::chrono::milliseconds totalReusedRequestTime;
+};
+
+class http_client_pool;
+
+/// <summary>
+/// A client owned by http_client_pool. It keeps its connections open between calls and reports each
+/// request back to the pool so the pool knows how busy it is.
+/// </summary>
+class pooled_http_client : public xbox_http_client, public std::enable_shared_from_this<pooled_http_client>
+{
+public:
+    pooled_http_client(
+        _In_ web::http::uri base_uri,
+        _In_ web::http::client::http_client_config client_config,
+        _In_ std::weak_ptr<http_client_pool> pool
+        );
+
+    virtual pplx::task<web::http::http_response> get_request(
+        _In_ web::http::http_request request,
+        _In_ pplx::cancellation_token token = pplx::cancellation_token::none()
+        );
+
+private:
+    friend class http_client_pool;
+
+    std::shared_ptr<web::http::client::http_client> m_client;
+    std::weak_ptr<http_client_pool> m_pool;
+
+    // Guarded by the pool's lock
+    uint32_t m_inFlightCount;
+    uint64_t m_requestCount;
+    chrono_clock_t::time_point m_lastUsedTime;
+};
+
+/// <summary>
+/// Hands out http clients shared by every call to the same host through the same proxy, so calls reuse
+/// open connections and TLS sessions rather than setting up new ones each time.
+/// </summary>
+class http_client_pool : public std::enable_shared_from_this<http_client_pool>
+{
+public:
+    static std::shared_ptr<http_client_pool> get_http_client_pool_singleton();
+
+    http_client_pool();
+
+    /// <summary>
+    /// Returns an idle client for the host if there is one, otherwise a new client while the host is under
+    /// its cap, otherwise the client with the fewest calls in flight
+    /// </summary>
+    std::shared_ptr<xbox_http_client> get_client(
+        _In_ const web::http::uri& baseUri,
+        _In_ const web::http::client::http_client_config& clientConfig
+        );
+
+    void set_settings(
+        _In_ const http_client_pool_settings& settings
+        );
+
+    /// <summary>
+    /// Drops every pooled client. Calls in flight finish on the client they started on.
+    /// </summary>
+    void clear();
+
+    http_client_pool_stats stats();
+
+private:
+    friend class pooled_http_client;
+
+    bool on_request_started(
+        _In_ pooled_http_client& client
+        );
+
+    void on_request_completed(
+        _In_ pooled_http_client& client,
+        _In_ bool isFirstRequest,
+        _In_ std::chrono::milliseconds latency
+        );
+
+    void evict_idle_clients(
+        _In_ const chrono_clock_t::time_point& now
+        );
+
+    /// <summary>
+    /// Starts a timer that evicts idle clients every idleTimeout while the pool holds any. Called with m_lock held.
+    /// </summary>
+    void schedule_idle_eviction();
+
+    static string_t get_pool_key(
+        _In_ const web::http::uri& baseUri,
+        _In_ const web::http::client::http_client_config& clientConfig
+        );
+
+    std::mutex m_lock;
+    http_client_pool_settings m_settings;
+    std::unordered_map<string_t, std::vector<std::shared_ptr<pooled_http_client>>> m_clients;
+    http_client_pool_stats m_stats;
+    bool m_isEvictionScheduled;
+};
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -17,6 +17,10 @@
 #elif XSAPI_CPP || defined _WIN32
 #include <objbase.h>
 #endif
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#include <errno.h>
+#endif
 #include "http_call_response.h"
 #if !BEAM_API
 #include "xsapi/presence.h"
@@ -542,6 +546,109 @@ utils::serialize_uint52_to_json(
     return web::json::value::number(static_cast<double>(integer));
 }
 
+static const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+static const uint64_t FNV_PRIME = 0x100000001b3;
+
+static void hash_bytes(
+    _Inout_ uint64_t& hash,
+    _In_ const void* data,
+    _In_ size_t length
+    )
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+static void hash_json_value(
+    _Inout_ uint64_t& hash,
+    _In_ const web::json::value& json
+    )
+{
+    // The type goes in first so that e.g. "1" and 1, or [] and {}, hash differently
+    unsigned char type = static_cast<unsigned char>(json.type());
+    hash_bytes(hash, &type, sizeof(type));
+
+    switch (json.type())
+    {
+    case web::json::value::Number:
+    {
+        const web::json::number& number = json.as_number();
+        if (number.is_int64())
+        {
+            int64_t value = number.to_int64();
+            hash_bytes(hash, &value, sizeof(value));
+        }
+        else if (number.is_uint64())
+        {
+            uint64_t value = number.to_uint64();
+            hash_bytes(hash, &value, sizeof(value));
+        }
+        else
+        {
+            double value = number.to_double();
+            hash_bytes(hash, &value, sizeof(value));
+        }
+        break;
+    }
+    case web::json::value::Boolean:
+    {
+        unsigned char value = json.as_bool() ? 1 : 0;
+        hash_bytes(hash, &value, sizeof(value));
+        break;
+    }
+    case web::json::value::String:
+    {
+        const string_t& value = json.as_string();
+        uint64_t length = value.size();
+        hash_bytes(hash, &length, sizeof(length));
+        hash_bytes(hash, value.c_str(), value.size() * sizeof(char_t));
+        break;
+    }
+    case web::json::value::Object:
+    {
+        // Objects keep their fields sorted by key, so equal objects are walked in the same order
+        const web::json::object& object = json.as_object();
+        uint64_t size = object.size();
+        hash_bytes(hash, &size, sizeof(size));
+        for (const auto& field : object)
+        {
+            uint64_t length = field.first.size();
+            hash_bytes(hash, &length, sizeof(length));
+            hash_bytes(hash, field.first.c_str(), field.first.size() * sizeof(char_t));
+            hash_json_value(hash, field.second);
+        }
+        break;
+    }
+    case web::json::value::Array:
+    {
+        const web::json::array& array = json.as_array();
+        uint64_t size = array.size();
+        hash_bytes(hash, &size, sizeof(size));
+        for (const auto& element : array)
+        {
+            hash_json_value(hash, element);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+uint64_t
+utils::hash_json(
+    _In_ const web::json::value& json
+    )
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hash_json_value(hash, json);
+    return hash;
+}
+
 void utils::append_paging_info(
     _In_ web::uri_builder& uriBuilder,
     _In_ unsigned int skipItems,
@@ -1358,6 +1465,47 @@ void utils::sleep(
 #endif
 }
 
+bool utils::create_directory(
+    _In_ const string_t& directoryPath
+    )
+{
+#if defined(_WIN32)
+    return CreateDirectory(directoryPath.c_str(), nullptr) || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+    return mkdir(directoryPath.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+bool utils::delete_file(
+    _In_ const string_t& filePath
+    )
+{
+#if defined(_WIN32)
+    return DeleteFile(filePath.c_str()) != FALSE;
+#else
+    return std::remove(filePath.c_str()) == 0;
+#endif
+}
+
+bool utils::replace_file(
+    _In_ const string_t& sourcePath,
+    _In_ const string_t& targetPath
+    )
+{
+#if defined(_WIN32)
+    return MoveFileEx(sourcePath.c_str(), targetPath.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+#else
+    if (std::rename(sourcePath.c_str(), targetPath.c_str()) == 0)
+    {
+        return true;
+    }
+
+    // Not every platform lets rename replace an existing file
+    std::remove(targetPath.c_str());
+    return std::rename(sourcePath.c_str(), targetPath.c_str()) == 0;
+#endif
+}
+
 string_t utils::read_file_to_string(
     _In_ const string_t& filePath
     )
@@ -456,6 +456,12 @@ public:
 
     static web::json::value serialize_uint52_to_json(_In_ uint64_t integer);
 
+    /// <summary>
+    /// 64-bit FNV-1a hash of a json value's content. Walks the value in place rather than serializing it,
+    /// so equal values hash equally without allocating.
+    /// </summary>
+    static uint64_t hash_json(_In_ const web::json::value& json);
+
     static string_t base64_url_encode(_In_ const std::vector<unsigned char>& data);
 
     static string_t headers_to_string(_In_ const web::http::http_headers& headers);
@@ -660,6 +666,25 @@ public:
         _In_ const string_t& filePath
     );
 
+    /// <summary>
+    /// Creates a directory. Succeeds if it already exists
+    /// </summary>
+    static bool create_directory(
+        _In_ const string_t& directoryPath
+    );
+
+    static bool delete_file(
+        _In_ const string_t& filePath
+    );
+
+    /// <summary>
+    /// Moves sourcePath to targetPath, replacing any file already there
+    /// </summary>
+    static bool replace_file(
+        _In_ const string_t& sourcePath,
+        _In_ const string_t& targetPath
+    );
+
     static void sleep(
         _In_ uint32_t waitTimeInMilliseconds
     );
@@ -753,4 +778,64 @@ private:
 
 };
 
+/// <summary>
+/// Holds a json array from a service response and decodes it the first time the items are read, so pages
+/// whose items are never looked at are never decoded. The json is released once the items are decoded.
+/// The array is read from the named field of the json, a missing or non-array field decodes to no items.
+/// Thread safe; results share one instance between their copies.
+/// </summary>
+template<typename T>
+class lazy_json_vector
+{
+public:
+    lazy_json_vector(
+        _In_ std::shared_ptr<const web::json::value> json,
+        _In_ string_t fieldName,
+        _In_ std::function<T(const web::json::value&)> deserialize
+        ) :
+        m_json(std::move(json)),
+        m_fieldName(std::move(fieldName)),
+        m_deserialize(std::move(deserialize)),
+        m_isDecoded(false)
+    {
+    }
+
+    std::vector<T>& items()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!m_isDecoded)
+        {
+            if (m_json->has_field(m_fieldName) && m_json->at(m_fieldName).is_array())
+            {
+                const web::json::array& arr = m_json->at(m_fieldName).as_array();
+                m_items.reserve(arr.size());
+                for (const auto& element : arr)
+                {
+                    m_items.push_back(m_deserialize(element));
+                }
+            }
+
+            m_json = nullptr;
+            m_deserialize = nullptr;
+            m_isDecoded = true;
+        }
+
+        return m_items;
+    }
+
+    bool is_decoded() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_isDecoded;
+    }
+
+private:
+    mutable std::mutex m_lock;
+    std::shared_ptr<const web::json::value> m_json;
+    string_t m_fieldName;
+    std::function<T(const web::json::value&)> m_deserialize;
+    std::vector<T> m_items;
+    bool m_isDecoded;
+};
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
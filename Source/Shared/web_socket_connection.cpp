@@ -3,17 +3,53 @@
 
 #include "pch.h"
 #include <cpprest/ws_client.h>
-#include <thread>
 #include "user_context.h"
 #include "xbox_system_factory.h"
 #include "web_socket_connection.h"
 #include "utils.h"
+#if !XSAPI_U
+#include "ppltasks_extra.h"
+#else
+#include "ppltasks_extra_unix.h"
+#endif
 
 using namespace web::websockets::client;
 using namespace XBOX_LIVE_NAMESPACE::system;
+using namespace Concurrency::extras;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
+static const std::chrono::milliseconds RETRY_BASE_INTERVAL(100);
+static const std::chrono::milliseconds RETRY_MAX_INTERVAL(60 * 1000);
+
+const uint32_t web_socket_connection_stats::ATTEMPT_BUCKET_BOUNDS[] = { 1, 2, 4, 8, 16 };
+const uint32_t web_socket_connection_stats::LATENCY_BUCKET_BOUNDS_MS[] = { 100, 250, 500, 1000, 5000, 15000, 60000 };
+
+static void
+add_to_histogram(
+    _Inout_ uint32_t* histogram,
+    _In_ const uint32_t* bounds,
+    _In_ size_t boundCount,
+    _In_ uint64_t value
+    )
+{
+    size_t bucket = 0;
+    while (bucket < boundCount && value > bounds[bucket])
+    {
+        ++bucket;
+    }
+
+    ++histogram[bucket];
+}
+
+web_socket_connection_stats::web_socket_connection_stats() :
+    attemptCount(0),
+    connectCount(0)
+{
+    memset(attemptHistogram, 0, sizeof(attemptHistogram));
+    memset(latencyHistogram, 0, sizeof(latencyHistogram));
+}
+
 web_socket_connection::web_socket_connection(
     _In_ std::shared_ptr<user_context> userContext,
     _In_ web::uri uri,
@@ -27,7 +63,12 @@ web_socket_connection::web_socket_connection(
     m_state(web_socket_connection_state::disconnected),
     m_client(system::xbox_system_factory::get_factory()->create_web_socket_client()),
     m_closeCallbackSet(false),
-    m_closeRequested(false)
+    m_closeRequested(false),
+    m_connectGeneration(0),
+    m_connectAttempt(0),
+    m_retryInterval(RETRY_BASE_INTERVAL),
+    m_isStableDisconnected(false),
+    m_retryJitter(std::random_device()())
 {
     XSAPI_ASSERT(m_httpSetting != nullptr);
 
@@ -40,106 +81,227 @@ web_socket_connection::ensure_connected()
     // As soon as this API gets called, move away from disconnected state
     set_state_helper(web_socket_connection_state::activated);
 
+    uint32_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_stateLocker);
+
+        // If it's still connecting or connected return.
+        if (!m_connectingTask.is_done() || m_state == web_socket_connection_state::connected) return;
+
+        m_closeRequested = false;
+        m_connectedEvent = pplx::task_completion_event<void>();
+        m_connectingTask = pplx::create_task(m_connectedEvent);
+        generation = ++m_connectGeneration;
+        m_connectAttempt = 0;
+        m_connectStartTime = chrono_clock_t::now();
+        m_retryInterval = RETRY_BASE_INTERVAL;
+        m_isStableDisconnected = false;
+    }
+
+    // kick off connection
+    std::weak_ptr<web_socket_connection> thisWeakPtr = shared_from_this();
+    pplx::create_task([thisWeakPtr, generation]
+    {
+        std::shared_ptr<web_socket_connection> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            LOG_DEBUG("Start websocket connection task");
+            pThis->set_state_helper(web_socket_connection_state::connecting);
+            pThis->try_connect(generation);
+        }
+    });
+}
+
+web_socket_connection_stats
+web_socket_connection::stats()
+{
     std::lock_guard<std::mutex> lock(m_stateLocker);
+    return m_stats;
+}
 
-    // If it's still connecting or connected return.
-    if (!m_connectingTask.is_done() || m_state == web_socket_connection_state::connected) return;
+void
+web_socket_connection::try_connect(
+    _In_ uint32_t generation
+    )
+{
+    uint32_t connectAttempt = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_stateLocker);
+        if (generation != m_connectGeneration)
+        {
+            return;
+        }
 
-    m_closeRequested = false;
+        if (m_closeRequested)
+        {
+            LOG_DEBUG("Finish websocket connection task");
+            m_connectedEvent.set();
+            return;
+        }
+
+        connectAttempt = ++m_connectAttempt;
+        ++m_stats.attemptCount;
+    }
+
+    LOGS_INFO << "Websocket trying to connnect... attempt " << connectAttempt;
+
+    pplx::task<void> connectTask;
+    try
+    {
+        // real web socket connect call
+        connectTask = m_client->connect(m_userContext, m_uri, m_subProtocol);
+    }
+    catch (...)
+    {
+        connectTask = pplx::task_from_exception<void>(std::runtime_error("websocket connect failed"));
+    }
 
-    // kick off connection 
     std::weak_ptr<web_socket_connection> thisWeakPtr = shared_from_this();
-    m_connectingTask = pplx::create_task([thisWeakPtr]
+    connectTask.then([thisWeakPtr, generation](pplx::task<void> t)
     {
-        std::shared_ptr<web_socket_connection> pThis;
+        bool connected = false;
         try
         {
-            pThis = thisWeakPtr.lock();
-            if (pThis == nullptr)
-            {
-                throw std::runtime_error("xbox_web_socket_client_impl shutting down");
-            }
-
-            LOG_DEBUG("Start websocket connection task");
+            t.get();
+            connected = true;
+        }
+        catch (...)
+        {
+        }
 
-            pThis->set_state_helper(web_socket_connection_state::connecting);
-            bool connected = false;
-            bool isStableDisconnected = false;
+        std::shared_ptr<web_socket_connection> pThis(thisWeakPtr.lock());
+        if (pThis == nullptr)
+        {
+            return;
+        }
 
-            std::chrono::milliseconds retryInterval(100); // start retry internal with 100ms
-            auto timeStart = std::chrono::high_resolution_clock::now();
+        if (connected)
+        {
+            pThis->on_connect_succeeded(generation);
+        }
+        else
+        {
+            pThis->on_connect_failed(generation);
+        }
+    });
+}
 
-            int connectAttempt = 0;
-            while (!connected && !pThis->m_closeRequested)
-            {
-                try
-                {
-                    LOGS_INFO <<"Websocket trying to connnect... attempt " << ++connectAttempt;
-                    // real web socket connect call 
-                    pThis->m_client->connect(
-                        pThis->m_userContext,
-                        pThis->m_uri,
-                        pThis->m_subProtocol
-                        ).get();
-
-                    LOG_INFO("Websocket connnection established.");
-
-                    // This needs to execute after connected 
-                    // Can't get 'this' shared pointer in constructor, so place socket client calling setting to here.
-                    if (!pThis->m_closeCallbackSet)
-                    {
-                        std::weak_ptr<web_socket_connection> thisWeakPtr2 = pThis;
-                        pThis->m_client->set_closed_handler([thisWeakPtr2](uint16_t code, string_t reason)
-                        {
-                            auto pThis2 = thisWeakPtr2.lock();
-                            if (pThis2 != nullptr)
-                            {
-                                pThis2->on_close(code, reason);
-                            }
-                        });
-                        pThis->m_closeCallbackSet = true;
-                    }
-
-                    //connected, set state
-                    connected = true;
-                    pThis->set_state_helper(web_socket_connection_state::connected);
-                }
-                catch (...)
-                {
-                    LOG_INFO("Websocket connnection failed.");
-
-                    // check if we need to retry
-                    auto timeCurrent = std::chrono::high_resolution_clock::now();
-                    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(timeCurrent - timeStart);
-
-                    if (!isStableDisconnected)
-                    {
-                        isStableDisconnected = (duration >= pThis->m_httpSetting->websocket_timeout_window());
-                        if (isStableDisconnected)
-                        {
-                            //retry didn't help, notify caller, we're in stable disconnected state
-                            pThis->set_state_helper(web_socket_connection_state::disconnected);
-                        }
-                    }
-                    std::this_thread::sleep_for(retryInterval);
-
-                    // increase retry interval each time
-                    retryInterval = min((3 * retryInterval), std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::minutes(1)));
-                }
-            }
+void
+web_socket_connection::on_connect_succeeded(
+    _In_ uint32_t generation
+    )
+{
+    uint32_t connectAttempt = 0;
+    std::chrono::milliseconds latency;
+    {
+        std::lock_guard<std::mutex> lock(m_stateLocker);
+        if (generation != m_connectGeneration)
+        {
+            return;
         }
-        catch (...)
+
+        connectAttempt = m_connectAttempt;
+        latency = std::chrono::duration_cast<std::chrono::milliseconds>(chrono_clock_t::now() - m_connectStartTime);
+
+        ++m_stats.connectCount;
+        add_to_histogram(m_stats.attemptHistogram, web_socket_connection_stats::ATTEMPT_BUCKET_BOUNDS, ARRAYSIZE(web_socket_connection_stats::ATTEMPT_BUCKET_BOUNDS), connectAttempt);
+        add_to_histogram(m_stats.latencyHistogram, web_socket_connection_stats::LATENCY_BUCKET_BOUNDS_MS, ARRAYSIZE(web_socket_connection_stats::LATENCY_BUCKET_BOUNDS_MS), latency.count());
+    }
+
+    LOGS_INFO << "Websocket connnection established after " << connectAttempt << " attempts in " << latency.count() << "ms.";
+
+    // This needs to execute after connected
+    // Can't get 'this' shared pointer in constructor, so place socket client calling setting to here.
+    if (!m_closeCallbackSet)
+    {
+        std::weak_ptr<web_socket_connection> thisWeakPtr = shared_from_this();
+        m_client->set_closed_handler([thisWeakPtr](uint16_t code, string_t reason)
         {
+            auto pThis = thisWeakPtr.lock();
             if (pThis != nullptr)
             {
-                pThis->set_state_helper(web_socket_connection_state::disconnected);
+                pThis->on_close(code, reason);
             }
+        });
+        m_closeCallbackSet = true;
+    }
+
+    //connected, set state
+    set_state_helper(web_socket_connection_state::connected);
+
+    LOG_DEBUG("Finish websocket connection task");
+    std::lock_guard<std::mutex> lock(m_stateLocker);
+    m_connectedEvent.set();
+}
+
+void
+web_socket_connection::on_connect_failed(
+    _In_ uint32_t generation
+    )
+{
+    LOG_INFO("Websocket connnection failed.");
+
+    bool isStableDisconnected = false;
+    std::chrono::milliseconds retryInterval;
+    {
+        std::lock_guard<std::mutex> lock(m_stateLocker);
+        if (generation != m_connectGeneration)
+        {
+            return;
+        }
+
+        if (m_closeRequested)
+        {
+            LOG_DEBUG("Finish websocket connection task");
+            m_connectedEvent.set();
+            return;
         }
 
-        LOG_DEBUG("Finish websocket connection task");
+        // check if we need to retry
+        if (!m_isStableDisconnected)
+        {
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(chrono_clock_t::now() - m_connectStartTime);
+            m_isStableDisconnected = (duration >= m_httpSetting->websocket_timeout_window());
+            isStableDisconnected = m_isStableDisconnected;
+        }
+
+        retryInterval = next_retry_interval();
+    }
+
+    if (isStableDisconnected)
+    {
+        //retry didn't help, notify caller, we're in stable disconnected state
+        set_state_helper(web_socket_connection_state::disconnected);
+    }
+
+    // Wait out the retry on a timer rather than a sleeping thread
+    std::weak_ptr<web_socket_connection> thisWeakPtr = shared_from_this();
+    create_delayed_task(retryInterval, []()
+    {
+    }).then([thisWeakPtr, generation](pplx::task<void> t)
+    {
+        std::shared_ptr<web_socket_connection> pThis(thisWeakPtr.lock());
+        if (pThis != nullptr)
+        {
+            pThis->try_connect(generation);
+        }
     });
 }
 
+std::chrono::milliseconds
+web_socket_connection::next_retry_interval()
+{
+    // Decorrelated jitter: wait a random time between the base interval and three times the last wait, capped.
+    // This still backs off, but clients that dropped together spread out instead of reconnecting in lockstep.
+    std::uniform_int_distribution<int64_t> distribution(
+        RETRY_BASE_INTERVAL.count(),
+        __max(RETRY_BASE_INTERVAL.count(), 3 * m_retryInterval.count())
+        );
+
+    m_retryInterval = std::chrono::milliseconds(__min(distribution(m_retryJitter), RETRY_MAX_INTERVAL.count()));
+    return m_retryInterval;
+}
+
 web_socket_connection_state
 web_socket_connection::state()
 {
@@ -164,7 +326,14 @@ web_socket_connection::close()
     if (m_client == nullptr)
         return pplx::task_from_exception<void>(std::runtime_error("web socket is not created yet."));
 
-    m_closeRequested = true;
+    {
+        std::lock_guard<std::mutex> lock(m_stateLocker);
+        m_closeRequested = true;
+
+        // A retry waiting on its timer stops when the timer fires, callers waiting on the connection task don't need to
+        m_connectedEvent.set();
+    }
+
     return m_client->close();
 }
 
@@ -4,9 +4,31 @@
 #pragma once
 #include "web_socket_client.h"
 #include "web_socket_connection_state.h"
+#include <random>
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
+/// <summary>
+/// Connection counters for a web_socket_connection. Each time the connection is established, the number of
+/// attempts it took and the time since it started connecting are added to a histogram.
+/// </summary>
+struct web_socket_connection_stats
+{
+    static const size_t ATTEMPT_BUCKET_COUNT = 6;
+    static const size_t LATENCY_BUCKET_COUNT = 8;
+
+    // Inclusive upper bound of every bucket but the last, which holds everything above
+    static const uint32_t ATTEMPT_BUCKET_BOUNDS[ATTEMPT_BUCKET_COUNT - 1];
+    static const uint32_t LATENCY_BUCKET_BOUNDS_MS[LATENCY_BUCKET_COUNT - 1];
+
+    web_socket_connection_stats();
+
+    uint64_t attemptCount;
+    uint64_t connectCount;
+    uint32_t attemptHistogram[ATTEMPT_BUCKET_COUNT];
+    uint32_t latencyHistogram[LATENCY_BUCKET_COUNT];
+};
+
 class web_socket_connection : public std::enable_shared_from_this<web_socket_connection>
 {
 public:
@@ -39,7 +61,15 @@ public:
 
     pplx::task<void>& connection_task() { return m_connectingTask; }
 
+    web_socket_connection_stats stats();
+
 private:
+    // Attempts are chained on timers so no thread is held between them. Each call to ensure_connected() that starts
+    // connecting bumps m_connectGeneration, and a chain stops at its next step once it is stale or a close was requested.
+    void try_connect(_In_ uint32_t generation);
+    void on_connect_succeeded(_In_ uint32_t generation);
+    void on_connect_failed(_In_ uint32_t generation);
+    std::chrono::milliseconds next_retry_interval();
 
     void set_state_helper(_In_ web_socket_connection_state newState);
 
@@ -59,6 +89,13 @@ private:
 
     pplx::task<void> m_connectingTask;
     pplx::task_completion_event<void> m_connectedEvent;
+    uint32_t m_connectGeneration;
+    uint32_t m_connectAttempt;
+    chrono_clock_t::time_point m_connectStartTime;
+    std::chrono::milliseconds m_retryInterval;
+    bool m_isStableDisconnected;
+    std::mt19937 m_retryJitter;
+    web_socket_connection_stats m_stats;
 
     std::function<void(web_socket_connection_state oldState, web_socket_connection_state newState)> m_externalStateChangeHandler;
 
@@ -5,6 +5,7 @@
 #include "shared_macros.h"
 #include "xsapi/system.h"
 #include "xbox_system_factory.h"
+#include "http_call_impl.h"
 #if XSAPI_A
 #include "Logger/android/logcat_output.h"
 #else
@@ -82,7 +83,8 @@ xbox_live_context_settings::xbox_live_context_settings() :
     m_httpTimeoutWindow(std::chrono::seconds(DEFAULT_HTTP_RETRY_WINDOW_SECONDS)),
     m_useCoreDispatcherForEventRouting(false),
     m_disableAssertsForXboxLiveThrottlingInDevSandboxes(false),
-    m_disableAssertsForMaxNumberOfWebsocketsActivated(false)
+    m_disableAssertsForMaxNumberOfWebsocketsActivated(false),
+    m_lazyResultDeserialization(false)
 {
 }
 
@@ -208,6 +210,58 @@ void xbox_live_context_settings::set_use_core_dispatcher_for_event_routing(_In_
     m_useCoreDispatcherForEventRouting = value;
 }
 
+bool xbox_live_context_settings::lazy_result_deserialization() const
+{
+    return m_lazyResultDeserialization;
+}
+
+void xbox_live_context_settings::set_lazy_result_deserialization(_In_ bool value)
+{
+    m_lazyResultDeserialization = value;
+}
+
+double xbox_live_context_settings::http_api_throttle_rate() const
+{
+    return http_retry_after_manager::get_http_retry_after_manager_singleton()->default_api_throttle().tokensPerSecond;
+}
+
+uint32_t xbox_live_context_settings::http_api_throttle_capacity() const
+{
+    return http_retry_after_manager::get_http_retry_after_manager_singleton()->default_api_throttle().maxTokens;
+}
+
+void xbox_live_context_settings::set_http_api_throttle(
+    _In_ double callsPerSecond,
+    _In_ uint32_t capacity
+    )
+{
+    http_retry_after_manager::get_http_retry_after_manager_singleton()->set_default_api_throttle(
+        http_throttle_settings(__max(0.0, callsPerSecond), __max(1u, capacity))
+        );
+}
+
+double xbox_live_context_settings::http_host_throttle_rate(_In_ const string_t& host) const
+{
+    return http_retry_after_manager::get_http_retry_after_manager_singleton()->host_throttle(host).tokensPerSecond;
+}
+
+uint32_t xbox_live_context_settings::http_host_throttle_capacity(_In_ const string_t& host) const
+{
+    return http_retry_after_manager::get_http_retry_after_manager_singleton()->host_throttle(host).maxTokens;
+}
+
+void xbox_live_context_settings::set_http_host_throttle(
+    _In_ const string_t& host,
+    _In_ double callsPerSecond,
+    _In_ uint32_t capacity
+    )
+{
+    http_retry_after_manager::get_http_retry_after_manager_singleton()->set_host_throttle(
+        host,
+        http_throttle_settings(__max(0.0, callsPerSecond), __max(1u, capacity))
+        );
+}
+
 void xbox_live_context_settings::disable_asserts_for_xbox_live_throttling_in_dev_sandboxes(
     _In_ xbox_live_context_throttle_setting setting
     )
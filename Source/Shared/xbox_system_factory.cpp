@@ -81,7 +81,7 @@ xbox_system_factory::create_http_client(
     _In_ const web::http::client::http_client_config& clientConfig
     )
 {
-    return std::make_shared<xbox_http_client_impl>(
+    return http_client_pool::get_http_client_pool_singleton()->get_client(
         baseUri,
         clientConfig
         );
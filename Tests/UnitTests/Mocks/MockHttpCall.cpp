@@ -178,6 +178,24 @@ MockHttpCall::set_request_body(
     m_requestBody = http_call_request_message(value);
 }
 
+void
+MockHttpCall::set_request_body(
+    _In_ std::vector<BYTE>&& value
+    )
+{
+    m_requestBody = http_call_request_message(std::move(value));
+}
+
+void
+MockHttpCall::set_request_body(
+    _In_ std::shared_ptr<std::vector<BYTE>> buffer,
+    _In_ size_t offset,
+    _In_ size_t length
+    )
+{
+    m_requestBody = http_call_request_message(std::vector<BYTE>(buffer->begin() + offset, buffer->begin() + offset + length));
+}
+
 const http_call_request_message& MockHttpCall::request_body() const
 {
     return m_requestBody;
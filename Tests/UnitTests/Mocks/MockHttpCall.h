@@ -57,6 +57,8 @@ public:
     virtual void set_request_body(_In_ const string_t& value) override;
     virtual void set_request_body(_In_ const web::json::value& value) override;
     virtual void set_request_body(_In_ const std::vector<BYTE>& value) override;
+    virtual void set_request_body(_In_ std::vector<BYTE>&& value) override;
+    virtual void set_request_body(_In_ std::shared_ptr<std::vector<BYTE>> buffer, _In_ size_t offset, _In_ size_t length) override;
     virtual const http_call_request_message& request_body() const override;
 
     virtual void set_content_type_header_value(_In_ const std::wstring& value) override;
@@ -47,6 +47,11 @@ public:
         {
             m_sendHandler(message);
         }
+
+        if (m_sendToFail)
+        {
+            return pplx::task_from_exception<void>(std::runtime_error(""));
+        }
         return pplx::task_from_result();
     }
 
@@ -173,6 +178,7 @@ public:
         std::lock_guard<std::mutex> lock(m_lock);
         m_waitForSignal = false;
         m_connectToFail = false;
+        m_sendToFail = false;
         m_closeStatus = web::websockets::client::websocket_close_status::normal;
         m_subUriToIdMap.clear();
         m_eventUriToIdMap.clear();
@@ -185,6 +191,7 @@ public:
 
     bool m_waitForSignal = false;
     bool m_connectToFail = false;
+    bool m_sendToFail = false;
     web::websockets::client::websocket_close_status m_closeStatus = web::websockets::client::websocket_close_status::normal;
     concurrency::event m_connectEvent;
 
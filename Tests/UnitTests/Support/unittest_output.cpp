@@ -27,7 +27,7 @@ unittest_output::format_log(_In_ const log_entry& entry)
     std::stringstream stream;
 
     // format : "[<thread id>] <level> <category> - <msg>"
-    stream << " [" << std::this_thread::get_id() << "] ";
+    stream << " [" << entry.thread_id() << "] ";
     stream << entry.level_to_string() << " " << entry.category() << " - ";
     stream << entry.msg_stream().str();
 
@@ -6,6 +6,7 @@
 #define TEST_CLASS_AREA L"Achievements"
 #include "UnitTestIncludes.h"
 #include <xsapi/xbox_live_context.h>
+#include <crtdbg.h>
 
 using namespace Microsoft::Xbox::Services;
 using namespace Microsoft::Xbox::Services::Achievements;
@@ -94,6 +95,8 @@ LR"(
 }
 )";
 
+static uint32_t g_DecodeAllocCount;
+
 DEFINE_TEST_CLASS(AchievementsTests)
 {
 public:
@@ -251,6 +254,79 @@ public:
         VERIFY_ARE_EQUAL_STR(L"/users/xuid(xboxUserId1234)/achievements?titleId=777&types=challenge&unlockedOnly=true&orderBy=unlocktime&maxItems=20&skipItems=10", httpCall->PathQueryFragment.to_string());
     }
 
+    static int __cdecl DecodeAllocHook(int allocType, void*, size_t, int, long, const unsigned char*, int)
+    {
+        if (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC)
+        {
+            ++g_DecodeAllocCount;
+        }
+        return TRUE;
+    }
+
+    // Logs how long decode took and how many heap allocations it made. The CRT only calls the
+    // allocation hook in debug builds, so release builds log 0 allocations.
+    template<typename F>
+    static void MeasureDecode(_In_ const wchar_t* label, _In_ F decode)
+    {
+        g_DecodeAllocCount = 0;
+        auto previousHook = _CrtSetAllocHook(DecodeAllocHook);
+        auto startTime = std::chrono::high_resolution_clock::now();
+        decode();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+        _CrtSetAllocHook(previousHook);
+        uint32_t allocCount = g_DecodeAllocCount;
+
+        stringstream_t log;
+        log << label << L" time: " << elapsed.count() << L"ms allocations: " << allocCount;
+        TEST_LOG(log.str().c_str());
+    }
+
+    DEFINE_TEST_CASE(TestAchievementsResultLazyDeserialization)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestAchievementsResultLazyDeserialization);
+        const uint32_t pageSize = 1000;
+        auto achievementJson = web::json::value::parse(defaultAchievementResponse)[L"achievements"][0];
+        auto achievementsJson = web::json::value::array(pageSize);
+        for (uint32_t i = 0; i < pageSize; ++i)
+        {
+            achievementJson[L"id"] = web::json::value::string(std::to_wstring(i));
+            achievementsJson[i] = achievementJson;
+        }
+
+        auto pageJson = std::make_shared<web::json::value>();
+        (*pageJson)[L"achievements"] = achievementsJson;
+        (*pageJson)[L"pagingInfo"][L"continuationToken"] = web::json::value::string(L"1000");
+        std::shared_ptr<const web::json::value> page = pageJson;
+
+        xbox_live_result<achievements::achievements_result> eagerResult;
+        MeasureDecode(L"Eager achievements page", [&]() { eagerResult = achievements::achievements_result::_Deserialize(*page); });
+
+        xbox_live_result<achievements::achievements_result> lazyResult;
+        MeasureDecode(L"Lazy achievements page, not read", [&]() { lazyResult = achievements::achievements_result::_Deserialize_lazy(page); });
+        MeasureDecode(L"Lazy achievements page, first read", [&]() { lazyResult.payload().items(); });
+
+        VERIFY_IS_FALSE(eagerResult.err());
+        VERIFY_IS_FALSE(lazyResult.err());
+        VERIFY_IS_TRUE(lazyResult.payload().has_next());
+
+        // Copies share the decoded items instead of decoding again
+        auto lazyCopy = lazyResult.payload();
+        const auto& eagerItems = eagerResult.payload().items();
+        const auto& lazyItems = lazyCopy.items();
+        VERIFY_IS_TRUE(&lazyItems == &lazyResult.payload().items());
+        VERIFY_ARE_EQUAL_INT(pageSize, lazyItems.size());
+        VERIFY_ARE_EQUAL_INT(eagerItems.size(), lazyItems.size());
+        for (uint32_t i = 0; i < pageSize; ++i)
+        {
+            VERIFY_ARE_EQUAL(eagerItems[i].id(), lazyItems[i].id());
+            VERIFY_ARE_EQUAL(eagerItems[i].name(), lazyItems[i].name());
+            VERIFY_ARE_EQUAL_INT(eagerItems[i].progress_state(), lazyItems[i].progress_state());
+        }
+
+        auto missingItems = achievements::achievements_result::_Deserialize_lazy(std::make_shared<const web::json::value>(web::json::value::parse(LR"({"pagingInfo":{}})")));
+        VERIFY_IS_TRUE(missingItems.err() == xbox_live_error_code::json_error);
+    }
+
     DEFINE_TEST_CASE(TestGetAchievementsEmptyResult)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestGetAchievementsEmptyResult);
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#define TEST_CLASS_OWNER L"jasonsa"
+#define TEST_CLASS_AREA L"Events"
+#include "UnitTestIncludes.h"
+#include "events_internal.h"
+
+using namespace xbox::services::events;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
+
+DEFINE_TEST_CLASS(EventsTests)
+{
+public:
+    DEFINE_TEST_CLASS_PROPS(EventsTests);
+
+    in_game_event CreateEvent(_In_ int i)
+    {
+        in_game_event evt;
+        evt.name = L"Event" + std::to_wstring(i);
+        evt.measurements[L"score"] = web::json::value::number(i);
+        return evt;
+    }
+
+    DEFINE_TEST_CASE(TestInGameEventNameValidation)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestInGameEventNameValidation);
+
+        VERIFY_IS_TRUE(is_valid_in_game_event_name(L"PlayerDefeated", true));
+        VERIFY_IS_TRUE(is_valid_in_game_event_name(L"Player_Defeated2", true));
+        VERIFY_IS_TRUE(is_valid_in_game_event_name(L"score2", false));
+
+        VERIFY_IS_FALSE(is_valid_in_game_event_name(L"", true));
+        VERIFY_IS_FALSE(is_valid_in_game_event_name(L"2Player", true));
+        VERIFY_IS_FALSE(is_valid_in_game_event_name(L"_Player", true));
+        VERIFY_IS_FALSE(is_valid_in_game_event_name(L"Player Defeated", true));
+        VERIFY_IS_FALSE(is_valid_in_game_event_name(L"Player-Defeated", true));
+
+        // Field names may not contain underscores
+        VERIFY_IS_FALSE(is_valid_in_game_event_name(L"total_score", false));
+    }
+
+    DEFINE_TEST_CASE(TestInGameEventBatchFlush)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestInGameEventBatchFlush);
+        in_game_event_batch batch(8, 3, std::chrono::milliseconds(100));
+
+        // The first event asks for a timer, the third reaches the flush size and asks for a flush
+        bool flushNow = false;
+        bool startTimer = false;
+        VERIFY_IS_TRUE(batch.push(CreateEvent(0), flushNow, startTimer));
+        VERIFY_IS_TRUE(!flushNow && startTimer);
+        VERIFY_IS_TRUE(batch.push(CreateEvent(1), flushNow, startTimer));
+        VERIFY_IS_TRUE(!flushNow && !startTimer);
+        VERIFY_IS_TRUE(batch.push(CreateEvent(2), flushNow, startTimer));
+        VERIFY_IS_TRUE(flushNow && !startTimer);
+
+        // Only one flush is asked for until the pending one takes the events
+        VERIFY_IS_TRUE(batch.push(CreateEvent(3), flushNow, startTimer));
+        VERIFY_IS_TRUE(!flushNow && !startTimer);
+
+        auto events = batch.take();
+        VERIFY_ARE_EQUAL_UINT(4, events.size());
+        VERIFY_IS_TRUE(events[0].name == L"Event0");
+        VERIFY_IS_TRUE(events[3].name == L"Event3");
+        VERIFY_ARE_EQUAL_INT(3, events[3].measurements[L"score"].as_integer());
+        batch.on_flushed(3, 1);
+
+        auto stats = batch.stats();
+        VERIFY_ARE_EQUAL_UINT(4, stats.queuedCount);
+        VERIFY_ARE_EQUAL_UINT(3, stats.flushedCount);
+        VERIFY_ARE_EQUAL_UINT(1, stats.droppedCount);
+        VERIFY_ARE_EQUAL_UINT(0, stats.pendingCount);
+
+        // A new timer is only asked for once the last one has gone off
+        VERIFY_IS_TRUE(batch.push(CreateEvent(4), flushNow, startTimer));
+        VERIFY_IS_TRUE(!flushNow && !startTimer);
+        batch.on_flush_timer_elapsed();
+        VERIFY_IS_TRUE(batch.push(CreateEvent(5), flushNow, startTimer));
+        VERIFY_IS_TRUE(!flushNow && startTimer);
+        VERIFY_IS_TRUE(batch.flush_interval() == std::chrono::milliseconds(100));
+    }
+
+    DEFINE_TEST_CASE(TestInGameEventBatchDropsWhenFull)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestInGameEventBatchDropsWhenFull);
+        in_game_event_batch batch(4, 8, std::chrono::milliseconds(100));
+
+        bool flushNow = false;
+        bool startTimer = false;
+        for (int i = 0; i < 4; ++i)
+        {
+            VERIFY_IS_TRUE(batch.push(CreateEvent(i), flushNow, startTimer));
+        }
+
+        VERIFY_IS_FALSE(batch.push(CreateEvent(4), flushNow, startTimer));
+        auto stats = batch.stats();
+        VERIFY_ARE_EQUAL_UINT(4, stats.queuedCount);
+        VERIFY_ARE_EQUAL_UINT(1, stats.droppedCount);
+        VERIFY_ARE_EQUAL_UINT(4, stats.pendingCount);
+
+        // Taking the events makes room again
+        VERIFY_ARE_EQUAL_UINT(4, batch.take().size());
+        VERIFY_IS_TRUE(batch.push(CreateEvent(5), flushNow, startTimer));
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -9,6 +9,7 @@
 #include "Utils_WinRT.h"
 #include "xsapi/leaderboard.h"
 #include "leaderboard_serializers.h"
+#include <crtdbg.h>
 
 using namespace Windows::Foundation;
 using namespace xbox::services::leaderboard;
@@ -111,6 +112,8 @@ LR"({
     ]
 })";
 
+static uint32_t g_DecodeAllocCount;
+
 DEFINE_TEST_CLASS(leaderboard_serializer_tests)
 {
 public:
@@ -243,6 +246,93 @@ public:
         VerifyLeadershipResult(nextResult, responseJson, columns);
     }
 
+    static int __cdecl DecodeAllocHook(int allocType, void*, size_t, int, long, const unsigned char*, int)
+    {
+        if (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC)
+        {
+            ++g_DecodeAllocCount;
+        }
+        return TRUE;
+    }
+
+    // Logs how long decode took and how many heap allocations it made. The CRT only calls the
+    // allocation hook in debug builds, so release builds log 0 allocations.
+    template<typename F>
+    static void MeasureDecode(_In_ const wchar_t* label, _In_ F decode)
+    {
+        g_DecodeAllocCount = 0;
+        auto previousHook = _CrtSetAllocHook(DecodeAllocHook);
+        auto startTime = std::chrono::high_resolution_clock::now();
+        decode();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+        _CrtSetAllocHook(previousHook);
+        uint32_t allocCount = g_DecodeAllocCount;
+
+        stringstream_t log;
+        log << label << L" time: " << elapsed.count() << L"ms allocations: " << allocCount;
+        TEST_LOG(log.str().c_str());
+    }
+
+    DEFINE_TEST_CASE(TestLeaderboardResultLazyDeserialization)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestLeaderboardResultLazyDeserialization);
+        const uint32_t pageSize = 1000;
+        auto pageJson = std::make_shared<web::json::value>(web::json::value::parse(defaultLeaderboardData));
+        auto rowJson = (*pageJson)[L"userList"][0];
+        auto rowsJson = web::json::value::array(pageSize);
+        for (uint32_t i = 0; i < pageSize; ++i)
+        {
+            rowJson[L"xuid"] = web::json::value::string(std::to_wstring(2533275015216241 + i));
+            rowJson[L"rank"] = web::json::value::number(i + 1);
+            rowsJson[i] = rowJson;
+        }
+        (*pageJson)[L"userList"] = rowsJson;
+        std::shared_ptr<const web::json::value> page = pageJson;
+
+        auto eagerSettings = std::make_shared<xbox_live_context_settings>();
+        auto lazySettings = std::make_shared<xbox_live_context_settings>();
+        lazySettings->set_lazy_result_deserialization(true);
+
+        xbox_live_result<leaderboard_result> eagerResult;
+        MeasureDecode(L"Eager leaderboard page", [&]() { eagerResult = serializers::deserialize_result(page, nullptr, eagerSettings, nullptr); });
+
+        xbox_live_result<leaderboard_result> lazyResult;
+        MeasureDecode(L"Lazy leaderboard page, not read", [&]() { lazyResult = serializers::deserialize_result(page, nullptr, lazySettings, nullptr); });
+        MeasureDecode(L"Lazy leaderboard page, first read", [&]() { lazyResult.payload().rows(); });
+
+        VERIFY_IS_FALSE(eagerResult.err());
+        VERIFY_IS_FALSE(lazyResult.err());
+        VERIFY_ARE_EQUAL_INT(218, lazyResult.payload().total_row_count());
+
+        const auto& eagerRows = eagerResult.payload().rows();
+        const auto& lazyRows = lazyResult.payload().rows();
+        VERIFY_ARE_EQUAL_INT(pageSize, lazyRows.size());
+        VERIFY_ARE_EQUAL_INT(eagerRows.size(), lazyRows.size());
+        for (uint32_t i = 0; i < pageSize; ++i)
+        {
+            VERIFY_ARE_EQUAL(eagerRows[i].xbox_user_id(), lazyRows[i].xbox_user_id());
+            VERIFY_ARE_EQUAL_INT(eagerRows[i].rank(), lazyRows[i].rank());
+            VERIFY_IS_TRUE(eagerRows[i].column_values() == lazyRows[i].column_values());
+        }
+
+        // Additional columns are filled in from the decoded rows
+        auto responseJson = web::json::value::parse(defaultLeaderboardData);
+        m_mockXboxSystemFactory->GetMockHttpCall()->ResultValue = StockMocks::CreateMockHttpCallResponse(responseJson);
+
+        std::vector<string_t> columns;
+        columns.push_back(_T("HasSkull"));
+        columns.push_back(_T("Level"));
+
+        XboxLiveContext^ xboxLiveContext = GetMockXboxLiveContext_WinRT();
+        xboxLiveContext->Settings->LazyResultDeserialization = true;
+        auto result = create_task(xboxLiveContext->LeaderboardService->GetLeaderboardWithAdditionalColumnsAsync(
+            "c4060100-4951-4a51-a630-dce26c15b8c5",
+            "lbEncodedRecordHoleId101RecordTypeId1",
+            UtilsWinRT::CreatePlatformVectorFromStdVectorString(columns)->GetView()
+            )).get();
+        VerifyLeadershipResult(result, responseJson, columns);
+    }
+
     DEFINE_TEST_CASE(TestGetLeaderboardWitSkipToRankAsync)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestGetLeaderboardWitSkipToRankAsync);
@@ -2687,17 +2687,19 @@ public:
         else
             VERIFY_IS_TRUE(mpInstance->GameSession->GetCppObj()->_Change_number() == 1);
 
-        // Test deep_copy_if_updated
-        clientManager->last_pending_read()->deep_copy_if_updated(*clientManager->latest_pending_read());
+        // Test publish_snapshot
+        clientManager->publish_snapshot();
         if (isLobbyTest)
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->lobby_client()->lobby()->_Change_number() == 1);     // no DoWork() so the actual lobby obj is still stale
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->lobby->_Change_number() == 1);     // no DoWork() so the actual lobby obj is still stale
             VERIFY_IS_TRUE(sessionWriter->session()->change_number() == 2);
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->lobbySession == sessionWriter->session());     // the snapshot shares the session rather than copying it
         }
         else
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->game_client()->game()->_Change_number() == 1);     // no DoWork() so the actual lobby obj is still stale
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->game->_Change_number() == 1);     // no DoWork() so the actual lobby obj is still stale
             VERIFY_IS_TRUE(sessionWriter->session()->change_number() == 2);
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->gameSession == sessionWriter->session());     // the snapshot shares the session rather than copying it
         }
 
         VERIFY_IS_TRUE(clientManager->is_update_avaialable());
@@ -2713,12 +2715,12 @@ public:
         mpInstance->DoWork();
         if (isLobbyTest)
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->lobby_client()->lobby()->_Change_number() == 4);     // called DoWork(), should update
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->lobby->_Change_number() == 4);     // called DoWork(), should update
             VERIFY_IS_TRUE(mpInstance->LobbySession->GetCppObj()->_Change_number() == 4);
         }
         else
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->game_client()->game()->_Change_number() == 4);       // called DoWork(), should update
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->game->_Change_number() == 4);       // called DoWork(), should update
             VERIFY_IS_TRUE(mpInstance->GameSession->GetCppObj()->_Change_number() == 4);
         }
     }
@@ -2840,31 +2842,31 @@ public:
         mpInstance->DoWork();
         if (isLobbyTest)
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->lobby_client()->lobby()->_Change_number() == 4);
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->lobby->_Change_number() == 4);
             VERIFY_IS_TRUE(mpInstance->LobbySession->GetCppObj()->_Change_number() == 4);
         }
         else
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->game_client()->game()->_Change_number() == 4);
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->game->_Change_number() == 4);
             VERIFY_IS_TRUE(mpInstance->GameSession->GetCppObj()->_Change_number() == 4);
         }
 
         sessionWriter->write_session(primaryContext, mpsdSession, multiplayer::multiplayer_session_write_mode::update_existing).get();
         VERIFY_IS_TRUE(clientManager->is_update_avaialable());
-        clientManager->last_pending_read()->deep_copy_if_updated(*clientManager->latest_pending_read());
+        clientManager->publish_snapshot();
         if (isLobbyTest)
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->lobby_client()->lobby()->_Change_number() == 4);     // no DoWork() so the actual lobby obj is still stale
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->lobby->_Change_number() == 4);     // no DoWork() so the actual lobby obj is still stale
             VERIFY_IS_TRUE(sessionWriter->session()->change_number() == 6);
         }
         else
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->game_client()->game()->_Change_number() == 4);     // no DoWork() so the actual lobby obj is still stale
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->game->_Change_number() == 4);     // no DoWork() so the actual lobby obj is still stale
             VERIFY_IS_TRUE(sessionWriter->session()->change_number() == 6);
         }
         VERIFY_IS_TRUE(clientManager->is_update_avaialable());
 
-        // Even though I manually deep copied the objects, this will update the MPM session objects as is_update_avaialable() will return true.
+        // Even though I manually published a snapshot, this will update the MPM session objects as is_update_avaialable() will return true.
         mpInstance->DoWork();
         if (isLobbyTest)
             VERIFY_IS_TRUE(mpInstance->LobbySession->GetCppObj()->_Change_number() == 6);
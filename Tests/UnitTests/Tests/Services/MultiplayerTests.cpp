@@ -2855,6 +2855,47 @@ public:
         VERIFY_IS_FALSE(static_cast<MultiplayerSessionChangeTypes>(static_cast<uint32>(MultiplayerSessionChangeTypes::MemberCustomPropertyChange) & changeType) == MultiplayerSessionChangeTypes::MemberCustomPropertyChange);
     }
 
+    DEFINE_TEST_CASE(TestCompareMultiplayerSessionsMembers)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestCompareMultiplayerSessionsMembers);
+
+        auto createSession = [](const web::json::value& json)
+        {
+            auto sessionResult = multiplayer_session::_Deserialize(json);
+            VERIFY_IS_TRUE(!sessionResult.err());
+            return std::make_shared<multiplayer_session>(sessionResult.payload());
+        };
+
+        auto responseJson = web::json::value::parse(defaultMultiplayerResponse);
+        auto oldSession = createSession(responseJson);
+
+        // Same content, parsed separately
+        auto changeType = static_cast<uint32_t>(multiplayer_session::compare_multiplayer_sessions(createSession(responseJson), oldSession).payload());
+        VERIFY_ARE_EQUAL_INT(0, changeType & static_cast<uint32_t>(multiplayer_session_change_types::member_list_change));
+        VERIFY_ARE_EQUAL_INT(0, changeType & static_cast<uint32_t>(multiplayer_session_change_types::member_status_change));
+        VERIFY_ARE_EQUAL_INT(0, changeType & static_cast<uint32_t>(multiplayer_session_change_types::member_custom_property_change));
+        VERIFY_ARE_EQUAL_INT(0, changeType & static_cast<uint32_t>(multiplayer_session_change_types::custom_property_change));
+
+        auto changedJson = responseJson;
+        changedJson[L"members"][L"1"][L"properties"][L"custom"][L"score"] = web::json::value::number(10);
+        changedJson[L"properties"][L"custom"][L"map"] = web::json::value::string(L"harbor");
+        changeType = static_cast<uint32_t>(multiplayer_session::compare_multiplayer_sessions(createSession(changedJson), oldSession).payload());
+        VERIFY_ARE_EQUAL_INT(0, changeType & static_cast<uint32_t>(multiplayer_session_change_types::member_list_change));
+        VERIFY_IS_TRUE((changeType & static_cast<uint32_t>(multiplayer_session_change_types::member_custom_property_change)) != 0);
+        VERIFY_IS_TRUE((changeType & static_cast<uint32_t>(multiplayer_session_change_types::custom_property_change)) != 0);
+
+        changedJson = responseJson;
+        changedJson[L"members"][L"1"][L"constants"][L"system"][L"xuid"] = web::json::value::string(L"5678");
+        changeType = static_cast<uint32_t>(multiplayer_session::compare_multiplayer_sessions(createSession(changedJson), oldSession).payload());
+        VERIFY_IS_TRUE((changeType & static_cast<uint32_t>(multiplayer_session_change_types::member_list_change)) != 0);
+        VERIFY_ARE_EQUAL_INT(0, changeType & static_cast<uint32_t>(multiplayer_session_change_types::member_custom_property_change));
+
+        changedJson = responseJson;
+        changedJson[L"members"][L"0"][L"constants"][L"system"][L"xuid"] = web::json::value::string(L"OtherXboxUserId");
+        changeType = static_cast<uint32_t>(multiplayer_session::compare_multiplayer_sessions(createSession(changedJson), oldSession).payload());
+        VERIFY_IS_TRUE((changeType & static_cast<uint32_t>(multiplayer_session_change_types::member_list_change)) != 0);
+    }
+
     DEFINE_TEST_CASE(TestRTAMultiplayer)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestRTAMultiplayer);
@@ -11,6 +11,7 @@
 #include "RealTimeActivityService_WinRT.h"
 #include "xsapi/real_time_activity.h"
 #include "RtaTestHelper.h"
+#include "real_time_activity_internal.h"
 #include "SocialManager_WinRT.h"
 #include "MultiplayerManager_WinRT.h"
 
@@ -51,6 +52,20 @@ const string_t rtaResyncMessage = LR"(
     [4]
 )";
 
+// Frames recorded from a presence and relationship heavy session, replayed by the decoder benchmark
+const string_t rtaRecordedFrames[] =
+{
+    LR"([3,12,"XboxOne:true"])",
+    LR"([3,13,"started"])",
+    LR"([3,14,"WindowsOneCore:false"])",
+    LR"([3,15,{"NotificationType":"Added","Xuids":["2814613569642996","2814613569642997"]}])",
+    LR"([1,5,0,16,{"xuid":"2814613569642996","state":"Online","devices":[{"type":"XboxOne","titles":[{"id":"1234","name":"Default Title","placement":"Full","state":"Active","activity":{"richPresence":"Home"},"lastModified":"2016-09-30T00:15:35.5994615Z"}]}]}])",
+    LR"([3,16,{"xuid":"2814613569642996","state":"Offline","note":"escaped \"quote\" and ] bracket"}])",
+    LR"([2,6,0])",
+    LR"([1,7,1,"error message"])",
+    LR"( [ 4 ] )"
+};
+
 class TestSubscription : public real_time_activity_subscription
 {
 public:
@@ -82,6 +97,11 @@ public:
         }
     }
 
+    const string_t& guid() const
+    {
+        return m_guid;
+    }
+
     void reset()
     {
         pendingSubEvent.reset();
@@ -198,6 +218,293 @@ public:
         );
     }
 
+    DEFINE_TEST_CASE(TestFrameDecoder)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestFrameDecoder);
+
+        for (const auto& message : rtaRecordedFrames)
+        {
+            real_time_activity_frame frame;
+            VERIFY_IS_TRUE(frame.decode(message));
+
+            // Every element must match what a full parse of the frame finds
+            auto messageJson = web::json::value::parse(message);
+            VERIFY_ARE_EQUAL_INT(messageJson.size(), frame.element_count());
+            for (size_t i = 0; i < frame.element_count(); ++i)
+            {
+                VERIFY_IS_TRUE(frame.element_json(i) == messageJson[i]);
+
+                int32_t value = 0;
+                VERIFY_ARE_EQUAL(messageJson[i].is_integer(), frame.try_get_integer(i, value));
+                if (messageJson[i].is_integer())
+                {
+                    VERIFY_ARE_EQUAL_INT(messageJson[i].as_integer(), value);
+                }
+
+                string_t stringValue;
+                VERIFY_ARE_EQUAL(messageJson[i].is_string(), real_time_activity_frame::try_decode_string(frame.element_data(i), frame.element_length(i), stringValue));
+                if (messageJson[i].is_string())
+                {
+                    VERIFY_ARE_EQUAL_STR(messageJson[i].as_string(), stringValue);
+                }
+            }
+        }
+
+        real_time_activity_frame frame;
+        VERIFY_IS_TRUE(!frame.decode(L""));
+        VERIFY_IS_TRUE(!frame.decode(L"{}"));
+        VERIFY_IS_TRUE(!frame.decode(L"[3,1"));
+        VERIFY_IS_TRUE(!frame.decode(L"[3,1,\"unterminated]"));
+        VERIFY_IS_TRUE(!frame.decode(L"[3,,1]"));
+        VERIFY_IS_TRUE(frame.decode(L"[]"));
+        VERIFY_ARE_EQUAL_INT(0, frame.element_count());
+
+        int32_t value = 0;
+        VERIFY_IS_TRUE(frame.decode(L"[3000000000,-5,1.5]"));
+        VERIFY_IS_TRUE(!frame.try_get_integer(0, value));
+        VERIFY_IS_TRUE(frame.try_get_integer(1, value));
+        VERIFY_ARE_EQUAL_INT(-5, value);
+        VERIFY_IS_TRUE(!frame.try_get_integer(2, value));
+        VERIFY_IS_TRUE(!frame.try_get_integer(3, value));
+    }
+
+    DEFINE_TEST_CASE(TestFrameDecoderBenchmark)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestFrameDecoderBenchmark);
+        const int iterations = 10000;
+
+        // Baseline: what on_socket_message_received used to do for every frame
+        int64_t domChecksum = 0;
+        auto domStart = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (const auto& message : rtaRecordedFrames)
+            {
+                auto messageJson = web::json::value::parse(message);
+                domChecksum += messageJson[0].as_integer();
+            }
+        }
+        auto domTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - domStart);
+
+        int64_t frameChecksum = 0;
+        auto frameStart = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (const auto& message : rtaRecordedFrames)
+            {
+                real_time_activity_frame frame;
+                int32_t messageType = 0;
+                frame.decode(message);
+                frame.try_get_integer(0, messageType);
+                frameChecksum += messageType;
+            }
+        }
+        auto frameTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - frameStart);
+
+        VERIFY_ARE_EQUAL(domChecksum, frameChecksum);
+        TEST_LOG(FormatString(L"Replayed %d RTA frames. DOM parse: %d ms. Frame decoder: %d ms.", static_cast<int>(iterations * ARRAYSIZE(rtaRecordedFrames)), static_cast<int>(domTime.count()), static_cast<int>(frameTime.count())).c_str());
+    }
+
+    DEFINE_TEST_CASE(TestRoutingTable)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestRoutingTable);
+        auto errFunc = [](xbox::services::real_time_activity::real_time_activity_subscription_error_event_args args) {};
+        real_time_activity_routing_table routingTable;
+
+        std::vector<std::shared_ptr<TestSubscription>> subscriptions;
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            subscriptions.push_back(std::make_shared<TestSubscription>(errFunc));
+            routingTable.insert(i, subscriptions.back());
+        }
+
+        // Readers keep finding every live subscription while others are removed and added around them
+        std::atomic<bool> isRunning(true);
+        std::atomic<uint32_t> missCount(0);
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.push_back(std::thread([&]()
+            {
+                while (isRunning)
+                {
+                    for (uint32_t id = 0; id < 50; ++id)
+                    {
+                        if (routingTable.find(id) != subscriptions[id])
+                        {
+                            ++missCount;
+                        }
+                    }
+                }
+            }));
+        }
+
+        for (int round = 0; round < 100; ++round)
+        {
+            for (uint32_t id = 50; id < 100; ++id)
+            {
+                routingTable.erase(id);
+                routingTable.insert(id + 100, subscriptions[id]);
+            }
+            for (uint32_t id = 50; id < 100; ++id)
+            {
+                routingTable.erase(id + 100);
+                routingTable.insert(id, subscriptions[id]);
+            }
+        }
+
+        isRunning = false;
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+
+        VERIFY_ARE_EQUAL_INT(0, missCount);
+        VERIFY_IS_TRUE(routingTable.find(99) == subscriptions[99]);
+        VERIFY_IS_TRUE(routingTable.find(199) == nullptr);
+
+        routingTable.clear();
+        VERIFY_IS_TRUE(routingTable.find(0) == nullptr);
+    }
+
+    DEFINE_TEST_CASE(TestSubmissionQueue)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestSubmissionQueue);
+        auto errFunc = [](xbox::services::real_time_activity::real_time_activity_subscription_error_event_args args) {};
+        real_time_activity_submission_queue queue;
+
+        real_time_activity_subscription_priority priorities[] =
+        {
+            real_time_activity_subscription_priority::low,
+            real_time_activity_subscription_priority::normal,
+            real_time_activity_subscription_priority::high,
+            real_time_activity_subscription_priority::normal,
+            real_time_activity_subscription_priority::high
+        };
+
+        std::vector<std::shared_ptr<TestSubscription>> subscriptions;
+        for (auto priority : priorities)
+        {
+            subscriptions.push_back(std::make_shared<TestSubscription>(errFunc));
+            subscriptions.back()->set_priority(priority);
+            queue.push(subscriptions.back());
+        }
+        VERIFY_ARE_EQUAL_INT(5, queue.size());
+
+        // Highest priority first, in the order they were queued within a priority
+        VERIFY_IS_TRUE(queue.pop() == subscriptions[2]);
+        VERIFY_IS_TRUE(queue.pop() == subscriptions[4]);
+        VERIFY_IS_TRUE(queue.remove(subscriptions[1]->guid()));
+        VERIFY_IS_TRUE(!queue.remove(subscriptions[1]->guid()));
+        VERIFY_IS_TRUE(queue.pop() == subscriptions[3]);
+
+        auto remaining = queue.remove_all();
+        VERIFY_ARE_EQUAL_INT(1, remaining.size());
+        VERIFY_IS_TRUE(remaining[0] == subscriptions[0]);
+        VERIFY_IS_TRUE(queue.empty());
+        VERIFY_IS_TRUE(queue.pop() == nullptr);
+
+        queue.set_window_size(0);
+        VERIFY_ARE_EQUAL_INT(1, queue.window_size());
+    }
+
+    DEFINE_TEST_CASE(TestSubmissionWindow)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestSubmissionWindow);
+        auto xboxLiveContext = GetMockXboxLiveContext_WinRT();
+        auto mockSocket = m_mockXboxSystemFactory->GetMockWebSocketClient();
+        auto helper = SetupStateChangeHelper(xboxLiveContext->RealTimeActivityService);
+
+        // Record subscribe requests without answering them
+        auto sentLock = std::make_shared<std::mutex>();
+        auto sentSequences = std::make_shared<std::vector<int>>();
+        mockSocket->set_send_handler([sentLock, sentSequences](string_t message)
+        {
+            auto messageJson = web::json::value::parse(message);
+            if (messageJson[0].as_integer() == 1)
+            {
+                std::lock_guard<std::mutex> lock(*sentLock);
+                sentSequences->push_back(messageJson[1].as_integer());
+            }
+        });
+
+        auto nativeRTA = xboxLiveContext->RealTimeActivityService->GetCppObj();
+        nativeRTA->_Set_submission_window(4);
+        xboxLiveContext->RealTimeActivityService->Activate();
+        helper->connectedEvent.wait();
+
+        auto errFunc = [](xbox::services::real_time_activity::real_time_activity_subscription_error_event_args args) {};
+        std::vector<std::shared_ptr<TestSubscription>> subscriptions;
+        for (int i = 0; i < 10; ++i)
+        {
+            subscriptions.push_back(std::make_shared<TestSubscription>(errFunc));
+            VERIFY_IS_TRUE(!nativeRTA->_Add_subscription(subscriptions.back()).err());
+        }
+
+        auto stats = nativeRTA->_Submission_stats();
+        VERIFY_ARE_EQUAL_INT(4, sentSequences->size());
+        VERIFY_ARE_EQUAL_INT(4, stats.inFlightCount);
+        VERIFY_ARE_EQUAL_INT(6, stats.queueLength);
+
+        // Each response lets one more request out
+        int sequence = (*sentSequences)[0];
+        stringstream_t response;
+        response << "[1," << sequence << ",0," << sequence << ",{}]";
+        mockSocket->recieve_message(response.str());
+
+        stats = nativeRTA->_Submission_stats();
+        VERIFY_ARE_EQUAL_INT(5, sentSequences->size());
+        VERIFY_ARE_EQUAL_INT(5, stats.sentCount);
+        VERIFY_ARE_EQUAL_INT(4, stats.inFlightCount);
+        VERIFY_ARE_EQUAL_INT(5, stats.queueLength);
+
+        // Unsent subscriptions are dropped without a round trip
+        nativeRTA->_Remove_subscription(subscriptions.back());
+        VERIFY_ARE_EQUAL_INT(subscriptions.back()->state(), real_time_activity_subscription_state::closed);
+        VERIFY_ARE_EQUAL_INT(4, nativeRTA->_Submission_stats().queueLength);
+        VERIFY_ARE_EQUAL_INT(5, sentSequences->size());
+    }
+
+    DEFINE_TEST_CASE(TestSubmissionWindowSendFailure)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestSubmissionWindowSendFailure);
+        auto xboxLiveContext = GetMockXboxLiveContext_WinRT();
+        auto mockSocket = m_mockXboxSystemFactory->GetMockWebSocketClient();
+        auto helper = SetupStateChangeHelper(xboxLiveContext->RealTimeActivityService);
+
+        auto nativeRTA = xboxLiveContext->RealTimeActivityService->GetCppObj();
+        nativeRTA->_Set_submission_window(2);
+        xboxLiveContext->RealTimeActivityService->Activate();
+        helper->connectedEvent.wait();
+
+        mockSocket->m_sendToFail = true;
+        auto errFunc = [](xbox::services::real_time_activity::real_time_activity_subscription_error_event_args args) {};
+        auto subscription = std::make_shared<TestSubscription>(errFunc);
+        VERIFY_IS_TRUE(!nativeRTA->_Add_subscription(subscription).err());
+        VERIFY_IS_TRUE(!nativeRTA->_Add_subscription(std::make_shared<TestSubscription>(errFunc)).err());
+
+        // Failed sends give their window slots back and wait to be sent again
+        auto stats = nativeRTA->_Submission_stats();
+        for (int i = 0; i < 100 && stats.inFlightCount > 0; ++i)
+        {
+            Sleep(10);
+            stats = nativeRTA->_Submission_stats();
+        }
+        VERIFY_ARE_EQUAL_INT(0, stats.inFlightCount);
+        VERIFY_ARE_EQUAL_INT(2, stats.queueLength);
+        VERIFY_ARE_EQUAL_INT(subscription->state(), real_time_activity_subscription_state::pending_subscribe);
+
+        // They are resent on a backoff timer without any other submission
+        mockSocket->m_sendToFail = false;
+        for (int i = 0; i < 3000 && stats.inFlightCount < 2; ++i)
+        {
+            Sleep(10);
+            stats = nativeRTA->_Submission_stats();
+        }
+        VERIFY_ARE_EQUAL_INT(2, stats.inFlightCount);
+        VERIFY_ARE_EQUAL_INT(0, stats.queueLength);
+    }
+
     DEFINE_TEST_CASE(TestSubscriptionBeforeActivate)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestSubscriptionBeforeActivate);
@@ -285,6 +592,11 @@ public:
             VERIFY_ARE_EQUAL_INT(subscription->state(), real_time_activity_subscription_state::subscribed);
         }
 
+        auto submissionStats = nativeRTA->_Submission_stats();
+        VERIFY_IS_TRUE(submissionStats.resubscribeCount >= 1);
+        VERIFY_ARE_EQUAL_INT(0, submissionStats.queueLength);
+        TEST_LOG(FormatString(L"Resubscribed %d subscriptions in %d ms", (int)subscriptionTestAmount, (int)submissionStats.lastResubscribeLatency.count()).c_str());
+
         for (auto& subscription : subscriptionList)
         {
             auto result = nativeRTA->_Remove_subscription(subscription);
@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include "pch.h"
+#include <fstream>
 #define TEST_CLASS_OWNER L"blgross"
 #define TEST_CLASS_AREA L"SimplfiedStatService"
 #include "UnitTestIncludes.h"
@@ -156,6 +157,125 @@ public:
             httpCall->PathQueryFragment.to_string()
             );
     }
+
+    DEFINE_TEST_CASE(SimplifiedStatServicePostSVDUploadSize)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(SimplifiedStatServicePostSVDUploadSize);
+        auto simplifiedStatService = GetSimplifiedStatsService();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+
+        auto statsValueDoc = GetStatValueDocument(simplifiedStatService, httpCall, statValueDocumentResponse);
+        statsValueDoc.set_stat(L"headshots", 8.f);
+        statsValueDoc.do_work();
+
+        // Every stat goes up, not just the changed one
+        stats_upload_info uploadInfo;
+        VERIFY_IS_TRUE(!simplifiedStatService.update_stats_value_document(statsValueDoc, &uploadInfo).get().err());
+        auto requestBody = httpCall->request_body().request_message_string();
+        auto titleField = web::json::value::parse(requestBody)[L"stats"][L"title"].as_object();
+        VERIFY_ARE_EQUAL_INT(requestBody.size(), uploadInfo.sizeInBytes);
+        VERIFY_ARE_EQUAL_INT(4, titleField.size());
+        VERIFY_IS_TRUE(titleField[L"headshots"][L"value"].as_double() == 8);
+
+        // A deleted stat is left out of the next document
+        statsValueDoc.delete_stat(L"strangeStat");
+        statsValueDoc.do_work();
+        VERIFY_IS_TRUE(!simplifiedStatService.update_stats_value_document(statsValueDoc, &uploadInfo).get().err());
+        titleField = web::json::value::parse(httpCall->request_body().request_message_string())[L"stats"][L"title"].as_object();
+        VERIFY_ARE_EQUAL_INT(3, titleField.size());
+    }
+
+    DEFINE_TEST_CASE(StatValueDocumentHandles)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(StatValueDocumentHandles);
+
+        stats_value_document svd;
+        svd.set_state(svd_state::offline_not_loaded);
+        uint32_t headshots = svd.intern_stat(_T("headshots"));
+        uint32_t gameMode = svd.intern_stat(_T("gameMode"));
+        VERIFY_ARE_EQUAL_INT(headshots, svd.intern_stat(_T("headshots")));
+        VERIFY_IS_TRUE(headshots != gameMode);
+
+        // Interning alone doesn't create the stat
+        VERIFY_IS_TRUE(svd.get_stat(headshots).err());
+        VERIFY_IS_TRUE(svd.set_stat(gameMode + 1, 1.0).err());
+
+        VERIFY_IS_TRUE(!svd.set_stat(headshots, 12.0).err());
+        VERIFY_IS_TRUE(!svd.set_stat(gameMode, _T("ranked")).err());
+        svd.do_work();
+        VERIFY_IS_TRUE(svd.get_stat(headshots).payload().as_number() == 12);
+        VERIFY_ARE_EQUAL_STR(_T("ranked"), svd.get_stat(_T("gameMode")).payload().as_string());
+
+        // Handles survive a delete and a merge with a document that interned its stats in another order
+        svd.delete_stat(_T("gameMode"));
+        svd.do_work();
+        VERIFY_IS_TRUE(svd.get_stat(gameMode).err());
+
+        auto serviceSVD = stats_value_document::_Deserialize(web::json::value::parse(statValueDocumentResponse)).payload();
+        svd.merge_stat_value_documents(serviceSVD);
+        VERIFY_IS_TRUE(svd.get_stat(headshots).payload().as_number() == 12);
+        VERIFY_ARE_EQUAL_STR(_T("foo"), svd.get_stat(_T("strangeStat")).payload().as_string());
+
+        std::vector<string_t> statNames;
+        svd.get_stat_names(statNames);
+        VERIFY_ARE_EQUAL_INT(4, statNames.size());
+
+        VERIFY_IS_TRUE(!svd.set_stat(gameMode, _T("casual")).err());
+        svd.do_work();
+        VERIFY_ARE_EQUAL_STR(_T("casual"), svd.get_stat(gameMode).payload().as_string());
+    }
+
+    DEFINE_TEST_CASE(StatsJournal)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(StatsJournal);
+
+        wchar_t tempPath[MAX_PATH];
+        GetTempPath(MAX_PATH, tempPath);
+        string_t journalPath = string_t(tempPath) + _T("StatsJournalTest.journal");
+        DeleteFile(journalPath.c_str());
+
+        stats_journal journal(journalPath);
+        VERIFY_IS_TRUE(!journal.open().err());
+        journal.record_set_stat(_T("headshots"), 8);
+        journal.record_set_stat(_T("gameMode"), _T("ranked"));
+        journal.record_delete_stat(_T("strangeStat"));
+        VERIFY_IS_TRUE(!journal.commit().err());
+
+        // A later session loads the records and replays them over the service document
+        stats_journal reopenedJournal(journalPath);
+        VERIFY_IS_TRUE(!reopenedJournal.open().err());
+        VERIFY_ARE_EQUAL_INT(3, reopenedJournal.record_count());
+        VERIFY_ARE_EQUAL_INT(3, reopenedJournal.last_sequence());
+
+        auto svd = stats_value_document::_Deserialize(web::json::value::parse(statValueDocumentResponse)).payload();
+        reopenedJournal.replay(svd);
+        svd.do_work();
+        VERIFY_IS_TRUE(svd.is_dirty());
+        VERIFY_IS_TRUE(svd.get_stat(_T("headshots")).payload().as_number() == 8);
+        VERIFY_ARE_EQUAL_STR(_T("ranked"), svd.get_stat(_T("gameMode")).payload().as_string());
+        VERIFY_IS_TRUE(svd.get_stat(_T("strangeStat")).err());
+
+        // A torn append is dropped without losing the records before it
+        {
+            std::ofstream journalFile(journalPath, std::ios_base::out | std::ios_base::binary | std::ios_base::app);
+            journalFile << "0badf00d {\"seq\":4,\"na";
+        }
+
+        stats_journal tornJournal(journalPath);
+        VERIFY_IS_TRUE(!tornJournal.open().err());
+        VERIFY_ARE_EQUAL_INT(3, tornJournal.record_count());
+
+        // Records the service accepted are dropped from the file
+        VERIFY_IS_TRUE(!tornJournal.checkpoint(2).err());
+        VERIFY_ARE_EQUAL_INT(1, tornJournal.record_count());
+
+        stats_journal checkpointedJournal(journalPath);
+        VERIFY_IS_TRUE(!checkpointedJournal.open().err());
+        VERIFY_ARE_EQUAL_INT(1, checkpointedJournal.record_count());
+        VERIFY_ARE_EQUAL_INT(3, checkpointedJournal.last_sequence());
+
+        DeleteFile(journalPath.c_str());
+    }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
\ No newline at end of file
@@ -150,6 +150,7 @@ const string_t rtaResyncMessage = LR"(
 )";
 
 const uint32_t m_numUsers = 100;
+static std::atomic<uint32_t> g_DiffAllocCount;
 struct SocialManagerInitializationStruct
 {
     web::json::value initialPeoplehubJson;
@@ -2047,6 +2048,77 @@ public:
 
         VERIFY_IS_TRUE(userBuffer.socialUserEventQueue.size() == 0);
         VERIFY_IS_TRUE(userBuffer.socialUserGraph.size() == userGroupSize);
+
+        for (auto& userPair : userBuffer.socialUserGraph)
+        {
+            auto index = userPair.second.index;
+            auto socialUser = userPair.second.socialUser;
+            VERIFY_IS_TRUE(userBuffer.userColumns.is_valid_index(index));
+            VERIFY_IS_TRUE(reinterpret_cast<byte*>(socialUser) == userBuffer.buffer + index * xboxSocialUserSize);
+            VERIFY_ARE_EQUAL_UINT(userPair.first, userBuffer.userColumns.xbox_user_id(index));
+            VERIFY_ARE_EQUAL(socialUser->is_favorite(), userBuffer.userColumns.has_flag(index, social_user_flags::favorite));
+            VERIFY_ARE_EQUAL(socialUser->is_followed_by_caller(), userBuffer.userColumns.has_flag(index, social_user_flags::followed_by_caller));
+            VERIFY_IS_TRUE(socialUser->presence_record().user_state() == userBuffer.userColumns.presence_state(index));
+        }
+    }
+
+    // Filter groups are updated incrementally; make sure they still match what a full refilter of the active graph would produce
+    void VerifyFilterGroupsMatchGraph(std::shared_ptr<MockSocialManager> socialManagerCppMock)
+    {
+        auto localGraphs = socialManagerCppMock->local_graphs();
+        auto snapshot = localGraphs.at(_T("TestXboxUserId"))->active_buffer_social_graph();
+        for (auto& groupPair : socialManagerCppMock->xbox_social_user_groups())
+        {
+            auto group = groupPair.second;
+            if (group->social_user_group_type() != social_user_group_type::filter_type)
+            {
+                continue;
+            }
+
+            auto& groupUsers = group->users();
+            auto& trackedUsers = group->users_tracked_by_social_user_group();
+            VERIFY_ARE_EQUAL_UINT(groupUsers.size(), trackedUsers.size());
+
+            std::unordered_map<uint64_t, size_t> groupXuids;
+            for (size_t i = 0; i < groupUsers.size(); ++i)
+            {
+                auto xuid = groupUsers[i]->_Xbox_user_id_as_integer();
+                VERIFY_ARE_EQUAL_UINT(xuid, utils::string_t_to_uint64(trackedUsers[i].xbox_user_id()));
+                VERIFY_IS_TRUE(snapshot->at(xuid).socialUser == groupUsers[i]);
+                VERIFY_IS_TRUE(groupXuids.emplace(xuid, i).second);
+            }
+
+            size_t expectedSize = 0;
+            for (auto& userPair : *snapshot)
+            {
+                auto user = userPair.second.socialUser;
+                if (user == nullptr)
+                {
+                    continue;
+                }
+
+                bool relationshipMatch = group->relationship_filter_of_group() == relationship_filter::favorite ? user->is_favorite() : user->is_followed_by_caller();
+                bool presenceMatch = true;
+                switch (group->presence_filter_of_group())
+                {
+                case presence_filter::all_online: presenceMatch = user->presence_record().user_state() == user_presence_state::online; break;
+                case presence_filter::all_offline: presenceMatch = user->presence_record().user_state() == user_presence_state::offline; break;
+                default: continue;
+                }
+
+                if (relationshipMatch && presenceMatch)
+                {
+                    ++expectedSize;
+                    VERIFY_IS_TRUE(groupXuids.find(userPair.first) != groupXuids.end());
+                }
+            }
+
+            auto presenceFilter = group->presence_filter_of_group();
+            if (presenceFilter == presence_filter::all_online || presenceFilter == presence_filter::all_offline)
+            {
+                VERIFY_ARE_EQUAL_UINT(expectedSize, groupUsers.size());
+            }
+        }
     }
 
     // Make sure memory is alloced correctly for the user buffer holder internal structure
@@ -2123,6 +2195,228 @@ public:
         VERIFY_IS_TRUE(userBufferHolder.user_buffer_b().freeData.size() == 0);
     }
 
+    static _Ret_maybenull_ _Post_writable_byte_size_(dwSize) void* __stdcall DiffMemAllocHook(
+        _In_ size_t dwSize
+        )
+    {
+        ++g_DiffAllocCount;
+        return new (std::nothrow) int8_t[dwSize];
+    }
+
+    static void __stdcall DiffMemFreeHook(
+        _In_ void* pAddress
+        )
+    {
+        delete[] pAddress;
+    }
+
+    // Pushes from several producer threads into a small ring so it spills, then drains everything on the consumer side
+    DEFINE_TEST_CASE(TestSocialManagerInternalEventQueue)
+    {
+        DEFINE_TEST_CASE_PROPERTIES_FOCUS(TestSocialManagerInternalEventQueue);
+        const uint32_t numProducers = 4;
+        const uint32_t eventsPerProducer = 100;
+        internal_event_queue eventQueue(16);
+        VERIFY_IS_TRUE(eventQueue.empty());
+
+        std::vector<pplx::task<void>> producers;
+        for (uint32_t producer = 0; producer < numProducers; ++producer)
+        {
+            producers.push_back(pplx::create_task([&eventQueue, producer, eventsPerProducer]()
+            {
+                for (uint32_t i = 0; i < eventsPerProducer; ++i)
+                {
+                    xsapi_internal_vector(uint64_t) userList;
+                    userList.push_back(producer * eventsPerProducer + i + 1);
+                    eventQueue.push(internal_social_event(internal_social_event_type::users_removed, userList));
+                }
+            }));
+        }
+
+        for (auto& producer : producers)
+        {
+            producer.wait();
+        }
+
+        VERIFY_ARE_EQUAL_UINT(numProducers * eventsPerProducer, eventQueue.size());
+
+        xsapi_internal_vector(internal_social_event) batch;
+        VERIFY_ARE_EQUAL_UINT(10, eventQueue.drain(batch, 10));
+        VERIFY_ARE_EQUAL_UINT(numProducers * eventsPerProducer - 10, eventQueue.drain(batch));
+        VERIFY_IS_TRUE(eventQueue.empty());
+
+        // events from a single producer come out in the order they went in
+        std::vector<uint64_t> lastSeen(numProducers, 0);
+        for (auto& evt : batch)
+        {
+            VERIFY_IS_TRUE(evt.event_type() == internal_social_event_type::users_removed);
+            VERIFY_ARE_EQUAL_UINT(1, evt.users_to_remove().size());
+            auto xuid = evt.users_to_remove()[0];
+            auto producer = static_cast<uint32_t>((xuid - 1) / eventsPerProducer);
+            VERIFY_IS_TRUE(xuid > lastSeen[producer]);
+            lastSeen[producer] = xuid;
+        }
+
+        internal_social_event evt;
+        VERIFY_IS_FALSE(eventQueue.try_pop(evt));
+    }
+
+    // Drains while producers are still pushing into a ring small enough to spill, events must never overtake each other
+    DEFINE_TEST_CASE(TestSocialManagerInternalEventQueueConcurrentDrain)
+    {
+        DEFINE_TEST_CASE_PROPERTIES_FOCUS(TestSocialManagerInternalEventQueueConcurrentDrain);
+        const uint32_t numProducers = 4;
+        const uint32_t eventsPerProducer = 2000;
+        internal_event_queue eventQueue(4);
+
+        std::vector<pplx::task<void>> producers;
+        for (uint32_t producer = 0; producer < numProducers; ++producer)
+        {
+            producers.push_back(pplx::create_task([&eventQueue, producer, eventsPerProducer]()
+            {
+                for (uint32_t i = 0; i < eventsPerProducer; ++i)
+                {
+                    xsapi_internal_vector(uint64_t) userList;
+                    userList.push_back(producer * eventsPerProducer + i + 1);
+                    eventQueue.push(internal_social_event(internal_social_event_type::users_removed, userList));
+                }
+            }));
+        }
+
+        std::vector<uint64_t> lastSeen(numProducers, 0);
+        uint32_t numPopped = 0;
+        internal_social_event evt;
+        while (numPopped < numProducers * eventsPerProducer)
+        {
+            VERIFY_IS_TRUE(eventQueue.size() <= numProducers * eventsPerProducer - numPopped);
+            if (!eventQueue.try_pop(evt))
+            {
+                continue;
+            }
+
+            auto xuid = evt.users_to_remove()[0];
+            auto producer = static_cast<uint32_t>((xuid - 1) / eventsPerProducer);
+            VERIFY_IS_TRUE(xuid > lastSeen[producer]);
+            lastSeen[producer] = xuid;
+            ++numPopped;
+        }
+
+        for (auto& producer : producers)
+        {
+            producer.wait();
+        }
+
+        VERIFY_IS_TRUE(eventQueue.empty());
+        VERIFY_IS_FALSE(eventQueue.try_pop(evt));
+    }
+
+    static std::vector<xbox_social_user> GenerateSyntheticSocialGraph(_In_ uint32_t numUsers, _In_ const string_t& gamertag)
+    {
+        std::vector<xbox_social_user> socialUsers;
+        socialUsers.reserve(numUsers);
+        for (uint32_t i = 1; i <= numUsers; ++i)
+        {
+            stringstream_t stream;
+            stream << i;
+            auto jsonBlob = defaultPeoplehubTemplate;
+            jsonBlob[L"xuid"] = web::json::value::string(stream.str());
+            jsonBlob[L"gamertag"] = web::json::value::string(gamertag);
+            socialUsers.push_back(xbox_social_user::_Deserialize(jsonBlob).payload());
+        }
+
+        return socialUsers;
+    }
+
+    // Micro-benchmark for the refresh diff over synthetic 100/1k/5k friend graphs, reports time and allocations
+    DEFINE_TEST_CASE(TestSocialManagerGraphDiffPerf)
+    {
+        DEFINE_TEST_CASE_PROPERTIES_FOCUS(TestSocialManagerGraphDiffPerf);
+        const uint32_t graphSizes[] = { 100, 1000, 5000 };
+        for (auto graphSize : graphSizes)
+        {
+            user_buffers_holder userBufferHolder;
+            userBufferHolder.initialize(GenerateSyntheticSocialGraph(graphSize, _T("TestGamerTag")));
+
+            // every tenth user gets a new gamertag, the last user drops out and a new user is added
+            auto fetchedUsers = GenerateSyntheticSocialGraph(graphSize + 1, _T("TestGamerTag"));
+            auto changedUsers = GenerateSyntheticSocialGraph(graphSize, _T("ChangedGamerTag"));
+            xsapi_internal_unordered_map(uint64_t, xbox_social_user) fetchedGraph;
+            fetchedGraph.reserve(fetchedUsers.size());
+            for (uint32_t i = 0; i < fetchedUsers.size(); ++i)
+            {
+                if (i == graphSize - 1)
+                {
+                    continue;
+                }
+                const auto& user = (i < graphSize && i % 10 == 0) ? changedUsers[i] : fetchedUsers[i];
+                fetchedGraph.emplace(user._Xbox_user_id_as_integer(), user);
+            }
+
+            social_graph_diff socialGraphDiff;
+            g_DiffAllocCount = 0;
+            xbox_live_services_settings::get_singleton_instance()->set_memory_allocation_hooks(DiffMemAllocHook, DiffMemFreeHook);
+            auto startTime = std::chrono::high_resolution_clock::now();
+            social_graph::compute_diff(fetchedGraph, userBufferHolder.inactive_buffer()->socialUserGraph, socialGraphDiff);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+            uint32_t allocCount = g_DiffAllocCount;
+            xbox_live_services_settings::get_singleton_instance()->set_memory_allocation_hooks(nullptr, nullptr);
+
+            stringstream_t log;
+            log << L"compute_diff users: " << graphSize << L" time: " << elapsed.count() << L"ms allocations: " << allocCount;
+            TEST_LOG(log.str().c_str());
+
+            VERIFY_ARE_EQUAL_UINT(1, socialGraphDiff.usersAddedList.size());
+            VERIFY_ARE_EQUAL_UINT(1, socialGraphDiff.usersRemovedList.size());
+            VERIFY_ARE_EQUAL_UINT((graphSize + 9) / 10, socialGraphDiff.profileChangeList.size());
+            VERIFY_ARE_EQUAL_UINT(0, socialGraphDiff.presenceChangeList.size());
+            VERIFY_ARE_EQUAL_UINT(0, socialGraphDiff.socialRelationshipChangeList.size());
+        }
+    }
+
+    DEFINE_TEST_CASE(TestSocialManagerPresencePollScheduler)
+    {
+        DEFINE_TEST_CASE_PROPERTIES_FOCUS(TestSocialManagerPresencePollScheduler);
+        user_buffers_holder userBufferHolder;
+        userBufferHolder.initialize(GenerateSyntheticSocialGraph(3, _T("TestGamerTag")));
+        auto socialUserGraph = userBufferHolder.inactive_buffer()->socialUserGraph;
+
+        // user 1 stays online, users 2 and 3 are offline and never change
+        presence_poll_scheduler scheduler;
+        uint32_t pollCounts[4] = { 0 };
+        const uint32_t numRounds = 20;
+        for (uint32_t round = 0; round < numRounds; ++round)
+        {
+            for (auto& xuid : scheduler.next_round(socialUserGraph))
+            {
+                uint64_t id = utils::string_t_to_uint64(xuid);
+                ++pollCounts[id];
+                scheduler.on_presence_polled(id, false, id == 1);
+            }
+        }
+
+        stringstream_t log;
+        log << L"presence polls over " << numRounds << L" rounds online: " << pollCounts[1] << L" idle: " << pollCounts[2];
+        TEST_LOG(log.str().c_str());
+
+        VERIFY_ARE_EQUAL_UINT(numRounds, pollCounts[1]);
+        VERIFY_ARE_EQUAL_UINT(5, pollCounts[2]);   // rounds 0, 1, 3, 7 and 15
+        VERIFY_ARE_EQUAL_UINT(pollCounts[2], pollCounts[3]);
+        VERIFY_ARE_EQUAL_UINT(1, scheduler.poll_interval(1));
+        VERIFY_IS_TRUE(scheduler.poll_interval(2) == presence_poll_scheduler::MAX_IDLE_POLL_INTERVAL);
+
+        // a change seen outside the schedule brings the user back into the very next round
+        scheduler.on_presence_polled(2, true, false);
+        VERIFY_ARE_EQUAL_UINT(1, scheduler.poll_interval(2));
+        auto userList = scheduler.next_round(socialUserGraph);
+        VERIFY_IS_TRUE(std::find(userList.begin(), userList.end(), _T("2")) != userList.end());
+        VERIFY_IS_TRUE(std::find(userList.begin(), userList.end(), _T("3")) == userList.end());
+
+        // users that left the graph are dropped from the schedule
+        socialUserGraph.erase(3);
+        scheduler.next_round(socialUserGraph);
+        VERIFY_ARE_EQUAL_UINT(0, scheduler.poll_interval(3));
+    }
+
     // Verifies that get_user_copy API (C++ only) works properly in copying the data
     DEFINE_TEST_CASE(TestSocialManagerUserGroupCopy)
     {
@@ -2470,6 +2764,7 @@ public:
 
         VERIFY_IS_TRUE(offlineSocialUserGroup->Users->Size == USER_LIST.size());
         VERIFY_IS_TRUE(favoriteTitleOnlineSocialUserGroup->Users->Size == 0 && titleOnlineSocialUserGroup->Users->Size == 0);
+        VerifyFilterGroupsMatchGraph(std::dynamic_pointer_cast<MockSocialManager>(socialManagerInitializationStruct.socialManager->GetCppObj()));
 
         // title offline social user group
         auto titleOfflineSocialUserGroup = socialManagerInitializationStruct.socialManager->CreateSocialUserGroupFromFilters(
@@ -2524,6 +2819,7 @@ public:
         VERIFY_IS_TRUE(titleOfflineSocialUserGroup->Users->Size == 0);
         VERIFY_IS_TRUE(favoriteTitleOnlineSocialUserGroup->Users->Size == 1);
         VERIFY_IS_TRUE(offlineSocialUserGroup->Users->Size == 0);
+        VerifyFilterGroupsMatchGraph(std::dynamic_pointer_cast<MockSocialManager>(socialManagerInitializationStruct.socialManager->GetCppObj()));
 
         auto allTitleSocialUserGroup = socialManagerInitializationStruct.socialManager->CreateSocialUserGroupFromFilters(
             xboxLiveContext->user(),
@@ -593,6 +593,257 @@ public:
             );
     }
 
+    DEFINE_TEST_CASE(DownloadBlobConcurrentBlocksTest)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(DownloadBlobConcurrentBlocksTest);
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+
+        const uint32_t blockSize = title_storage::title_storage_service::MIN_DOWNLOAD_BLOCK_SIZE;
+        const uint32_t numBlocks = 6;
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(std::vector<unsigned char>(blockSize, 0x5A));
+
+        // Mock responses carry "MockETag", so metadata with that ETag and a length lets the remaining blocks go out concurrently
+        title_storage::title_storage_blob_metadata blobMetadata(
+            _T("123456789"),
+            title_storage::title_storage_type::global_storage,
+            _T("blobPath"),
+            title_storage::title_storage_blob_type::binary,
+            string_t(),
+            _T("Name"),
+            _T("MockETag")
+            );
+        blobMetadata._Set_e_tag_and_length(_T("MockETag"), blockSize * numBlocks);
+
+        auto blobBuffer = std::make_shared<std::vector<unsigned char>>();
+        auto result = xboxLiveContext->title_storage_service().download_blob(
+            blobMetadata,
+            blobBuffer,
+            title_storage::title_storage_e_tag_match_condition::not_used,
+            string_t(),
+            blockSize,
+            4
+            ).get();
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(numBlocks, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_UINT(blockSize * numBlocks, blobBuffer->size());
+        VERIFY_ARE_EQUAL_UINT(blockSize * numBlocks, result.payload().blob_metadata().length());
+        VERIFY_IS_TRUE(std::count(blobBuffer->begin(), blobBuffer->end(), 0x5A) == blockSize * numBlocks);
+
+        // Without a length in the metadata the blob is read block by block until a short block arrives
+        httpCall->CallCounter = 0;
+        blobMetadata._Set_e_tag_and_length(_T("MockETag"), 0);
+        result = xboxLiveContext->title_storage_service().download_blob(
+            blobMetadata,
+            blobBuffer,
+            title_storage::title_storage_e_tag_match_condition::not_used,
+            string_t(),
+            blockSize * 2,
+            4
+            ).get();
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(1, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_UINT(blockSize, blobBuffer->size());
+    }
+
+    DEFINE_TEST_CASE(DownloadBlobToSinkTest)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(DownloadBlobToSinkTest);
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+
+        const uint32_t blockSize = title_storage::title_storage_service::MIN_DOWNLOAD_BLOCK_SIZE;
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(std::vector<unsigned char>(blockSize, 0x5A));
+
+        // Two full blocks and then a short one ends the blob
+        auto mockHttpCall = httpCall.get();
+        httpCall->fRequestPostFunc = [mockHttpCall, blockSize](std::shared_ptr<http_call_response>& mockResponse, const string_t&)
+        {
+            if (mockHttpCall->CallCounter == 3)
+            {
+                mockResponse = StockMocks::CreateMockHttpCallResponse(std::vector<unsigned char>(blockSize / 2, 0x5A));
+            }
+        };
+
+        title_storage::title_storage_blob_metadata blobMetadata(
+            _T("123456789"),
+            title_storage::title_storage_type::global_storage,
+            _T("blobPath"),
+            title_storage::title_storage_blob_type::binary,
+            string_t()
+            );
+
+        size_t largestPiece = 0;
+        std::vector<unsigned char> sinkData;
+        auto result = xboxLiveContext->title_storage_service().download_blob_to_sink(
+            blobMetadata,
+            [&largestPiece, &sinkData](const unsigned char* data, size_t length)
+            {
+                largestPiece = __max(largestPiece, length);
+                sinkData.insert(sinkData.end(), data, data + length);
+                return true;
+            },
+            title_storage::title_storage_e_tag_match_condition::not_used,
+            string_t(),
+            blockSize
+            ).get();
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(3, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_UINT(blockSize, largestPiece);
+        VERIFY_ARE_EQUAL_UINT(blockSize * 2 + blockSize / 2, sinkData.size());
+        VERIFY_ARE_EQUAL_UINT(sinkData.size(), result.payload().length());
+        VERIFY_ARE_EQUAL_STR(L"MockETag", result.payload().e_tag());
+
+        // A sink returning false stops the download
+        httpCall->CallCounter = 0;
+        httpCall->fRequestPostFunc = nullptr;
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(std::vector<unsigned char>(blockSize, 0x5A));
+        result = xboxLiveContext->title_storage_service().download_blob_to_sink(
+            blobMetadata,
+            [](const unsigned char*, size_t) { return false; },
+            title_storage::title_storage_e_tag_match_condition::not_used,
+            string_t(),
+            blockSize
+            ).get();
+
+        VERIFY_IS_TRUE(result.err() == xbox_live_error_code::runtime_error);
+        VERIFY_ARE_EQUAL_INT(1, httpCall->CallCounter);
+    }
+
+    DEFINE_TEST_CASE(UploadBlobFromSourceTest)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(UploadBlobFromSourceTest);
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(largeUploadJson);
+
+        title_storage::title_storage_blob_metadata blobMetadata(
+            _T("123456789"),
+            title_storage::title_storage_type::global_storage,
+            _T("blobPath"),
+            title_storage::title_storage_blob_type::binary,
+            string_t()
+            );
+
+        // Hand out the blob in short reads to check that blocks are still filled before they are sent
+        const uint32_t blockSize = title_storage::title_storage_service::MIN_UPLOAD_BLOCK_SIZE;
+        const size_t blobLength = blockSize * 3;
+        size_t bytesRemaining = blobLength;
+        auto result = xboxLiveContext->title_storage_service().upload_blob_from_source(
+            blobMetadata,
+            [&bytesRemaining](unsigned char* buffer, size_t bufferLength)
+            {
+                size_t count = __min(__min(bufferLength, bytesRemaining), static_cast<size_t>(100));
+                memset(buffer, 0x5A, count);
+                bytesRemaining -= count;
+                return count;
+            },
+            title_storage::title_storage_e_tag_match_condition::not_used,
+            blockSize
+            ).get();
+
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_INT(3, httpCall->CallCounter);
+        VERIFY_ARE_EQUAL_UINT(blobLength, result.payload().length());
+        VERIFY_IS_TRUE(httpCall->PathQueryFragment.to_string().find(L"finalBlock=true") != string_t::npos);
+
+        // A source with nothing to give is rejected
+        httpCall->CallCounter = 0;
+        result = xboxLiveContext->title_storage_service().upload_blob_from_source(
+            blobMetadata,
+            [](unsigned char*, size_t) { return static_cast<size_t>(0); },
+            title_storage::title_storage_e_tag_match_condition::not_used,
+            blockSize
+            ).get();
+
+        VERIFY_IS_TRUE(result.err() == xbox_live_error_code::invalid_argument);
+        VERIFY_ARE_EQUAL_INT(0, httpCall->CallCounter);
+    }
+
+    DEFINE_TEST_CASE(BlobCacheTest)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(BlobCacheTest);
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        auto& titleStorageService = xboxLiveContext->title_storage_service();
+
+        wchar_t tempPath[MAX_PATH];
+        GetTempPath(MAX_PATH, tempPath);
+        string_t cacheDirectory = string_t(tempPath) + _T("TitleStorageBlobCacheTest");
+
+        std::string blobUtf8 = utility::conversions::to_utf8string(downloadJson);
+        std::vector<unsigned char> blob(blobUtf8.begin(), blobUtf8.end());
+
+        // Room for two blobs
+        VERIFY_IS_TRUE(!titleStorageService.enable_blob_cache(cacheDirectory, blob.size() * 2).err());
+        titleStorageService.clear_blob_cache();
+
+        auto downloadJsonBlob = [&](const string_t& blobPath)
+        {
+            title_storage::title_storage_blob_metadata blobMetadata(
+                _T("123456789"),
+                title_storage::title_storage_type::global_storage,
+                blobPath,
+                title_storage::title_storage_blob_type::json,
+                string_t()
+                );
+
+            return titleStorageService.download_blob(
+                blobMetadata,
+                std::make_shared<std::vector<unsigned char>>(),
+                title_storage::title_storage_e_tag_match_condition::not_used
+                ).get();
+        };
+
+        // The first download has nothing to revalidate and fills the cache
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(blob);
+        auto result = downloadJsonBlob(_T("a.json"));
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_ARE_EQUAL_UINT(0, titleStorageService.blob_cache_stats().hit_count());
+        VERIFY_ARE_EQUAL_UINT(1, titleStorageService.blob_cache_stats().miss_count());
+        VERIFY_ARE_EQUAL_UINT(1, titleStorageService.blob_cache_stats().blob_count());
+
+        // The next one sends the cached ETag and a 304 is answered from disk
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(std::vector<unsigned char>(), 304);
+        result = downloadJsonBlob(_T("a.json"));
+        VERIFY_IS_TRUE(!result.err());
+        VERIFY_IS_TRUE(*result.payload().blob_buffer() == blob);
+        VERIFY_ARE_EQUAL_STR(L"MockETag", result.payload().blob_metadata().e_tag());
+        VERIFY_ARE_EQUAL_STR(L"MockETag", utils::extract_header_value(httpCall->ResultValue->response_headers(), L"If-None-Match"));
+        VERIFY_ARE_EQUAL_UINT(1, titleStorageService.blob_cache_stats().hit_count());
+
+        // b.json and then c.json fill the cache; a.json was used more recently than b.json, so b.json is evicted
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(blob);
+        downloadJsonBlob(_T("b.json"));
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(std::vector<unsigned char>(), 304);
+        VERIFY_IS_TRUE(!downloadJsonBlob(_T("a.json")).err());
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(blob);
+        downloadJsonBlob(_T("c.json"));
+
+        auto stats = titleStorageService.blob_cache_stats();
+        VERIFY_ARE_EQUAL_UINT(2, stats.blob_count());
+        VERIFY_ARE_EQUAL_UINT(blob.size() * 2, stats.size_in_bytes());
+        VERIFY_ARE_EQUAL_UINT(2, stats.hit_count());
+        VERIFY_ARE_EQUAL_UINT(3, stats.miss_count());
+
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(std::vector<unsigned char>(), 304);
+        VERIFY_IS_TRUE(!downloadJsonBlob(_T("a.json")).err());
+        VERIFY_IS_TRUE(downloadJsonBlob(_T("b.json")).err() == xbox_live_error_code::http_status_304_not_modified);
+
+        // A new cache over the same directory picks up what is already there
+        VERIFY_IS_TRUE(!titleStorageService.enable_blob_cache(cacheDirectory, blob.size() * 2).err());
+        VERIFY_ARE_EQUAL_UINT(2, titleStorageService.blob_cache_stats().blob_count());
+        VERIFY_IS_TRUE(!downloadJsonBlob(_T("c.json")).err());
+        VERIFY_ARE_EQUAL_UINT(1, titleStorageService.blob_cache_stats().hit_count());
+
+        titleStorageService.clear_blob_cache();
+        VERIFY_ARE_EQUAL_UINT(0, titleStorageService.blob_cache_stats().blob_count());
+        titleStorageService.disable_blob_cache();
+    }
+
     DEFINE_TEST_CASE(TitleStorageInvalidArgsTest)
     {
         DEFINE_TEST_CASE_PROPERTIES(TitleStorageInvalidArgsTest);
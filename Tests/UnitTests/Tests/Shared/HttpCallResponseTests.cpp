@@ -92,6 +92,27 @@ public:
         VERIFY_ARE_EQUAL_STR(L"MockETag", httpCallResponse->e_tag());
         VERIFY_ARE_EQUAL_INT(1, httpCallResponse->retry_after().count());
     }
+
+    DEFINE_TEST_CASE(TestHttpCallResponseBodyMove)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHttpCallResponseBodyMove);
+
+        std::shared_ptr<http_call_response> httpCallResponse = StockMocks::CreateMockHttpCallResponse(web::json::value::parse(L"{}"));
+        VERIFY_ARE_EQUAL_INT(0, httpCallResponse->response_body_vector().size());
+
+        // The body is moved in rather than copied
+        std::vector<unsigned char> body(1024, 7);
+        const unsigned char* bodyData = body.data();
+        httpCallResponse->_Set_response_body(std::move(body));
+        VERIFY_ARE_EQUAL_INT(http_call_response_body_type::vector_body, httpCallResponse->body_type());
+        VERIFY_IS_TRUE(httpCallResponse->response_body_vector().data() == bodyData);
+
+        // A moved-from response is left with an empty body rather than an unusable one
+        http_call_response movedResponse(std::move(*httpCallResponse));
+        VERIFY_ARE_EQUAL_INT(1024, movedResponse.response_body_vector().size());
+        VERIFY_ARE_EQUAL_INT(7, movedResponse.response_body_vector()[1023]);
+        VERIFY_IS_TRUE(httpCallResponse->response_body_vector().empty());
+    }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
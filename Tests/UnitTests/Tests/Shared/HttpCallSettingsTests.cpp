@@ -118,6 +118,208 @@ public:
         VerifyDelay(g_callLog[1].m_time, g_callLog[0].m_time, 2000);
     }
 
+    DEFINE_TEST_CASE(TestHttpRetryIsParked)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHttpRetryIsParked);
+        auto responseJson = web::json::value::parse(defaultStringVerifyResult);
+        auto httpClient = m_mockXboxSystemFactory->GetMockHttpClient();
+        auto requestString = std::wstring(L"xboxUserId");
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        m_mockXboxSystemFactory->setup_mock_for_http_client();
+
+        httpClient->ResultValue.set_body(responseJson);
+        httpClient->ResultValue.set_status_code(503);
+        xboxLiveContext->settings()->set_http_timeout_window(std::chrono::seconds(3));
+
+        VERIFY_ARE_EQUAL_INT(0, http_call_impl::parked_call_count());
+        auto task = xboxLiveContext->string_service().verify_string(requestString);
+
+        // The first attempt fails right away and the retry waits out its 2 second delay on a timer
+        Sleep(1000);
+        VERIFY_ARE_EQUAL_INT(1, http_call_impl::parked_call_count());
+
+        auto result = task.get();
+        VERIFY_IS_TRUE(result.err() == xbox_live_error_code::http_status_503_service_unavailable);
+        VERIFY_ARE_EQUAL_INT(0, http_call_impl::parked_call_count());
+    }
+
+    DEFINE_TEST_CASE(TestHttpThrottleQueuesBurst)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHttpThrottleQueuesBurst);
+        auto responseJson = web::json::value::parse(defaultStringVerifyResult);
+        auto httpClient = m_mockXboxSystemFactory->GetMockHttpClient();
+        auto requestString = std::wstring(L"xboxUserId");
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        m_mockXboxSystemFactory->setup_mock_for_http_client();
+        httpClient->ResultValue.set_body(responseJson);
+
+        auto retryAfterManager = http_retry_after_manager::get_http_retry_after_manager_singleton();
+        retryAfterManager->set_api_throttle(xbox_live_api::verify_strings, http_throttle_settings(2, 1));
+
+        auto timeStart = std::chrono::high_resolution_clock::now();
+        std::vector<pplx::task<xbox_live_result<verify_string_result>>> tasks;
+        for (int i = 0; i < 3; ++i)
+        {
+            tasks.push_back(xboxLiveContext->string_service().verify_string(requestString));
+        }
+
+        // One token is on hand and the other two calls wait half a second each for theirs
+        for (auto& task : tasks)
+        {
+            VERIFY_IS_TRUE(!task.get().err());
+        }
+
+        auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - timeStart);
+        VERIFY_IS_TRUE(delay.count() >= 900);
+
+        // Calls let out of the queue count as admitted too
+        auto stats = retryAfterManager->get_api_throttle_stats(xbox_live_api::verify_strings);
+        VERIFY_ARE_EQUAL_INT(3, stats.admittedCount);
+        VERIFY_ARE_EQUAL_INT(2, stats.queuedCount);
+        VERIFY_ARE_EQUAL_INT(0, stats.queueLength);
+
+        retryAfterManager->set_api_throttle(xbox_live_api::verify_strings, http_throttle_settings());
+        stats = retryAfterManager->get_api_throttle_stats(xbox_live_api::verify_strings);
+        VERIFY_ARE_EQUAL_INT(0, stats.admittedCount);
+    }
+
+    DEFINE_TEST_CASE(TestHttpThrottleSettings)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHttpThrottleSettings);
+        auto responseJson = web::json::value::parse(defaultStringVerifyResult);
+        auto httpClient = m_mockXboxSystemFactory->GetMockHttpClient();
+        auto requestString = std::wstring(L"xboxUserId");
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        m_mockXboxSystemFactory->setup_mock_for_http_client();
+        httpClient->ResultValue.set_body(responseJson);
+
+        auto settings = xboxLiveContext->settings();
+        VERIFY_ARE_EQUAL_INT(0, static_cast<int>(settings->http_api_throttle_rate()));
+        settings->set_http_api_throttle(4, 0);
+        VERIFY_ARE_EQUAL_INT(4, static_cast<int>(settings->http_api_throttle_rate()));
+        VERIFY_ARE_EQUAL_INT(1, settings->http_api_throttle_capacity());
+
+        settings->set_http_host_throttle(L"client-strings.xboxlive.com", 10, 5);
+        VERIFY_ARE_EQUAL_INT(10, static_cast<int>(settings->http_host_throttle_rate(L"client-strings.xboxlive.com")));
+        VERIFY_ARE_EQUAL_INT(5, settings->http_host_throttle_capacity(L"client-strings.xboxlive.com"));
+
+        // Each API gets its own bucket from the settings on its first call
+        VERIFY_IS_TRUE(!xboxLiveContext->string_service().verify_string(requestString).get().err());
+        VERIFY_IS_TRUE(!xboxLiveContext->string_service().verify_string(requestString).get().err());
+        auto retryAfterManager = http_retry_after_manager::get_http_retry_after_manager_singleton();
+        auto stats = retryAfterManager->get_api_throttle_stats(xbox_live_api::verify_strings);
+        VERIFY_ARE_EQUAL_INT(2, stats.admittedCount);
+        VERIFY_ARE_EQUAL_INT(1, stats.queuedCount);
+
+        settings->set_http_api_throttle(0, 0);
+        settings->set_http_host_throttle(L"client-strings.xboxlive.com", 0, 0);
+        VERIFY_ARE_EQUAL_INT(0, static_cast<int>(settings->http_api_throttle_rate()));
+        VERIFY_ARE_EQUAL_INT(0, static_cast<int>(settings->http_host_throttle_rate(L"client-strings.xboxlive.com")));
+        VERIFY_ARE_EQUAL_INT(0, retryAfterManager->get_api_throttle_stats(xbox_live_api::verify_strings).admittedCount);
+    }
+
+    DEFINE_TEST_CASE(TestHttpRequestCoalescing)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHttpRequestCoalescing);
+        auto coalescer = std::make_shared<http_request_coalescer>();
+        VERIFY_IS_TRUE(!coalescer->is_api_coalescing_enabled(xbox_live_api::get_presence));
+        coalescer->set_api_coalescing_enabled(xbox_live_api::get_presence, true);
+        VERIFY_IS_TRUE(coalescer->is_api_coalescing_enabled(xbox_live_api::get_presence));
+        VERIFY_IS_TRUE(!coalescer->is_api_coalescing_enabled(xbox_live_api::get_user_profiles));
+
+        auto singleton = http_request_coalescer::get_http_request_coalescer_singleton();
+        VERIFY_IS_TRUE(singleton->is_api_coalescing_enabled(xbox_live_api::get_social_relationships));
+        VERIFY_IS_TRUE(!singleton->is_api_coalescing_enabled(xbox_live_api::get_achievements));
+
+        int sendCount = 0;
+        pplx::task_completion_event<std::shared_ptr<http_call_response>> tce;
+        auto sendRequest = [&sendCount, tce]()
+        {
+            ++sendCount;
+            return pplx::create_task(tce);
+        };
+
+        auto task1 = coalescer->get_response(L"a", sendRequest);
+        auto task2 = coalescer->get_response(L"a", sendRequest);
+        auto task3 = coalescer->get_response(L"b", sendRequest);
+        VERIFY_ARE_EQUAL_INT(2, sendCount);
+        VERIFY_ARE_EQUAL_INT(2, coalescer->stats().inFlightCount);
+
+        auto response = StockMocks::CreateMockHttpCallResponse(web::json::value::parse(L"{\"a\":1}"));
+        tce.set(response);
+
+        // Every caller shares the one response, body included
+        auto response1 = task1.get();
+        auto response2 = task2.get();
+        VERIFY_IS_TRUE(response1 == response && response2 == response);
+        VERIFY_ARE_EQUAL_INT(1, response2->response_body_json()[L"a"].as_integer());
+        VERIFY_IS_TRUE(task3.get() != nullptr);
+
+        // Once the shared call has completed the next one goes out again
+        auto stats = coalescer->stats();
+        VERIFY_ARE_EQUAL_INT(1, stats.coalescedCount);
+        VERIFY_ARE_EQUAL_INT(2, stats.sentCount);
+        VERIFY_ARE_EQUAL_INT(0, stats.inFlightCount);
+        coalescer->get_response(L"a", sendRequest).get();
+        VERIFY_ARE_EQUAL_INT(3, sendCount);
+    }
+
+    DEFINE_TEST_CASE(TestHttpClientPool)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHttpClientPool);
+        auto pool = std::make_shared<http_client_pool>();
+        web::http::client::http_client_config config;
+        config.set_timeout(std::chrono::seconds(30));
+
+        // Calls to the same host share a client
+        auto client1 = pool->get_client(web::http::uri(L"https://presence.xboxlive.com"), config);
+        auto client2 = pool->get_client(web::http::uri(L"https://presence.xboxlive.com"), config);
+        auto client3 = pool->get_client(web::http::uri(L"https://profile.xboxlive.com"), config);
+        VERIFY_IS_TRUE(client1 == client2);
+        VERIFY_IS_TRUE(client1 != client3);
+
+        // Each request enforces its own timeout, so it doesn't split the pool
+        config.set_timeout(std::chrono::seconds(10));
+        auto client4 = pool->get_client(web::http::uri(L"https://presence.xboxlive.com"), config);
+        VERIFY_IS_TRUE(client1 == client4);
+
+        auto stats = pool->stats();
+        VERIFY_ARE_EQUAL_INT(2, stats.poolHitCount);
+        VERIFY_ARE_EQUAL_INT(2, stats.newConnectionCount);
+        VERIFY_ARE_EQUAL_INT(2, stats.pooledClientCount);
+
+        // Idle clients are dropped the next time the pool is used
+        http_client_pool_settings settings;
+        settings.idleTimeout = std::chrono::seconds(0);
+        pool->set_settings(settings);
+        auto client5 = pool->get_client(web::http::uri(L"https://presence.xboxlive.com"), config);
+        VERIFY_IS_TRUE(client4 != client5);
+
+        stats = pool->stats();
+        VERIFY_ARE_EQUAL_INT(2, stats.evictedCount);
+        VERIFY_ARE_EQUAL_INT(1, stats.pooledClientCount);
+    }
+
+    DEFINE_TEST_CASE(TestHttpClientPoolIdleEviction)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHttpClientPoolIdleEviction);
+        auto pool = std::make_shared<http_client_pool>();
+        http_client_pool_settings settings;
+        settings.idleTimeout = std::chrono::seconds(0);
+        pool->set_settings(settings);
+
+        // Idle clients go on a timer even when the pool isn't used again
+        pool->get_client(web::http::uri(L"https://presence.xboxlive.com"), web::http::client::http_client_config());
+        for (int i = 0; i < 100 && pool->stats().pooledClientCount > 0; ++i)
+        {
+            Sleep(10);
+        }
+
+        auto stats = pool->stats();
+        VERIFY_ARE_EQUAL_INT(0, stats.pooledClientCount);
+        VERIFY_ARE_EQUAL_INT(1, stats.evictedCount);
+    }
+
     DEFINE_TEST_CASE(TestHttpTimeoutWithNoRetry)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestHttpTimeoutWithNoRetry);
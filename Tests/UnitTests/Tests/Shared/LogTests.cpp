@@ -32,6 +32,15 @@ public:
     std::vector<std::string> m_logOutput;
 };
 
+class test_calling_thread_output : public test_log_output
+{
+public:
+    test_calling_thread_output() : test_log_output(log_output_level_setting::use_logger_setting, log_level::off)
+    {}
+
+    bool writes_on_calling_thread() const override { return true; }
+};
+
 static bool g_haslogged = false;
 static bool g_hasloggedWinRT = false;
 
@@ -246,6 +255,99 @@ public:
         VERIFY_IS_TRUE(StringCompareLastCharactors(test_output->m_logOutput[4], "errorerror0xf0"));
     }
 
+    DEFINE_TEST_CASE(LogLevelGate)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(LogLevelGate);
+        auto testLogger = std::make_shared<logger>();
+
+        // No outputs, nothing is enabled
+        VERIFY_IS_FALSE(testLogger->is_log_level_enabled(log_level::error));
+
+        auto test_output1 = std::make_shared<test_log_output>(log_output_level_setting::use_logger_setting, log_level::off);
+        testLogger->add_log_output(test_output1);
+        VERIFY_IS_TRUE(testLogger->is_log_level_enabled(log_level::warn));
+        VERIFY_IS_FALSE(testLogger->is_log_level_enabled(log_level::info));
+
+        // An output on its own setting opens the gate for its level
+        auto test_output2 = std::make_shared<test_log_output>(log_output_level_setting::use_own_setting, log_level::info);
+        testLogger->add_log_output(test_output2);
+        VERIFY_IS_TRUE(testLogger->is_log_level_enabled(log_level::info));
+        VERIFY_IS_FALSE(testLogger->is_log_level_enabled(log_level::debug));
+
+        testLogger->set_log_level(log_level::debug);
+        VERIFY_IS_TRUE(testLogger->is_log_level_enabled(log_level::debug));
+
+        // The message is never built for a level that is gated off
+        testLogger->set_log_level(log_level::off);
+        bool isMessageBuilt = false;
+        auto buildMessage = [&isMessageBuilt]() { isMessageBuilt = true; return std::string("debug"); };
+        LOGS(testLogger, log_level::debug, "") << buildMessage();
+        VERIFY_IS_FALSE(isMessageBuilt);
+    }
+
+    DEFINE_TEST_CASE(WriteLogAsync)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(WriteLogAsync);
+        auto testLogger = std::make_shared<logger>();
+        testLogger->enable_async_logging();
+
+        auto test_output = std::make_shared<test_log_output>(log_output_level_setting::use_logger_setting, log_level::off);
+        testLogger->add_log_output(test_output);
+
+        int loopCount = 20;
+        std::vector<task<void>> tasks;
+        for (int i = 0; i < loopCount; i++)
+        {
+            auto task = create_task([loopCount, testLogger]()
+            {
+                for (int j = 0; j < loopCount; j++)
+                {
+                    LOGS(testLogger, log_level::error, "test") << "a" << j;
+                }
+            });
+            tasks.push_back(task);
+        }
+
+        concurrency::when_all(tasks.begin(), tasks.end()).wait();
+        testLogger->flush();
+
+        VERIFY_ARE_EQUAL_INT(0, testLogger->dropped_count());
+        VERIFY_ARE_EQUAL_INT(loopCount*loopCount, test_output->m_logOutput.size());
+        VERIFY_IS_TRUE(StringCompareLastCharactors(test_output->m_logOutput[0], "a0"));
+    }
+
+    DEFINE_TEST_CASE(WriteLogAsyncCallingThreadOutput)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(WriteLogAsyncCallingThreadOutput);
+        auto testLogger = std::make_shared<logger>();
+        testLogger->enable_async_logging();
+        testLogger->set_log_level(log_level::error);
+
+        auto callingThreadOutput = std::make_shared<test_calling_thread_output>();
+        testLogger->add_log_output(callingThreadOutput);
+
+        // Written before LOGS returns, with no drain involved
+        LOGS(testLogger, log_level::error, "test") << "a0";
+        VERIFY_ARE_EQUAL_INT(1, callingThreadOutput->m_logOutput.size());
+
+        // Outputs added while other threads log are picked up without disturbing the drain
+        auto queuedOutput = std::make_shared<test_log_output>(log_output_level_setting::use_logger_setting, log_level::off);
+        auto task = create_task([testLogger]()
+        {
+            for (int i = 0; i < 100; i++)
+            {
+                LOGS(testLogger, log_level::error, "test") << "b" << i;
+            }
+        });
+        testLogger->add_log_output(queuedOutput);
+        task.wait();
+        testLogger->flush();
+
+        VERIFY_ARE_EQUAL_INT(101, callingThreadOutput->m_logOutput.size());
+        VERIFY_IS_TRUE(queuedOutput->m_logOutput.size() <= 100);
+        VERIFY_ARE_EQUAL_INT(0, testLogger->dropped_count());
+    }
+
     static void TraceFunction(_In_ xbox_services_diagnostics_trace_level level, _In_ const std::string& category, _In_ const std::string& message)
     {
         xbox_services_diagnostics_trace_level currentLevel = xbox_live_services_settings::get_singleton_instance()->diagnostics_trace_level();
@@ -395,6 +395,58 @@ public:
         // make sure the connection task will quit, and we cleanup in the end.
         connection->connection_task().wait();
     }
+    DEFINE_TEST_CASE(ConnectRetryStats)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(ConnectRetryStats);
+
+        auto user = SignInUserWithMocks_WinRT();
+        auto userContext = std::make_shared<user_context>(user);
+
+        std::shared_ptr<web_socket_connection> connection = std::make_shared<web_socket_connection>(
+            userContext,
+            web::uri(L"wss://rta.xboxlive.com/connect"),
+            L"rta.xboxlive.com",
+            GetDefaultHttpSetting()
+            );
+        auto stateChangeHelper = SetupStateChangeHelper(connection);
+
+        std::shared_ptr<MockWebSocketClient> mockSocket = m_mockXboxSystemFactory->GetMockWebSocketClient();
+        mockSocket->m_connectToFail = true;
+
+        connection->ensure_connected();
+        stateChangeHelper->disconnectedEvent.wait();
+
+        // Retries keep going on a timer in the background
+        mockSocket->m_connectToFail = false;
+        stateChangeHelper->connectedEvent.wait();
+        VERIFY_ARE_EQUAL_INT(connection->state(), web_socket_connection_state::connected);
+
+        auto stats = connection->stats();
+        VERIFY_ARE_EQUAL_INT(1, stats.connectCount);
+        VERIFY_IS_TRUE(stats.attemptCount >= 2);
+        VERIFY_ARE_EQUAL_INT(0, stats.attemptHistogram[0]);
+
+        uint32_t attemptTotal = 0;
+        for (auto count : stats.attemptHistogram)
+        {
+            attemptTotal += count;
+        }
+        uint32_t latencyTotal = 0;
+        for (auto count : stats.latencyHistogram)
+        {
+            latencyTotal += count;
+        }
+        VERIFY_ARE_EQUAL_INT(1, attemptTotal);
+        VERIFY_ARE_EQUAL_INT(1, latencyTotal);
+
+        // A close while a retry waits on its timer completes the connection task right away
+        stateChangeHelper->reset_events();
+        mockSocket->m_connectToFail = true;
+        mockSocket->m_closeHandler(1001, L"");
+        stateChangeHelper->disconnectedEvent.wait();
+        connection->close();
+        VERIFY_IS_TRUE(connection->connection_task().is_done());
+    }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END